@@ -12,7 +12,7 @@ import matplotlib.pyplot as plt
 
 # --- PYNQ Imports ---
 try:
-    from pynq import Overlay
+    from pynq import Overlay, allocate
     from pynq.lib.video import VideoMode
     PYNQ_AVAILABLE = True
 except ImportError:
@@ -23,18 +23,54 @@ if script_dir not in sys.path:
     sys.path.insert(0, script_dir)
 
 from mandelbrot_utils import calculate_hw_params
+from mandelbrot_utils import (REG_MAX_ITER, REG_PAN_X, REG_PAN_Y, REG_ZOOM, REG_CTRL,
+                              REG_PERIOD_EPS, REG_PAN_X_LO, REG_PAN_X_HI, REG_PAN_Y_LO, REG_PAN_Y_HI,
+                              REG_ORBIT_LEN, REG_ORBIT_INDEX, REG_ORBIT_DATA, REG_JULIA_RE, REG_JULIA_IM, REG_COMMIT,
+                              REG_PAN_SHIFT, REG_IBUF_ADDR, REG_WIDTH, REG_HEIGHT, RESOLUTIONS, CTRL_PAN_REUSE_EN, CTRL_MIRROR_EN, PAN_REUSE_ZOOM_LIMIT, PAN_SHIFT_NONE,
+                              CTRL_CARDIOID_EN, CTRL_PERIOD_EN, CTRL_WIDE_EN, CTRL_PERTURB_EN,
+                              CTRL_EXT_STREAM, CTRL_JULIA_EN, CTRL_TILE_EN, CTRL_PROGRESSIVE_EN, JULIA_C_DEFAULT, SCREEN_WIDTH, SCREEN_HEIGHT,
+                              PERIOD_EPS_DEFAULT, NARROW_ZOOM_LIMIT, WIDE_ZOOM_LIMIT, ORBIT_DEPTH,
+                              STATUS_CARDIOID_HITS, STATUS_CARDIOID_SAVED,
+                              STATUS_PERTURB_REBASES, STATUS_PERTURB_GLITCHES,
+                              STATUS_APPLIED_FRAME, STATUS_FRAME_NUMBER, COMMIT_TIMEOUT,
+                              STATUS_FRAME_CYCLES, STATUS_FRAME_ITERS_LO, STATUS_FRAME_ITERS_HI,
+                              STATUS_STREAM_STALLS, STATUS_ISSUE_IDLE, STATUS_MAX_PIXEL_ITERS,
+                              STATUS_COMMIT_LATENCY, STATUS_TILE_FILLED, STATUS_TILE_SAVED,
+                              STATUS_PASS_DONE, PASS_FULL, STATUS_PAN_COPIED,
+                              float_to_q8_56_words, smooth_iterations,
+                              CTRL_RAW_STREAM, RAW_COUNT_MAX, raw_iterations, colorize_iterations,
+                              CONTINUOUS_FRAME_LAG, CTRL_SCALE_EN, REG_ORIGIN_RE_LO, REG_ORIGIN_RE_HI,
+                              REG_ORIGIN_IM_LO, REG_ORIGIN_IM_HI, REG_DX_RE_LO, REG_DX_RE_HI,
+                              REG_DX_IM_LO, REG_DX_IM_HI, REG_DY_RE_LO, REG_DY_RE_HI,
+                              REG_DY_IM_LO, REG_DY_IM_HI, q8_56_words, is_zoom_view,
+                              REG_PALETTE_MAP, REG_PALETTE_SWAP, PALETTE_BASE, PALETTE_SIZE,
+                              PALETTE_MAP_EN, PALETTE_FLIP, hardware_palette,
+                              REG_HIST_SHIFT, HIST_BASE, HIST_BINS, STATUS_HIST_FRAME, STATUS_HIST_INTERIOR,
+                              histogram_shift, equalized_palette, STATUS_MAX_ESCAPED,
+                              next_max_iter, AUTO_ITER_MIN)
+from reference_orbit import compute_reference_orbit
 
 app = Flask(__name__)
 
 overlay = None
 s2mm_channel = None
 mandel_ip = None
-VIDEO_MODE = None
+video_modes = {}
+loaded_orbit_key = None
+committed_key = None
+ibuf = None
+last_pan_view = None
+raw_frame = None
+stream_mode = None
+view_rate = None
+palette_table = None
+rotation_unsupported = False
+palette_map = None
 
 # --- HARDWARE IMPLEMENTATION ---
 def initialize_hardware():
     """Loads the overlay and gets handles to our IP. Called once on startup."""
-    global overlay, s2mm_channel, mandel_ip, VIDEO_MODE
+    global overlay, s2mm_channel, mandel_ip, ibuf
     if not PYNQ_AVAILABLE:
         print("PYNQ libraries not found. Running in software-only mode.")
         return
@@ -43,7 +79,16 @@ def initialize_hardware():
         overlay = Overlay('elec.bit')
         s2mm_channel = overlay.video.axi_vdma_0.readchannel
         mandel_ip = overlay.pixel_generator_0
-        VIDEO_MODE = VideoMode(640, 480, 24)
+        # One VDMA mode per output size and stream format. The extended
+        # stream sends two 32-bit beats per pixel, the raw stream two
+        # pixels per beat.
+        for width, height in RESOLUTIONS.values():
+            video_modes[(width, height, 'rgb')] = VideoMode(width, height, 24)
+            video_modes[(width, height, 'ext')] = VideoMode(2 * width, height, 32)
+            video_modes[(width, height, 'raw')] = VideoMode(width // 2, height, 32)
+        # Two frames of iteration counts for incremental pans
+        ibuf = allocate(shape=(2 * SCREEN_HEIGHT * SCREEN_WIDTH,), dtype=np.uint32)
+        mandel_ip.write(REG_IBUF_ADDR, ibuf.physical_address)
         print("Hardware initialized successfully!")
     except Exception as e:
         print(f"Error initializing hardware: {e}")
@@ -53,32 +98,438 @@ def float_to_q4_28(val):
     """Helper function for fixed-point conversion."""
     return int(val * (2**28))
 
+def is_julia(ui_state):
+    """renderMode 'julia' renders the Julia set of juliaRe + i*juliaIm on the FPGA."""
+    return ui_state.get('renderMode', 'fpga') == 'julia'
+
+def julia_constant(ui_state):
+    return (ui_state.get('juliaRe', JULIA_C_DEFAULT[0]), ui_state.get('juliaIm', JULIA_C_DEFAULT[1]))
+
+def load_reference_orbit(center_re, center_im, zoom_level, max_iter):
+    """Computes the reference orbit for the view centre and loads it into the IP."""
+    global loaded_orbit_key
+    key = (str(center_re), str(center_im), zoom_level, max_iter)
+    if key == loaded_orbit_key:
+        return
+    orbit = compute_reference_orbit(center_re, center_im, zoom_level, min(max_iter + 1, ORBIT_DEPTH))
+    mandel_ip.write(REG_ORBIT_INDEX, 0)
+    for re, im, exp in orbit:
+        mandel_ip.write(REG_ORBIT_DATA, re & 0xFFFFFFFF)
+        mandel_ip.write(REG_ORBIT_DATA, im & 0xFFFFFFFF)
+        mandel_ip.write(REG_ORBIT_DATA, exp & 0xFFFF)
+    mandel_ip.write(REG_ORBIT_LEN, len(orbit))
+    loaded_orbit_key = key
+
+def smooth_color_frame(words, max_iter, width, height):
+    """Colours an extended-stream frame with the continuous iteration count."""
+    words = np.ascontiguousarray(words).view(np.uint32).reshape(height, 2 * width)
+    mu = smooth_iterations(words[:, 0::2], words[:, 1::2], max_iter)
+    rgb = plt.get_cmap('twilight_shifted')((mu % 64) / 64.0)[..., :3]
+    rgb[mu >= max_iter] = 0
+    return (rgb * 255).astype(np.uint8)
+
 def generate_mandelbrot_fpga(ui_state):
     """
     Configures the Mandelbrot IP, captures one frame from the hardware,
     and returns it as a NumPy array.
     """
+    global committed_key, last_pan_view, raw_frame, rotation_unsupported
+    width, height = RESOLUTIONS.get(ui_state.get('resolution'), (SCREEN_WIDTH, SCREEN_HEIGHT))
     if not mandel_ip or not s2mm_channel:
         print("FPGA not available, returning black frame.")
-        return np.zeros((480, 640, 3), dtype=np.uint8)
-    
-    s2mm_channel.mode = VIDEO_MODE
-    s2mm_channel.start()
+        return np.zeros((height, width, 3), dtype=np.uint8)
     
+    smooth = ui_state.get('smoothColor', False)
+    # The hardware streams frames back to back; in continuous mode the VDMA
+    # keeps running and each request takes the newest frame
+    continuous = ui_state.get('continuous', False)
     pan_x, pan_y = ui_state.get('centerX', -0.7), ui_state.get('centerY', 0.0)
     zoom, max_iter = ui_state.get('zoom', 1.0), ui_state.get('maxIter', 100)
+    # With autoIter, maxIter is the ceiling for the closed loop
+    if ui_state.get('autoIter', False):
+        max_iter = auto_max_iter(ui_state.get('autoIterMin', AUTO_ITER_MIN), max_iter, width * height)
+    scheme = ui_state.get('colorScheme', 'classic')
+    # Raw counts are coloured here, so a palette change needs no new frame.
+    # A continuous stream is coloured by the palette RAM instead, which
+    # costs the host nothing per frame. Its histogram palette is equalized
+    # from the on-chip histogram of the frame before.
+    equalize = continuous and not smooth and scheme == 'histogram'
+    hw_palette = equalize or not smooth and (continuous or not ui_state.get('rawStream', True)) \
+        and hardware_palette(scheme, max_iter) is not None
+    raw = not smooth and not hw_palette and max_iter <= RAW_COUNT_MAX and ui_state.get('rawStream', True)
     zoom_level = int(np.log2(zoom + 0.001)) if zoom > 0 else 0
-    mandel_ip.write(0x00, max_iter)
-    mandel_ip.write(0x04, float_to_q4_28(pan_x))
-    mandel_ip.write(0x08, float_to_q4_28(pan_y))
-    mandel_ip.write(0x0C, zoom_level)
+    # The pixel step does not depend on the frame size; zoom in by the
+    # power of two closest below the width ratio to keep the view similar
+    zoom_level += (width // SCREEN_WIDTH).bit_length() - 1
+    native = (width, height) == (SCREEN_WIDTH, SCREEN_HEIGHT)
+    julia = is_julia(ui_state)
+    ctrl = CTRL_CARDIOID_EN if ui_state.get('cardioidSkip', True) else 0
+    if ui_state.get('periodCheck', True):
+        ctrl |= CTRL_PERIOD_EN
+    if julia:
+        ctrl |= CTRL_JULIA_EN
+        julia_re, julia_im = julia_constant(ui_state)
+        mandel_ip.write(REG_JULIA_RE, float_to_q4_28(julia_re) & 0xFFFFFFFF)
+        mandel_ip.write(REG_JULIA_IM, float_to_q4_28(julia_im) & 0xFFFFFFFF)
+    # Only pay for the Q8.56 lanes once the 32-bit path runs out of bits,
+    # and switch to perturbation once Q8.56 runs out too. The reference
+    # orbit is a Mandelbrot orbit, so Julia frames stop at Q8.56.
+    if zoom_level > WIDE_ZOOM_LIMIT and not julia:
+        ctrl |= CTRL_PERTURB_EN
+        # Decimal strings keep the centre exact beyond double precision
+        load_reference_orbit(ui_state.get('centerXStr', pan_x), ui_state.get('centerYStr', pan_y),
+                             zoom_level, max_iter)
+    elif zoom_level > NARROW_ZOOM_LIMIT:
+        ctrl |= CTRL_WIDE_EN
+    # ZOOM can only halve the pixel and never rotates. SCALE_EN steps by any
+    # amount in any direction, on every scheduler. Perturbation ignores it.
+    hw = calculate_hw_params(ui_state, width, height)
+    scaled = zoom_level <= WIDE_ZOOM_LIMIT and not is_zoom_view(hw, zoom_level)
+    # Past WIDE_ZOOM_LIMIT only ZOOM applies, so the frame comes out
+    # unrotated; say so rather than pretend
+    rotation_unsupported = not scaled and ui_state.get('rotation', 0) % 360 != 0
+    # Replicated and filled pixels carry no |z|, so progressive and tile
+    # frames are RGB-only. Their engines only exist at the native size. A
+    # continuous stream has no use for the coarse passes.
+    progressive = not smooth and native and not continuous and ui_state.get('progressive', False)
+    if raw:
+        ctrl |= CTRL_RAW_STREAM
+    if smooth:
+        ctrl |= CTRL_EXT_STREAM
+    elif progressive:
+        ctrl |= CTRL_PROGRESSIVE_EN
+    elif native and ui_state.get('tileFill', False):
+        ctrl |= CTRL_TILE_EN
+    if scaled:
+        ctrl |= CTRL_SCALE_EN
+    # A scaled view pans on its own Q8.56 grid, so it is exact at any depth
+    # SCALE_EN reaches
+    if native and not (smooth or ctrl & (CTRL_PROGRESSIVE_EN | CTRL_TILE_EN)) \
+            and ui_state.get('panReuse', False) and (scaled or zoom_level <= PAN_REUSE_ZOOM_LIMIT):
+        ctrl |= CTRL_PAN_REUSE_EN
+    # Mirroring runs on the pan scheduler too; the hardware only applies it
+    # when the view is centred on the real axis
+    if native and not smooth and not (ctrl & (CTRL_PROGRESSIVE_EN | CTRL_TILE_EN)) \
+            and ui_state.get('mirror', False):
+        ctrl |= CTRL_MIRROR_EN
+    pan_x_q, pan_y_q = float_to_q4_28(pan_x), float_to_q4_28(pan_y)
+    shift = PAN_SHIFT_NONE
+    if ctrl & CTRL_PAN_REUSE_EN:
+        view = (max_iter, zoom_level, ctrl, ui_state.get('periodEps', PERIOD_EPS_DEFAULT),
+                julia_constant(ui_state) if julia else None)
+        if scaled:
+            dx, dy = (hw['dx_re'], hw['dx_im']), (hw['dy_re'], hw['dy_im'])
+            (hw['origin_re'], hw['origin_im']), shift = \
+                pan_shift(view + (dx, dy), (hw['origin_re'], hw['origin_im']), dx, dy)
+        else:
+            # Snap the centre to the pixel grid so that pans are translations
+            step = 1 << (PAN_REUSE_ZOOM_LIMIT - zoom_level)
+            pan_x_q = round(pan_x_q / step) * step
+            pan_y_q = round(pan_y_q / step) * step
+            _, shift = pan_shift(view, (pan_x_q, pan_y_q), (step, 0), (0, step))
+    else:
+        last_pan_view = None
+    pan_x_lo, pan_x_hi = float_to_q8_56_words(pan_x)
+    pan_y_lo, pan_y_hi = float_to_q8_56_words(pan_y)
+    origin_re_lo, origin_re_hi = q8_56_words(hw['origin_re'])
+    origin_im_lo, origin_im_hi = q8_56_words(hw['origin_im'])
+    dx_re_lo, dx_re_hi = q8_56_words(hw['dx_re'])
+    dx_im_lo, dx_im_hi = q8_56_words(hw['dx_im'])
+    dy_re_lo, dy_re_hi = q8_56_words(hw['dy_re'])
+    dy_im_lo, dy_im_hi = q8_56_words(hw['dy_im'])
+    registers = [
+        (REG_MAX_ITER, max_iter),
+        (REG_PAN_X, pan_x_q),
+        (REG_PAN_Y, pan_y_q),
+        (REG_ZOOM, zoom_level),
+        (REG_PERIOD_EPS, ui_state.get('periodEps', PERIOD_EPS_DEFAULT)),
+        (REG_PAN_X_LO, pan_x_lo),
+        (REG_PAN_X_HI, pan_x_hi),
+        (REG_PAN_Y_LO, pan_y_lo),
+        (REG_PAN_Y_HI, pan_y_hi),
+        (REG_CTRL, ctrl),
+        (REG_PAN_SHIFT, shift),
+        (REG_WIDTH, width),
+        (REG_HEIGHT, height),
+        (REG_ORIGIN_RE_LO, origin_re_lo),
+        (REG_ORIGIN_RE_HI, origin_re_hi),
+        (REG_ORIGIN_IM_LO, origin_im_lo),
+        (REG_ORIGIN_IM_HI, origin_im_hi),
+        (REG_DX_RE_LO, dx_re_lo),
+        (REG_DX_RE_HI, dx_re_hi),
+        (REG_DX_IM_LO, dx_im_lo),
+        (REG_DX_IM_HI, dx_im_hi),
+        (REG_DY_RE_LO, dy_re_lo),
+        (REG_DY_RE_HI, dy_re_hi),
+        (REG_DY_IM_LO, dy_im_lo),
+        (REG_DY_IM_HI, dy_im_hi),
+    ]
+    # Recolour the last raw frame if only the palette changed
+    frame_key = (tuple(r for r in registers if r[0] != REG_PAN_SHIFT),
+                 julia_constant(ui_state) if julia else None,
+                 loaded_orbit_key if ctrl & CTRL_PERTURB_EN else None)
+    if raw and not continuous and raw_frame is not None and raw_frame[0] == frame_key:
+        return colorize_iterations(raw_frame[1], max_iter, scheme)
+    mode = video_modes[(width, height, 'ext' if smooth else 'raw' if raw else 'rgb')]
+    if continuous:
+        start_stream(mode)
+    else:
+        stop_stream()
+        s2mm_channel.mode = mode
+        s2mm_channel.start()
+    # A progressive view is requested twice, for the preview and then the
+    # full frame. Committing again would restart it from the 1/8 pass. A
+    # continuous stream keeps the committed view whatever PAN_SHIFT says now.
+    # JULIA_RE/IM and the reference orbit are written outside the register
+    # list but belong to the view all the same.
+    key = frame_key if continuous else (tuple(registers), frame_key[1:])
+    # RGB frames take the palette from the next frame on, whether or not
+    # the view changes; raw and extended frames never pass through it
+    offset = ui_state.get('paletteOffset', 0)
+    swapped = not (raw or smooth or equalize) and \
+        set_palette(scheme if hw_palette else 'classic', max_iter, offset)
+    if equalize:
+        mandel_ip.write(REG_HIST_SHIFT, histogram_shift(max_iter))
+    committed = False
+    if not (progressive or continuous) or key != committed_key:
+        for reg, value in registers:
+            mandel_ip.write(reg, value)
+        commit_parameters()
+        committed_key = key
+        committed = True
+        if continuous:
+            wait_for_frames(CONTINUOUS_FRAME_LAG)
+    if equalize:
+        # Needs a complete frame of the view, so it follows the commit
+        swapped = set_equalized_palette(max_iter, offset)
+    if continuous and swapped and (equalize or not committed):
+        # New colours: skip the frames the VDMA buffered before the swap
+        wait_for_frames(CONTINUOUS_FRAME_LAG, mandel_ip.read(STATUS_FRAME_NUMBER))
+    if progressive and not ui_state.get('preview', False):
+        wait_for_pass(PASS_FULL)
     frame = s2mm_channel.readframe()
-    s2mm_channel.stop()
+    if continuous:
+        measure_view_rate(frame_key)
+    else:
+        s2mm_channel.stop()
+    if smooth:
+        return smooth_color_frame(frame, max_iter, width, height)
+    if raw:
+        iterations = raw_iterations(frame, width, height)
+        # A preview is replaced by the full frame of the same view
+        if not (progressive and ui_state.get('preview', False)):
+            raw_frame = (frame_key, iterations)
+        return colorize_iterations(iterations, max_iter, scheme)
     return frame
 
+def auto_max_iter(lo, hi, pixels):
+    """
+    Closed-loop MAX_ITER within [lo, hi], from the interior fraction and
+    highest escaped count of the last complete frame. Until a frame with the
+    committed parameters has completed, the committed limit is kept.
+    """
+    current = mandel_ip.read(REG_MAX_ITER)
+    if mandel_ip.read(STATUS_HIST_FRAME) < mandel_ip.read(STATUS_APPLIED_FRAME):
+        return min(max(current, lo), hi)
+    interior = mandel_ip.read(STATUS_HIST_INTERIOR)
+    return next_max_iter(current, interior / pixels, mandel_ip.read(STATUS_MAX_ESCAPED), lo, hi)
+
+def pan_shift(view, point, dx, dy):
+    """
+    PAN_SHIFT for moving from the last pan-reuse frame to this one, with
+    point (the centre or ORIGIN) moved by whole dx and dy pixel steps from
+    that frame's, so the move is an exact translation. PAN_SHIFT_NONE, with
+    point as given, when anything but the position changed.
+    """
+    global last_pan_view
+    previous = last_pan_view
+    last_pan_view = (view, point)
+    if previous is None or previous[0] != view:
+        return point, PAN_SHIFT_NONE
+    # Solve point - previous = sx * dx + sy * dy for the nearest whole pixels
+    d_re, d_im = point[0] - previous[1][0], point[1] - previous[1][1]
+    det = dx[0] * dy[1] - dx[1] * dy[0]
+    sx = round((d_re * dy[1] - d_im * dy[0]) / det)
+    sy = round((dx[0] * d_im - dx[1] * d_re) / det)
+    if abs(sx) >= SCREEN_WIDTH or abs(sy) >= SCREEN_HEIGHT:
+        return point, PAN_SHIFT_NONE
+    point = (previous[1][0] + sx * dx[0] + sy * dy[0], previous[1][1] + sx * dx[1] + sy * dy[1])
+    last_pan_view = (view, point)
+    return point, ((sy & 0xFFFF) << 16) | (sx & 0xFFFF)
+
+def commit_parameters():
+    """
+    Applies the registers written above as one set and waits until the frame
+    that uses them has been fully issued, so the next frame read shows them.
+    """
+    mandel_ip.write(REG_COMMIT, 1)
+    deadline = time.time() + COMMIT_TIMEOUT
+    while time.time() < deadline:
+        if (mandel_ip.read(REG_COMMIT) == 0 and
+                mandel_ip.read(STATUS_FRAME_NUMBER) > mandel_ip.read(STATUS_APPLIED_FRAME)):
+            return True
+    print("COMMIT did not complete in time; the frame may use old parameters.")
+    return False
+
+def start_stream(mode):
+    """Keeps the VDMA read channel running, restarting it only for a new mode."""
+    global stream_mode
+    if stream_mode == mode:
+        return
+    stop_stream()
+    s2mm_channel.mode = mode
+    s2mm_channel.start()
+    stream_mode = mode
+
+def stop_stream():
+    """Stops a channel left running by continuous mode."""
+    global stream_mode, view_rate
+    if stream_mode is not None:
+        s2mm_channel.stop()
+        stream_mode = None
+    view_rate = None
+
+def set_palette(scheme, max_iter, offset=0):
+    """
+    Puts scheme on screen through the palette RAM from the next frame, or the
+    built-in ramp for 'classic'. Returns True if the colours changed.
+    """
+    return load_palette(scheme, hardware_palette(scheme, max_iter), offset)
+
+def set_equalized_palette(max_iter, offset=0):
+    """
+    Equalizes the palette over the on-chip histogram of the last complete
+    frame of the committed view. Keeps the current palette if there is none
+    yet. Returns True if the colours changed.
+    """
+    bins = read_histogram()
+    if bins is None:
+        return False
+    table = equalized_palette(bins, histogram_shift(max_iter))
+    # A still view keeps the same histogram, and then the same table
+    return load_palette(tuple(table[0]), table, offset)
+
+def read_histogram():
+    """
+    The bins of the on-chip histogram, or None until it describes a frame of
+    the committed view. HIST_FRAME is read on both sides of the bins, so a
+    frame boundary in between is caught and the read repeated.
+    """
+    for _ in range(3):
+        frame = mandel_ip.read(STATUS_HIST_FRAME)
+        if frame < mandel_ip.read(STATUS_APPLIED_FRAME):
+            return None
+        bins = [mandel_ip.read(HIST_BASE + 4 * b) for b in range(HIST_BINS)]
+        if mandel_ip.read(STATUS_HIST_FRAME) == frame:
+            return bins
+    return None
+
+def load_palette(key, table, offset=0):
+    """
+    Shows table, as returned by hardware_palette, from the next frame; None
+    selects the built-in ramp. A table not already loaded under key goes
+    into the bank off screen and is swapped in with the map. A new scale or
+    offset alone is just a swap of the map.
+    """
+    global palette_table, palette_map
+    mapping = 0
+    if table is not None:
+        entries, scale = table
+        mapping = PALETTE_MAP_EN | ((offset % PALETTE_SIZE) << 16) | scale
+    flip = table is not None and palette_table != key
+    if mapping == palette_map and not flip:
+        return False
+    if flip:
+        for i, rgb in enumerate(entries):
+            mandel_ip.write(PALETTE_BASE + 4 * i, rgb)
+    mandel_ip.write(REG_PALETTE_MAP, mapping)
+    mandel_ip.write(REG_PALETTE_SWAP, PALETTE_FLIP if flip else 0)
+    # The bank just put on screen must not be written until the swap is done
+    deadline = time.time() + COMMIT_TIMEOUT
+    while time.time() < deadline:
+        if mandel_ip.read(REG_PALETTE_SWAP) == 0:
+            break
+    else:
+        print("Palette swap did not complete in time.")
+    if flip:
+        palette_table = key
+    palette_map = mapping
+    return True
+
+def wait_for_frames(count, since=None):
+    """
+    Waits until count frames have started since frame number since, by
+    default the one the last COMMIT took effect in.
+    """
+    deadline = time.time() + COMMIT_TIMEOUT
+    while time.time() < deadline:
+        start = mandel_ip.read(STATUS_APPLIED_FRAME) if since is None else since
+        if mandel_ip.read(STATUS_FRAME_NUMBER) >= start + count:
+            return True
+    print(f"Frame {count} after the COMMIT or swap did not start in time.")
+    return False
+
+def measure_view_rate(key):
+    """
+    Tracks the frame rate sustained on the current view: frames the hardware
+    streamed and frames the host fetched, since the first fetch of the view.
+    """
+    global view_rate
+    now = time.perf_counter()
+    frame_number = mandel_ip.read(STATUS_FRAME_NUMBER)
+    if view_rate is None or view_rate['key'] != key:
+        view_rate = {'key': key, 'start': now, 'frame': frame_number, 'fetched': 0}
+    view_rate['fetched'] += 1
+    view_rate['elapsed'] = now - view_rate['start']
+    view_rate['frames'] = frame_number - view_rate['frame']
+
+def view_rate_stats():
+    """Sustained rates for the view on screen, once it has been up for two fetches."""
+    if not view_rate or view_rate['elapsed'] <= 0:
+        return {}
+    return {
+        "sustainedFps": view_rate['frames'] / view_rate['elapsed'],
+        "fetchedFps": (view_rate['fetched'] - 1) / view_rate['elapsed'],
+    }
+
+def wait_for_pass(target):
+    """Waits until the progressive engine has streamed pass target."""
+    deadline = time.time() + COMMIT_TIMEOUT
+    while time.time() < deadline:
+        if mandel_ip.read(STATUS_PASS_DONE) >= target:
+            return True
+    print(f"Progressive pass {target} did not complete in time.")
+    return False
+
+def read_fpga_stats():
+    """Reads the per-frame statistics of the last complete hardware frame."""
+    if not mandel_ip:
+        return {}
+    return {
+        "cardioidHits": mandel_ip.read(STATUS_CARDIOID_HITS),
+        "cardioidSavedIters": mandel_ip.read(STATUS_CARDIOID_SAVED),
+        "perturbRebases": mandel_ip.read(STATUS_PERTURB_REBASES),
+        "perturbGlitches": mandel_ip.read(STATUS_PERTURB_GLITCHES),
+        "frameCycles": mandel_ip.read(STATUS_FRAME_CYCLES),
+        "frameIterations": mandel_ip.read(STATUS_FRAME_ITERS_LO) |
+                           (mandel_ip.read(STATUS_FRAME_ITERS_HI) << 32),
+        "streamStallCycles": mandel_ip.read(STATUS_STREAM_STALLS),
+        "issueIdleCycles": mandel_ip.read(STATUS_ISSUE_IDLE),
+        "maxPixelIterations": mandel_ip.read(STATUS_MAX_PIXEL_ITERS),
+        "commitLatencyCycles": mandel_ip.read(STATUS_COMMIT_LATENCY),
+        "tileFilledPixels": mandel_ip.read(STATUS_TILE_FILLED),
+        "tileSavedIters": mandel_ip.read(STATUS_TILE_SAVED),
+        "progressivePass": mandel_ip.read(STATUS_PASS_DONE),
+        "panCopiedPixels": mandel_ip.read(STATUS_PAN_COPIED),
+        "histogramInteriorPixels": mandel_ip.read(STATUS_HIST_INTERIOR),
+        "maxEscapedIterations": mandel_ip.read(STATUS_MAX_ESCAPED),
+        "maxIter": mandel_ip.read(REG_MAX_ITER),
+        "rotationUnsupported": rotation_unsupported,
+        **view_rate_stats(),
+    }
+
 # --- SOFTWARE (CPU) IMPLEMENTATION ---
-def mandelbrot_cpu_pixel(c_re, c_im, max_iter):
-    z_re, z_im = 0.0, 0.0
+def mandelbrot_cpu_pixel(c_re, c_im, max_iter, z_re=0.0, z_im=0.0):
     for i in range(max_iter):
         z_re_sq, z_im_sq = z_re * z_re, z_im * z_im
         if z_re_sq + z_im_sq > 4.0: return i
@@ -94,11 +545,21 @@ def generate_mandelbrot_cpu(ui_state):
     view_width = 3.5 / zoom
     view_height = view_width * (height / width)
     frame = np.zeros((height, width, 3), dtype=np.uint8)
+    julia = is_julia(ui_state)
+    julia_re, julia_im = julia_constant(ui_state)
+    # Offsets from the centre turn with the view, as on the FPGA
+    angle = np.radians(ui_state.get('rotation', 0.0))
+    cos_a, sin_a = np.cos(angle), np.sin(angle)
     for y in range(height):
         for x in range(width):
-            c_re = center_x - view_width/2 + (x/width)*view_width
-            c_im = center_y - view_height/2 + (y/height)*view_height
-            iters = mandelbrot_cpu_pixel(c_re, c_im, max_iter)
+            u = (x/width - 0.5)*view_width
+            v = (y/height - 0.5)*view_height
+            c_re = center_x + u*cos_a - v*sin_a
+            c_im = center_y + u*sin_a + v*cos_a
+            if julia:
+                iters = mandelbrot_cpu_pixel(julia_re, julia_im, max_iter, c_re, c_im)
+            else:
+                iters = mandelbrot_cpu_pixel(c_re, c_im, max_iter)
             if iters == max_iter:
                 frame[y, x] = [0, 0, 0]
             else:
@@ -116,13 +577,16 @@ def update_fractal():
     ui_state = request.get_json()
     render_mode = ui_state.get('renderMode', 'fpga')
     start_time = time.perf_counter()
+    stats = {}
     if render_mode == 'cpu':
         frame = generate_mandelbrot_cpu(ui_state)
         mode_used = "CPU"
     else:
         frame = generate_mandelbrot_fpga(ui_state)
-        mode_used = "FPGA"
+        mode_used = "FPGA (Julia)" if is_julia(ui_state) else "FPGA"
     end_time = time.perf_counter()
+    if mode_used.startswith("FPGA"):
+        stats = read_fpga_stats()
     pil_img = Image.fromarray(frame)
     buff = io.BytesIO()
     pil_img.save(buff, format="PNG")
@@ -131,8 +595,9 @@ def update_fractal():
     fps = 1.0 / delay if delay > 0 else 0
     return jsonify({
         "status": "ok", "fps": f"{fps:.2f}", "renderTime": f"{delay:.3f}s",
-        "throughput": f"{(640*480)/delay/1e6:.2f} MPixels/s",
-        "modeUsed": mode_used, "imageBase64": f"data:image/png;base64,{img_base64}"
+        "throughput": f"{(frame.shape[0] * frame.shape[1])/delay/1e6:.2f} MPixels/s",
+        "modeUsed": mode_used, "imageBase64": f"data:image/png;base64,{img_base64}",
+        "hwStats": stats
     })
     
 @app.route('/benchmark', methods=['POST'])
@@ -1,42 +1,339 @@
+import math
+import numpy as np
+
 # Screen and Mandelbrot Set Constants
 SCREEN_WIDTH = 640
 SCREEN_HEIGHT = 480
-BASE_VIEW_WIDTH = 3.5 # The complex plane width at zoom = 1.0
+# Output sizes the bitstream can stream (MAX_WIDTH x MAX_HEIGHT = 1920x1080).
+# The tile, progressive and pan engines only run at SCREEN_WIDTH x SCREEN_HEIGHT.
+RESOLUTIONS = {
+    '640x480': (640, 480),
+    '1280x720': (1280, 720),
+    '1920x1080': (1920, 1080),
+}
+# The complex plane width at zoom = 1.0 on a SCREEN_WIDTH frame: the hardware's
+# 2^-8 pixel at ZOOM = 0
+BASE_VIEW_WIDTH = SCREEN_WIDTH / 256
+
+# pixel_generator AXI-Lite register map (byte offsets)
+REG_MAX_ITER = 0x00
+REG_PAN_X = 0x04
+REG_PAN_Y = 0x08
+REG_ZOOM = 0x0C
+REG_CTRL = 0x10
+REG_PERIOD_EPS = 0x14
+REG_JULIA_RE = 0x18   # Julia constant c, Q4.28
+REG_JULIA_IM = 0x1C
+REG_PAN_X_LO = 0x20   # Q8.56 pan for the deep-zoom datapath
+REG_PAN_X_HI = 0x24
+REG_PAN_Y_LO = 0x28
+REG_PAN_Y_HI = 0x2C
+REG_ORBIT_LEN = 0x30   # Reference orbit entries loaded
+REG_ORBIT_INDEX = 0x34 # Word index for ORBIT_DATA, four words per entry
+REG_ORBIT_DATA = 0x38  # re, im, exp per entry; auto-increments ORBIT_INDEX
+REG_COMMIT = 0x3C      # Applies 0x00-0x30, 0x40-0x7C from the next frame; reads 1 until done
+REG_PAN_SHIFT = 0x40   # Pixels the view moved since the last frame, y[31:16] x[15:0]
+REG_IBUF_ADDR = 0x44   # DDR address of the two-frame iteration buffer
+REG_WIDTH = 0x48       # Frame size in pixels
+REG_HEIGHT = 0x4C
+REG_ORIGIN_RE_LO = 0x50  # Q8.56 c of pixel (0, 0) for CTRL_SCALE_EN
+REG_ORIGIN_RE_HI = 0x54
+REG_ORIGIN_IM_LO = 0x58
+REG_ORIGIN_IM_HI = 0x5C
+REG_DX_RE_LO = 0x60      # Q8.56 step from one pixel to the next along a line
+REG_DX_RE_HI = 0x64
+REG_DX_IM_LO = 0x68
+REG_DX_IM_HI = 0x6C
+REG_DY_RE_LO = 0x70      # Q8.56 step from one line to the next
+REG_DY_RE_HI = 0x74
+REG_DY_IM_LO = 0x78
+REG_DY_IM_HI = 0x7C
+
+# Palette RAM, outside the committed register file. PALETTE_MAP is
+# {enable[31], offset[25:16], scale[15:0]}: escaped points take entry
+# ((iterations * scale) >> 8) + offset. PALETTE_SWAP puts it and, with
+# PALETTE_FLIP, the bank loaded through PALETTE_BASE on screen from the next
+# frame; it reads 1 until that frame starts, and entries must not be written
+# before then.
+REG_PALETTE_MAP = 0x800
+REG_PALETTE_SWAP = 0x804
+PALETTE_BASE = 0x1000
+PALETTE_SIZE = 1024
+PALETTE_MAP_EN = 1 << 31
+PALETTE_FLIP = 1
+PALETTE_SCALE_ONE = 0x100  # Q8.8
+
+# On-chip histogram of the last complete frame: escaped pixels per bin of
+# iterations >> HIST_SHIFT, the last bin catching the rest. HIST_SHIFT
+# applies from the next frame.
+REG_HIST_SHIFT = 0x808
+HIST_BASE = 0x2000
+HIST_BINS = 1024
+
+# CTRL register bits
+CTRL_CARDIOID_EN = 1 << 0
+CTRL_PERIOD_EN = 1 << 1
+CTRL_WIDE_EN = 1 << 2
+CTRL_PERTURB_EN = 1 << 3
+CTRL_EXT_STREAM = 1 << 4   # Two beats per pixel: iterations, then |z|^2 (Q4.28)
+CTRL_JULIA_EN = 1 << 5     # z0 = pixel, c = JULIA_RE/IM
+CTRL_TILE_EN = 1 << 6      # Mariani-Silver fill; not bit-exact
+CTRL_PROGRESSIVE_EN = 1 << 7  # 1/8, 1/4, 1/2 previews, then full frames
+CTRL_PAN_REUSE_EN = 1 << 8    # Only compute the pixels a pan uncovers
+CTRL_MIRROR_EN = 1 << 9       # Copy the lower half on views centred on the real axis
+CTRL_RAW_STREAM = 1 << 10     # Two 16-bit iteration counts per beat, coloured on the host
+CTRL_SCALE_EN = 1 << 11       # c = ORIGIN + x * DX + y * DY instead of PAN and ZOOM
+
+# The 32-bit datapath stops refining past this zoom level, where a pixel
+# (2^(20 - zoom) Q4.28 LSBs) is down to one LSB
+NARROW_ZOOM_LIMIT = 20
+# ... and the Q8.56 datapath past this one; deeper frames use perturbation
+WIDE_ZOOM_LIMIT = 48
+
+# Deepest zoom at which a pan by whole pixels is an exact translation
+PAN_REUSE_ZOOM_LIMIT = 20
+# PAN_SHIFT for a view that is not a translation of the last one
+PAN_SHIFT_NONE = 0x80008000
+
+# Raw-stream counts saturate here, so max_iter must not exceed it
+RAW_COUNT_MAX = 0xFFFF
+
+# Host palettes for raw frames; 'classic' is the hardware color_mapper
+BLUE_WHITE_STOPS = [(0.0, (0, 7, 100)), (0.5, (32, 107, 203)), (1.0, (255, 255, 255))]
+ULTRA_FRACTAL_STOPS = [(0.0, (0, 7, 100)), (0.16, (32, 107, 203)), (0.42, (237, 255, 255)),
+                       (0.6425, (255, 170, 0)), (0.8575, (0, 2, 0)), (1.0, (0, 7, 100))]
+ULTRA_FRACTAL_PERIOD = 64
+
+# Reference orbit RAM depth (ORBIT_DEPTH in pixel_generator)
+ORBIT_DEPTH = 2048
+
+# Julia constant used when the UI does not send one
+JULIA_C_DEFAULT = (-0.8, 0.156)
+
+# Default periodicity tolerance: 2^-24 in Q4.28
+PERIOD_EPS_DEFAULT = 16
+
+# Read-only status registers, describing the last complete frame
+STATUS_CARDIOID_HITS = 0x80
+STATUS_CARDIOID_SAVED = 0x84
+STATUS_PERTURB_REBASES = 0x88
+STATUS_PERTURB_GLITCHES = 0x8C
+STATUS_APPLIED_FRAME = 0x90   # Frame the last COMMIT took effect in
+STATUS_FRAME_NUMBER = 0x94    # Frames started since reset
+STATUS_FRAME_CYCLES = 0x98    # Pixel clocks in the last frame
+STATUS_FRAME_ITERS_LO = 0x9C  # Iterations in the last frame, 64 bits
+STATUS_FRAME_ITERS_HI = 0xA0
+STATUS_STREAM_STALLS = 0xA4   # Clocks stalled on TREADY
+STATUS_ISSUE_IDLE = 0xA8      # Clocks with a free calculator and nothing to issue
+STATUS_MAX_PIXEL_ITERS = 0xAC
+STATUS_COMMIT_LATENCY = 0xB0  # Pixel clocks from COMMIT to the SOF of its frame
+STATUS_TILE_FILLED = 0xB4     # Pixels the tile engine filled without iterating
+STATUS_TILE_SAVED = 0xB8      # Iterations those pixels would have taken
+STATUS_PASS_DONE = 0xBC       # Progressive passes streamed since COMMIT, 4 = full
+STATUS_PAN_COPIED = 0xC0      # Pixels reused from the previous frame or mirrored
+STATUS_HIST_FRAME = 0xC4      # Frame the histogram describes, 0 if none
+STATUS_HIST_INTERIOR = 0xC8   # Pixels of that frame that reached max_iter
+STATUS_MAX_ESCAPED = 0xCC     # Highest iteration count below max_iter in that frame
+
+# How long to wait for a COMMIT to reach the stream, in seconds
+COMMIT_TIMEOUT = 1.0
+
+# PASS_DONE once the progressive engine streams full-resolution frames
+PASS_FULL = 4
+
+# Continuous mode: readframe() returns a frame two VDMA frame stores behind
+# the one being written, so a new view is only on screen this many frames
+# after the one its COMMIT took effect in
+CONTINUOUS_FRAME_LAG = 3
+
+# Automatic MAX_ITER. Escaped counts within AUTO_ITER_RAISE_AT of the limit,
+# with more than AUTO_ITER_INTERIOR of the frame black, mean the limit cuts
+# off detail and is doubled. A highest escaped count below AUTO_ITER_LOWER_AT
+# of the limit means the interior is iterated for nothing; the limit drops
+# to AUTO_ITER_HEADROOM times that count. The gap between the two keeps it
+# from oscillating.
+AUTO_ITER_RAISE_AT = 0.9
+AUTO_ITER_LOWER_AT = 0.5
+AUTO_ITER_HEADROOM = 1.5
+AUTO_ITER_INTERIOR = 0.001
+AUTO_ITER_STEP = 10         # Same as the UI slider
+AUTO_ITER_MIN = 50
 
 def float_to_q4_28(val):
     """Converts a Python float to a Q4.28 fixed-point integer."""
     return int(val * (2**28))
 
-def calculate_hw_params(ui_state):
+def float_to_q8_56(val):
+    """Converts a Python float to a Q8.56 fixed-point integer."""
+    return int(val * (2**56))
+
+def q8_56_words(fixed):
+    """Splits a Q8.56 integer into (lo, hi) 32-bit register words."""
+    fixed &= (1 << 64) - 1
+    return fixed & 0xFFFFFFFF, fixed >> 32
+
+def float_to_q8_56_words(val):
+    """Converts a Python float to Q8.56 and splits it into (lo, hi) 32-bit words."""
+    return q8_56_words(float_to_q8_56(val))
+
+def zoom_step(zoom_level):
+    """Q8.56 pixel step that ZOOM = zoom_level gives: 2^-(8 + zoom_level)."""
+    return 1 << (56 - 8 - zoom_level)
+
+def smooth_iterations(iterations, magnitude, max_iter):
     """
-    Converts UI state (centerX, centerY, zoom) into hardware parameters
-    (c_real_min, c_imag_max, scale) in fixed-point format.
+    Continuous iteration count from an extended-stream frame.
+    iterations and magnitude are uint32 arrays of the two beats per pixel;
+    interior pixels (iterations >= max_iter) come back as max_iter.
+    """
+    iterations = np.asarray(iterations, dtype=np.float64)
+    mag = np.asarray(magnitude, dtype=np.float64) / 2**28
+    escaped = (iterations < max_iter) & (mag >= 4.0)
+    # |z|^2 >= 4 on escaped pixels, so log2(|z|) >= 1 and the correction is in [0, 1]
+    log_z = np.log2(np.where(escaped, mag, 4.0)) / 2.0
+    smooth = iterations + 1.0 - np.log2(log_z)
+    return np.where(escaped, np.minimum(smooth, max_iter), float(max_iter))
+
+def raw_iterations(words, width, height):
+    """
+    Unpacks a raw-stream frame: two 16-bit counts per 32-bit word, the
+    left pixel in the low half. Returns a (height, width) uint16 copy.
+    """
+    words = np.ascontiguousarray(words).view(np.uint32).reshape(height, width // 2)
+    return words.view(np.uint16).reshape(height, width).copy()
+
+def _gradient(stops, t):
+    """Interpolates the colour stops at positions t in [0, 1]."""
+    positions = [p for p, _ in stops]
+    colours = np.array([c for _, c in stops], dtype=np.float64)
+    return np.stack([np.interp(t, positions, colours[:, i]) for i in range(3)], axis=-1)
+
+def palette_lut(scheme, max_iter, counts=None):
+    """
+    RGB for every count from 0 to max_iter, as a (max_iter + 1, 3) uint8
+    table. 'histogram' equalizes over the escaped pixels in counts.
+    """
+    n = np.arange(max_iter + 1)
+    if scheme == 'blue_white':
+        lut = _gradient(BLUE_WHITE_STOPS, np.sqrt(n / max(max_iter, 1)))
+    elif scheme == 'ultra_fractal':
+        lut = _gradient(ULTRA_FRACTAL_STOPS, (n % ULTRA_FRACTAL_PERIOD) / ULTRA_FRACTAL_PERIOD)
+    elif scheme == 'histogram':
+        hist = np.bincount(counts.ravel(), minlength=max_iter + 1)[:max_iter]
+        cdf = np.cumsum(hist) / max(hist.sum(), 1)
+        lut = _gradient(BLUE_WHITE_STOPS, np.append(cdf, 1.0))
+    else:
+        # color_mapper: four 256-step ramps over iter * 4
+        stretched = n * 4
+        ramp = stretched & 0xFF
+        segment = (stretched >> 8) & 0x3
+        lut = np.stack([
+            np.select([segment == 0, segment == 1, segment == 2], [ramp, 255, 255 - ramp], 0),
+            np.select([segment == 0, segment == 1, segment == 2], [0, ramp, 255], 255 - ramp),
+            np.select([segment == 0, segment == 1, segment == 2], [0, 0, ramp], 255),
+        ], axis=-1)
+    lut = lut.astype(np.uint8)
+    lut[max_iter] = 0
+    return lut
+
+def hardware_palette(scheme, max_iter):
+    """
+    The palette RAM contents and PALETTE_MAP scale that reproduce scheme, as
+    (entries, scale) with entries packed 0xRRGGBB, or None for schemes the
+    hardware cannot show. The tables do not depend on max_iter, so a new
+    max_iter only changes the scale.
+    """
+    i = np.arange(PALETTE_SIZE)
+    if scheme == 'blue_white':
+        # Spread the counts below max_iter over the whole table
+        lut = _gradient(BLUE_WHITE_STOPS, np.sqrt(i / PALETTE_SIZE))
+        scale = min(PALETTE_SIZE * PALETTE_SCALE_ONE // max(max_iter, 1), 0xFFFF)
+    elif scheme == 'ultra_fractal':
+        lut = _gradient(ULTRA_FRACTAL_STOPS, (i % ULTRA_FRACTAL_PERIOD) / ULTRA_FRACTAL_PERIOD)
+        scale = PALETTE_SCALE_ONE
+    else:
+        return None
+    return _pack_rgb(lut), scale
+
+def histogram_shift(max_iter):
+    """HIST_SHIFT that fits every count below max_iter into the histogram bins."""
+    return min(max((max_iter - 1).bit_length() - (HIST_BINS - 1).bit_length(), 0), 8)
+
+def equalized_palette(bins, shift):
+    """
+    Palette RAM contents and scale for histogram equalization from the
+    on-chip histogram, binned with HIST_SHIFT shift. Like the 'histogram'
+    host palette, each bin takes the gradient at the fraction of escaped
+    pixels up to and including it.
+    """
+    hist = np.asarray(bins, dtype=np.float64)
+    cdf = np.cumsum(hist) / max(hist.sum(), 1)
+    return _pack_rgb(_gradient(BLUE_WHITE_STOPS, cdf)), PALETTE_SCALE_ONE >> shift
+
+def _pack_rgb(lut):
+    """Packs an (n, 3) table as 0xRRGGBB palette RAM words."""
+    lut = lut.astype(np.uint32)
+    entries = (lut[:, 0] << 16) | (lut[:, 1] << 8) | lut[:, 2]
+    return [int(e) for e in entries]
+
+def colorize_iterations(iterations, max_iter, scheme='classic'):
+    """Colours a frame of iteration counts with one table lookup per pixel."""
+    counts = np.minimum(iterations, max_iter)
+    return palette_lut(scheme, max_iter, counts)[counts]
+
+def calculate_hw_params(ui_state, width=SCREEN_WIDTH, height=SCREEN_HEIGHT):
+    """
+    Converts UI state (centerX, centerY, zoom, rotation in degrees) into the
+    CTRL_SCALE_EN parameters for a width x height frame: the c of pixel
+    (0, 0) and the steps along a line (dx) and down the frame (dy), as Q8.56
+    integers. Like screen_mapper, +im points down an unrotated frame and
+    (width / 2, height / 2) lands on the centre.
     """
     zoom = ui_state.get('zoom', 1.0)
     center_x = ui_state.get('centerX', -0.7)
     center_y = ui_state.get('centerY', 0.0)
+    angle = math.radians(ui_state.get('rotation', 0.0))
     
-    # 1. Calculate view dimensions in the complex plane
-    view_width = BASE_VIEW_WIDTH / zoom
-    view_height = view_width * (SCREEN_HEIGHT / SCREEN_WIDTH)
+    # 1. The view is BASE_VIEW_WIDTH / zoom wide whatever the frame size
+    step = BASE_VIEW_WIDTH / zoom / width * 2**56
     
-    # 2. Calculate the top-left corner of the view
-    c_real_min_f = center_x - (view_width / 2.0)
-    c_imag_max_f = center_y + (view_height / 2.0)
+    # 2. Turn the pixel axes by the rotation; dy is dx a quarter turn on
+    dx_re, dx_im = round(step * math.cos(angle)), round(step * math.sin(angle))
+    dy_re, dy_im = -dx_im, dx_re
     
-    # 3. Calculate the scale factor
-    scale_f = view_width / SCREEN_WIDTH
-    
-    # 4. Convert all floating-point values to Q4.28 fixed-point integers
+    # 3. Step back from the centre to the top-left pixel in whole steps, so
+    #    that a power-of-two zoom gives exactly the ZOOM coordinates
     hw_params = {
         'max_iter': int(ui_state.get('maxIter', 100)),
-        'c_real_min': float_to_q4_28(c_real_min_f),
-        'c_imag_max': float_to_q4_28(c_imag_max_f),
-        'scale': float_to_q4_28(scale_f)
+        'origin_re': float_to_q8_56(center_x) - (width // 2) * dx_re - (height // 2) * dy_re,
+        'origin_im': float_to_q8_56(center_y) - (width // 2) * dx_im - (height // 2) * dy_im,
+        'dx_re': dx_re,
+        'dx_im': dx_im,
+        'dy_re': dy_re,
+        'dy_im': dy_im,
     }
     
     return hw_params
 
+def next_max_iter(max_iter, interior_fraction, max_escaped, lo=AUTO_ITER_MIN, hi=RAW_COUNT_MAX):
+    """
+    MAX_ITER for the next frame from the statistics of one rendered with
+    max_iter: the fraction of pixels that reached it and the highest count
+    that escaped. Kept within [lo, hi] and on AUTO_ITER_STEP.
+    """
+    target = max_iter
+    if max_escaped >= AUTO_ITER_RAISE_AT * max_iter and interior_fraction > AUTO_ITER_INTERIOR:
+        target = 2 * max_iter
+    elif max_escaped < AUTO_ITER_LOWER_AT * max_iter:
+        target = int(max_escaped * AUTO_ITER_HEADROOM)
+    target = -(-target // AUTO_ITER_STEP) * AUTO_ITER_STEP
+    return min(max(target, lo), hi)
+
+def is_zoom_view(hw_params, zoom_level):
+    """True when the view is what PAN and ZOOM = zoom_level render."""
+    step = zoom_step(zoom_level)
+    return (hw_params['dx_re'], hw_params['dx_im'], hw_params['dy_re'], hw_params['dy_im']) == (step, 0, 0, step)
+
 # --- You can test this function right now! ---
 if __name__ == '__main__':
     # Simulate the UI sending a state
@@ -44,6 +341,7 @@ if __name__ == '__main__':
         'centerX': -0.745,
         'centerY': 0.186,
         'zoom': 500.0,
+        'rotation': 30.0,
         'maxIter': 1000
     }
     
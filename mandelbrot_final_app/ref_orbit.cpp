@@ -0,0 +1,89 @@
+// Reference orbit for the perturbation datapath, in arbitrary precision.
+//
+// Build on the board with:
+//     g++ -O2 -shared -fPIC ref_orbit.cpp -lgmp -o libref_orbit.so
+// reference_orbit.py loads the library if present and falls back to
+// Python integers otherwise.
+
+#include <gmp.h>
+#include <cstdint>
+
+namespace {
+
+const int32_t EXP_ZERO = -16384;
+const int NORM = 29;
+
+// Split a fixed-point pair into the shared-exponent format of
+// perturb_calculator: the larger component gets its top bit at NORM.
+void to_delta(const mpz_t re, const mpz_t im, int frac_bits,
+              int32_t *out_re, int32_t *out_im, int32_t *out_exp) {
+    if (mpz_sgn(re) == 0 && mpz_sgn(im) == 0) {
+        *out_re = 0;
+        *out_im = 0;
+        *out_exp = EXP_ZERO;
+        return;
+    }
+
+    size_t bits_re = mpz_sgn(re) ? mpz_sizeinbase(re, 2) : 0;
+    size_t bits_im = mpz_sgn(im) ? mpz_sizeinbase(im, 2) : 0;
+    long lead = static_cast<long>(bits_re > bits_im ? bits_re : bits_im) - 1;
+    long shift = lead - NORM;
+
+    mpz_t m_re, m_im;
+    mpz_inits(m_re, m_im, nullptr);
+    if (shift >= 0) {
+        mpz_fdiv_q_2exp(m_re, re, shift);
+        mpz_fdiv_q_2exp(m_im, im, shift);
+    } else {
+        mpz_mul_2exp(m_re, re, -shift);
+        mpz_mul_2exp(m_im, im, -shift);
+    }
+    *out_re = static_cast<int32_t>(mpz_get_si(m_re));
+    *out_im = static_cast<int32_t>(mpz_get_si(m_im));
+    *out_exp = static_cast<int32_t>(shift - frac_bits);
+    mpz_clears(m_re, m_im, nullptr);
+}
+
+} // namespace
+
+extern "C" {
+
+// center_re/center_im: the reference point as hex strings of fixed-point
+// integers with frac_bits fractional bits. Fills up to max_len entries,
+// stopping after the first one that escapes; returns the count.
+int ref_orbit(const char *center_re, const char *center_im, int frac_bits, int max_len,
+              int32_t *out_re, int32_t *out_im, int32_t *out_exp) {
+    mpz_t c_re, c_im, z_re, z_im, re_sq, im_sq, re_im, mag, limit;
+    mpz_inits(c_re, c_im, z_re, z_im, re_sq, im_sq, re_im, mag, limit, nullptr);
+    mpz_set_str(c_re, center_re, 16);
+    mpz_set_str(c_im, center_im, 16);
+
+    // |z|^2 >= 4, compared before the products are scaled back
+    mpz_set_ui(limit, 4);
+    mpz_mul_2exp(limit, limit, 2 * frac_bits);
+
+    int count = 0;
+    while (count < max_len) {
+        to_delta(z_re, z_im, frac_bits, &out_re[count], &out_im[count], &out_exp[count]);
+        count++;
+
+        mpz_mul(re_sq, z_re, z_re);
+        mpz_mul(im_sq, z_im, z_im);
+        mpz_add(mag, re_sq, im_sq);
+        if (mpz_cmp(mag, limit) >= 0) break;
+
+        // z = z^2 + c, truncating like a fixed-point datapath would
+        mpz_mul(re_im, z_re, z_im);
+        mpz_sub(z_re, re_sq, im_sq);
+        mpz_fdiv_q_2exp(z_re, z_re, frac_bits);
+        mpz_add(z_re, z_re, c_re);
+        mpz_mul_2exp(re_im, re_im, 1);
+        mpz_fdiv_q_2exp(z_im, re_im, frac_bits);
+        mpz_add(z_im, z_im, c_im);
+    }
+
+    mpz_clears(c_re, c_im, z_re, z_im, re_sq, im_sq, re_im, mag, limit, nullptr);
+    return count;
+}
+
+}
@@ -0,0 +1,86 @@
+"""
+Reference orbit for the perturbation datapath.
+
+The orbit of the view centre is computed in arbitrary precision, by
+libref_orbit.so (ref_orbit.cpp, GMP) when it has been built, or with Python
+integers otherwise. Entries come back in perturb_calculator's format: two
+mantissas sharing an exponent, (re + i*im) * 2^exp.
+"""
+import ctypes
+import os
+from decimal import Decimal
+from fractions import Fraction
+
+EXP_ZERO = -16384
+NORM = 29
+
+# Bits kept below the pixel size, so the orbit stays exact long after the
+# delta iteration has lost track of individual pixels
+GUARD_BITS = 64
+
+_lib = None
+_lib_path = os.path.join(os.path.dirname(os.path.abspath(__file__)), 'libref_orbit.so')
+if os.path.exists(_lib_path):
+    try:
+        _lib = ctypes.CDLL(_lib_path)
+        _lib.ref_orbit.restype = ctypes.c_int
+        _lib.ref_orbit.argtypes = [ctypes.c_char_p, ctypes.c_char_p, ctypes.c_int, ctypes.c_int,
+                                   ctypes.POINTER(ctypes.c_int32), ctypes.POINTER(ctypes.c_int32),
+                                   ctypes.POINTER(ctypes.c_int32)]
+    except OSError as e:
+        print(f"Could not load {_lib_path}: {e}. Using the Python reference orbit.")
+        _lib = None
+
+
+def _to_fixed(val, frac_bits):
+    """Exact fixed-point integer for a float, int or decimal string."""
+    if isinstance(val, str):
+        val = Decimal(val)
+    return int(Fraction(val) * (1 << frac_bits))
+
+
+def _to_delta(re, im, frac_bits):
+    lead = max(abs(re).bit_length(), abs(im).bit_length()) - 1
+    if lead < 0:
+        return (0, 0, EXP_ZERO)
+    shift = lead - NORM
+    if shift >= 0:
+        return (re >> shift, im >> shift, shift - frac_bits)
+    return (re << -shift, im << -shift, shift - frac_bits)
+
+
+def _orbit_python(c_re, c_im, frac_bits, max_len):
+    orbit = []
+    z_re = z_im = 0
+    limit = 4 << (2 * frac_bits)
+    while len(orbit) < max_len:
+        orbit.append(_to_delta(z_re, z_im, frac_bits))
+        re_sq, im_sq = z_re * z_re, z_im * z_im
+        if re_sq + im_sq >= limit:
+            break
+        z_re, z_im = ((re_sq - im_sq) >> frac_bits) + c_re, ((2 * z_re * z_im) >> frac_bits) + c_im
+    return orbit
+
+
+def _hex(v):
+    return ('-' if v < 0 else '') + format(abs(v), 'x')
+
+
+def compute_reference_orbit(center_re, center_im, zoom_level, max_len):
+    """
+    Orbit of the view centre as a list of (re, im, exp) entries, at enough
+    precision for pixels of 2^-(8 + zoom_level).
+    """
+    frac_bits = 8 + zoom_level + GUARD_BITS
+    c_re = _to_fixed(center_re, frac_bits)
+    c_im = _to_fixed(center_im, frac_bits)
+
+    if _lib is None:
+        return _orbit_python(c_re, c_im, frac_bits, max_len)
+
+    out_re = (ctypes.c_int32 * max_len)()
+    out_im = (ctypes.c_int32 * max_len)()
+    out_exp = (ctypes.c_int32 * max_len)()
+    count = _lib.ref_orbit(_hex(c_re).encode(), _hex(c_im).encode(), frac_bits, max_len,
+                           out_re, out_im, out_exp)
+    return [(out_re[k], out_im[k], out_exp[k]) for k in range(count)]
@@ -3,9 +3,18 @@ document.addEventListener('DOMContentLoaded', () => {
     // --- Get references to all UI elements ---
     const iterSlider = document.getElementById('iter-slider');
     const iterValue = document.getElementById('iter-value');
+    const autoIterCheckbox = document.getElementById('auto-iter');
     const precisionSlider = document.getElementById('precision-slider');
     const precisionValue = document.getElementById('precision-value');
+    const rotationSlider = document.getElementById('rotation-slider');
+    const rotationValue = document.getElementById('rotation-value');
     const colorSchemeSelect = document.getElementById('color-scheme');
+    const paletteOffsetSlider = document.getElementById('palette-offset-slider');
+    const paletteOffsetValue = document.getElementById('palette-offset-value');
+    const resolutionSelect = document.getElementById('resolution');
+    const continuousCheckbox = document.getElementById('continuous');
+    const panReuseCheckbox = document.getElementById('pan-reuse');
+    const mirrorCheckbox = document.getElementById('mirror');
     const renderModeRadios = document.querySelectorAll('input[name="renderMode"]');
     const presetButtons = document.querySelectorAll('.btn-preset');
     const resetButton = document.getElementById('btn-reset');
@@ -25,20 +34,29 @@ document.addEventListener('DOMContentLoaded', () => {
     const metricTime = document.getElementById('metric-time');
     const metricFps = document.getElementById('metric-fps');
     const metricThroughput = document.getElementById('metric-throughput');
+    const metricSustained = document.getElementById('metric-sustained');
 
     // --- State Management ---
     const viewState = {
         centerX: -0.7,
         centerY: 0.0,
         zoom: 1.0,
+        rotation: parseInt(rotationSlider.value),
         maxIter: parseInt(iterSlider.value),
+        autoIter: autoIterCheckbox.checked,
         precision: parseInt(precisionSlider.value),
         colorScheme: colorSchemeSelect.value,
+        paletteOffset: parseInt(paletteOffsetSlider.value),
+        resolution: resolutionSelect.value,
         renderMode: document.querySelector('input[name="renderMode"]:checked').value,
+        progressive: true,
+        continuous: continuousCheckbox.checked,
+        panReuse: panReuseCheckbox.checked,
+        mirror: mirrorCheckbox.checked,
     };
 
     const updateLiveExplanation = () => {
-        const mode = viewState.renderMode === 'fpga' ? 'the parallel FPGA hardware' : 'the sequential CPU';
+        const mode = viewState.renderMode === 'cpu' ? 'the sequential CPU' : 'the parallel FPGA hardware';
         expMode.textContent = `▶ Calculations are being performed by ${mode}.`;
         expIter.textContent = `▶ The system will check up to ${viewState.maxIter} times per pixel to see if it escapes.`;
         if (viewState.zoom > 1.0) {
@@ -48,33 +66,82 @@ document.addEventListener('DOMContentLoaded', () => {
         }
     };
 
+    const requestFrame = async (state) => {
+        const response = await fetch('/update', {
+            method: 'POST',
+            headers: { 'Content-Type': 'application/json' },
+            body: JSON.stringify(state),
+        });
+        return response.json();
+    };
+
+    const showFrame = (data) => {
+        if (data.imageBase64) {
+            displayMock.style.backgroundImage = `url('${data.imageBase64}')`;
+            infoOverlay.style.display = 'none';
+        }
+    };
+
+    const showMetrics = (data) => {
+        metricMode.textContent = data.modeUsed;
+        metricTime.textContent = data.renderTime;
+        metricFps.textContent = data.fps;
+        metricThroughput.textContent = data.throughput;
+        const sustained = data.hwStats && data.hwStats.sustainedFps;
+        metricSustained.textContent = sustained !== undefined ? sustained.toFixed(1) : '--';
+        // The limit the hardware actually used, up to the slider's ceiling
+        const maxIter = data.hwStats && data.hwStats.maxIter;
+        iterValue.textContent = viewState.autoIter && maxIter !== undefined
+            ? `${maxIter} (auto, max ${iterSlider.value})` : iterSlider.value;
+        // Past the Q8.56 range the FPGA can only zoom, not rotate
+        const unrotated = data.hwStats && data.hwStats.rotationUnsupported;
+        rotationValue.textContent = unrotated
+            ? `${rotationSlider.value}° (not supported at this depth)` : `${rotationSlider.value}°`;
+    };
+
+    const isStreaming = () => viewState.continuous && viewState.renderMode !== 'cpu';
+
+    // Continuous mode: keep fetching the newest hardware frame. View changes
+    // are picked up by the next request, so updateView stays out of the way.
+    let streamRunning = false;
+    const streamFrames = async () => {
+        if (streamRunning) return;
+        streamRunning = true;
+        while (isStreaming()) {
+            try {
+                const data = await requestFrame(viewState);
+                showMetrics(data);
+                showFrame(data);
+            } catch (error) {
+                console.error('Error streaming frames:', error);
+                metricMode.textContent = "Error";
+                break;
+            }
+        }
+        streamRunning = false;
+    };
+
     // --- The Main Update Function ---
-    const updateView = async () => {
-        console.log('Sending state to backend:', viewState);
+    const updateView = async (options = {}) => {
+        const state = { ...viewState, ...options };
+        if (isStreaming()) {
+            updateLiveExplanation();
+            return;
+        }
+        console.log('Sending state to backend:', state);
         updateLiveExplanation();
         loadingSpinner.classList.remove('spinner-hidden');
 
         try {
-            const response = await fetch('/update', {
-                method: 'POST',
-                headers: { 'Content-Type': 'application/json' },
-                body: JSON.stringify(viewState),
-            });
-            const data = await response.json();
-
-            metricMode.textContent = data.modeUsed;
-            metricTime.textContent = data.renderTime;
-            metricFps.textContent = data.fps;
-            metricThroughput.textContent = data.throughput;
-
-            // ***** NEW CODE HERE *****
-            // Check if the backend sent us image data
-            if (data.imageBase64) {
-                // Set the background of the display div to our new image
-                displayMock.style.backgroundImage = `url('${data.imageBase64}')`;
-                // Hide the placeholder text
-                infoOverlay.style.display = 'none';
+            // The hardware streams a coarse pass first; show it while the
+            // full-resolution frame is computed
+            if (state.renderMode !== 'cpu' && state.progressive) {
+                showFrame(await requestFrame({ ...state, preview: true }));
             }
+            const data = await requestFrame(state);
+
+            showMetrics(data);
+            showFrame(data);
 
         } catch (error) {
             console.error('Error updating view:', error);
@@ -86,21 +153,45 @@ document.addEventListener('DOMContentLoaded', () => {
 
     // --- Event Listeners (No changes needed below this line) ---
     iterSlider.addEventListener('input', () => { iterValue.textContent = iterSlider.value; });
+
+    autoIterCheckbox.addEventListener('change', () => { viewState.autoIter = autoIterCheckbox.checked; updateView(); });
+    panReuseCheckbox.addEventListener('change', () => { viewState.panReuse = panReuseCheckbox.checked; updateView(); });
+    mirrorCheckbox.addEventListener('change', () => { viewState.mirror = mirrorCheckbox.checked; updateView(); });
     iterSlider.addEventListener('change', () => { viewState.maxIter = parseInt(iterSlider.value); updateView(); });
 
     precisionSlider.addEventListener('input', () => { precisionValue.textContent = `${precisionSlider.value}-bit`; });
     precisionSlider.addEventListener('change', () => { viewState.precision = parseInt(precisionSlider.value); updateView(); });
     
+    rotationSlider.addEventListener('input', () => { rotationValue.textContent = `${rotationSlider.value}°`; });
+    rotationSlider.addEventListener('change', () => { viewState.rotation = parseInt(rotationSlider.value); updateView(); });
+
     colorSchemeSelect.addEventListener('change', () => { viewState.colorScheme = colorSchemeSelect.value; updateView(); });
 
+    paletteOffsetSlider.addEventListener('input', () => { paletteOffsetValue.textContent = paletteOffsetSlider.value; });
+    paletteOffsetSlider.addEventListener('change', () => { viewState.paletteOffset = parseInt(paletteOffsetSlider.value); updateView(); });
+
+    resolutionSelect.addEventListener('change', () => { viewState.resolution = resolutionSelect.value; updateView(); });
+
     renderModeRadios.forEach(radio => {
-        radio.addEventListener('change', () => { viewState.renderMode = radio.value; updateView(); });
+        radio.addEventListener('change', () => {
+            const streaming = isStreaming();
+            viewState.renderMode = radio.value;
+            if (!streaming && isStreaming()) streamFrames(); else updateView();
+        });
+    });
+
+    continuousCheckbox.addEventListener('change', () => {
+        viewState.continuous = continuousCheckbox.checked;
+        if (isStreaming()) streamFrames(); else updateView();
     });
 
     resetButton.addEventListener('click', () => {
         viewState.centerX = -0.7;
         viewState.centerY = 0.0;
         viewState.zoom = 1.0;
+        viewState.rotation = 0;
+        rotationSlider.value = 0;
+        rotationValue.textContent = '0°';
         updateView();
     });
 
@@ -129,8 +220,12 @@ document.addEventListener('DOMContentLoaded', () => {
         const viewWidth = 3.5 / viewState.zoom;
         const viewHeight = viewWidth * (height/width);
 
-        viewState.centerX += ((x / width) - 0.5) * viewWidth;
-        viewState.centerY += ((y / height) - 0.5) * viewHeight;
+        // The click offset is along the rotated view axes
+        const u = ((x / width) - 0.5) * viewWidth;
+        const v = ((y / height) - 0.5) * viewHeight;
+        const angle = viewState.rotation * Math.PI / 180;
+        viewState.centerX += u * Math.cos(angle) - v * Math.sin(angle);
+        viewState.centerY += u * Math.sin(angle) + v * Math.cos(angle);
         
         // Check which mouse button was pressed
         if (e.button === 0) { // 0 is the left mouse button
@@ -159,7 +254,8 @@ document.addEventListener('DOMContentLoaded', () => {
         else if(e.key === 'ArrowRight') viewState.centerX += panAmount;
         else return;
         e.preventDefault();
-        updateView();
+        // A pan only needs the newly exposed strip computed
+        updateView({ progressive: false });
     });
 
     // Modal and Theme logic remains the same
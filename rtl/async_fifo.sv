@@ -0,0 +1,85 @@
+// Dual-clock FIFO with valid/ready handshakes on both sides.
+// The pointers cross as Gray code through cdc_synchronizer, so each side
+// sees the other's pointer two of its own clocks late: full and empty are
+// pessimistic, never wrong. The read port is first-word fall-through from
+// distributed RAM. Both resets must be held for a few clocks of the slower
+// side so the two pointers restart together.
+module async_fifo #(
+    parameter WIDTH = 32,
+    parameter ADDR_WIDTH = 4        // DEPTH = 2^ADDR_WIDTH, at least 4
+)(
+    input                   wclk,
+    input                   wrst,
+    input                   w_valid,
+    output                  w_ready,
+    input  [WIDTH-1:0]      w_data,
+
+    input                   rclk,
+    input                   rrst,
+    output                  r_valid,
+    input                   r_ready,
+    output [WIDTH-1:0]      r_data
+);
+
+    localparam DEPTH = 1 << ADDR_WIDTH;
+
+    reg [WIDTH-1:0] mem [DEPTH-1:0];
+
+    // One bit wider than the address, so a full FIFO differs from an empty one
+    reg  [ADDR_WIDTH:0] wbin, wgray;
+    reg  [ADDR_WIDTH:0] rbin, rgray;
+    wire [ADDR_WIDTH:0] wgray_s, rgray_s;
+
+    wire [ADDR_WIDTH:0] wbin_next = wbin + 1;
+    wire [ADDR_WIDTH:0] rbin_next = rbin + 1;
+
+    wire w_fire = w_valid && w_ready;
+    wire r_fire = r_valid && r_ready;
+
+    // Full when the writer is a whole lap ahead: in Gray code the top two
+    // bits differ and the rest match
+    assign w_ready = (wgray != {~rgray_s[ADDR_WIDTH:ADDR_WIDTH-1], rgray_s[ADDR_WIDTH-2:0]});
+    assign r_valid = (rgray != wgray_s);
+    assign r_data  = mem[rbin[ADDR_WIDTH-1:0]];
+
+    always_ff @(posedge wclk) begin
+        if (w_fire) begin
+            mem[wbin[ADDR_WIDTH-1:0]] <= w_data;
+        end
+    end
+
+    always_ff @(posedge wclk) begin
+        if (wrst) begin
+            wbin <= 0;
+            wgray <= 0;
+        end else if (w_fire) begin
+            wbin <= wbin_next;
+            wgray <= wbin_next ^ (wbin_next >> 1);
+        end
+    end
+
+    always_ff @(posedge rclk) begin
+        if (rrst) begin
+            rbin <= 0;
+            rgray <= 0;
+        end else if (r_fire) begin
+            rbin <= rbin_next;
+            rgray <= rbin_next ^ (rbin_next >> 1);
+        end
+    end
+
+    cdc_synchronizer #(.WIDTH(ADDR_WIDTH + 1)) sync_wptr (
+        .dest_clk(rclk),
+        .rst(rrst),
+        .data_in(wgray),
+        .data_out(wgray_s)
+    );
+
+    cdc_synchronizer #(.WIDTH(ADDR_WIDTH + 1)) sync_rptr (
+        .dest_clk(wclk),
+        .rst(wrst),
+        .data_in(rgray),
+        .data_out(rgray_s)
+    );
+
+endmodule
@@ -0,0 +1,411 @@
+module calculator_array #(
+    // "LANES":  LANES independent mandelbrot_calculator instances
+    // "BARREL": LANES mandelbrot_calculator_barrel cores, each keeping
+    //           BARREL_MULT_STAGES + 2 pixels in flight
+    parameter ENGINE             = "LANES",
+    parameter LANES              = 4,
+    parameter BARREL_MULT_STAGES = 3,
+    parameter TAG_WIDTH          = 4,
+    // z^2 kernel of the LANES and wide calculators: "MULT3" or "LEAN"
+    parameter SQUARE_KERNEL      = "MULT3",
+    // Optional lanes with a wider fixed-point format, used for pixels
+    // issued with issue_wide. 0 leaves them out of the build.
+    parameter WIDE_LANES         = 0,
+    parameter WIDE_DATA_WIDTH    = 64,
+    parameter WIDE_FRAC_WIDTH    = 56,
+    // Optional perturbation lanes, used for pixels issued with
+    // issue_perturb. 0 leaves them out of the build.
+    parameter PERTURB_LANES      = 0,
+    parameter ORBIT_DEPTH        = 2048,
+    localparam ORBIT_AWIDTH      = $clog2(ORBIT_DEPTH)
+)(
+    input                           clk,
+    input                           rst,
+
+    // Issue port: a pixel is accepted when issue_valid && issue_ready
+    input                           issue_valid,
+    output logic                    issue_ready,
+    input      [31:0]               issue_c_re,
+    input      [31:0]               issue_c_im,
+    input      [31:0]               issue_z0_re,    // Starting z: 0, or the pixel in Julia mode
+    input      [31:0]               issue_z0_im,
+    input      [TAG_WIDTH-1:0]      issue_tag,
+    input                           issue_wide,     // Route this pixel to the wide lanes
+    input      [WIDE_DATA_WIDTH-1:0] issue_c_re_wide,
+    input      [WIDE_DATA_WIDTH-1:0] issue_c_im_wide,
+    input      [WIDE_DATA_WIDTH-1:0] issue_z0_re_wide,
+    input      [WIDE_DATA_WIDTH-1:0] issue_z0_im_wide,
+    input                           issue_perturb,  // Route this pixel to the perturbation lanes
+    input      [15:0]               issue_dc_re,    // Offset from the reference point,
+    input      [15:0]               issue_dc_im,    //   (re + i*im) * 2^exp
+    input      [15:0]               issue_dc_exp,
+    input                           issue_first,    // Pixel (0, 0) of a frame
+
+    // Parameters from AXI-Lite
+    input      [31:0]               max_iter,
+    input                           shortcut_en,    // Resolve cardioid/bulb points without iterating
+    input                           period_en,      // Periodicity bailout (not in the barrel engine)
+    input      [31:0]               period_eps,
+    input      [31:0]               ref_len,        // Reference orbit entries loaded
+
+    // Reference orbit load port (s_axi_lite_aclk domain)
+    input                           orbit_wclk,
+    input                           orbit_we,
+    input      [ORBIT_AWIDTH-1:0]   orbit_waddr,
+    input      [79:0]               orbit_wdata,
+
+    // Result port: at most one result per cycle, no back-pressure.
+    // The consumer must have space reserved for every tag it issued.
+    output logic                    result_valid,
+    output logic [TAG_WIDTH-1:0]    result_tag,
+    output logic [31:0]             result_iterations,
+    output logic [31:0]             result_magnitude,   // Final |z|^2, Q4.28; 0 for shortcut pixels
+
+    // A pixel was resolved by the interior shortcut this cycle
+    output logic                    shortcut_hit,
+    // Pixel (0, 0) left the issue stage this cycle; a shortcut_hit on the
+    // same cycle is that pixel
+    output logic                    issued_first,
+
+    // Perturbation lanes that rebased / detected a glitch this cycle
+    output logic [7:0]              rebase_count,
+    output logic [7:0]              glitch_count
+);
+
+    localparam LANE_W = $clog2(LANES+1);
+
+    // Finished pixel from the selected engine. The engine considers it
+    // taken on the same cycle, so engine results always win the output.
+    logic                   engine_out_valid;
+    logic [TAG_WIDTH-1:0]   engine_out_tag;
+    logic [31:0]            engine_out_iterations;
+    logic [31:0]            engine_out_magnitude;
+    logic                   engine_issue_ready;
+    wire                    engine_issue_valid;
+
+    // Finished pixel from the wide lanes, taken when the engine has none
+    logic                   wide_out_valid;
+    logic [TAG_WIDTH-1:0]   wide_out_tag;
+    logic [31:0]            wide_out_iterations;
+    logic [31:0]            wide_out_magnitude;
+    logic                   wide_issue_ready;
+    wire                    wide_issue_valid;
+
+    // Finished pixel from the perturbation lanes, taken after the other two
+    logic                   perturb_out_valid;
+    logic [TAG_WIDTH-1:0]   perturb_out_tag;
+    logic [31:0]            perturb_out_iterations;
+    logic [31:0]            perturb_out_magnitude;
+    logic                   perturb_issue_ready;
+    wire                    perturb_issue_valid;
+
+    // -- Issue stage --
+    // The issue port is registered once before a pixel reaches the lanes,
+    // and the interior test is evaluated on the way into the register.
+    // issue_ready then only depends on registered state, so the cardioid
+    // multiplies end at a flop instead of running on into the scheduler's
+    // handshake. A pixel can enter while the one ahead of it leaves.
+    reg                         stage_valid;
+    reg [31:0]                  stage_c_re, stage_c_im, stage_z0_re, stage_z0_im;
+    reg [TAG_WIDTH-1:0]         stage_tag;
+    reg                         stage_wide, stage_perturb, stage_first, stage_shortcut;
+    reg [WIDE_DATA_WIDTH-1:0]   stage_c_re_wide, stage_c_im_wide;
+    reg [WIDE_DATA_WIDTH-1:0]   stage_z0_re_wide, stage_z0_im_wide;
+    reg [15:0]                  stage_dc_re, stage_dc_im, stage_dc_exp;
+    logic                       stage_ready;
+
+    // -- Interior shortcut --
+    // Points inside the main cardioid or the period-2 bulb never escape, so
+    // they are answered with max_iter instead of occupying a lane.
+    wire in_cardioid, in_cardioid_wide;
+
+    cardioid_check cc_inst (
+        .c_re(issue_c_re), .c_im(issue_c_im),
+        .inside(in_cardioid)
+    );
+
+    generate
+    if (WIDE_LANES > 0) begin : wide_cc
+        // The wide c is tested on its Q4.28 slice rather than at full width.
+        // Flooring moves it by under 2^-28 per axis, which moves either test
+        // by under 512 LSBs inside the |re|, |im| < 2 window, so the margin
+        // keeps the test conservative. A c the slice cannot hold is outside.
+        localparam SHIFT = WIDE_FRAC_WIDTH - 28;
+
+        wire [WIDE_DATA_WIDTH-SHIFT-32:0] re_high = issue_c_re_wide[WIDE_DATA_WIDTH-1:SHIFT+31];
+        wire [WIDE_DATA_WIDTH-SHIFT-32:0] im_high = issue_c_im_wide[WIDE_DATA_WIDTH-1:SHIFT+31];
+        wire fits = (&re_high || !(|re_high)) && (&im_high || !(|im_high));
+        wire inside;
+
+        cardioid_check #(
+            .MARGIN(512)
+        ) cc_inst (
+            .c_re(issue_c_re_wide[SHIFT+:32]), .c_im(issue_c_im_wide[SHIFT+:32]),
+            .inside(inside)
+        );
+
+        assign in_cardioid_wide = fits && inside;
+    end else begin : no_wide_cc
+        assign in_cardioid_wide = 1'b0;
+    end
+    endgenerate
+
+    // Perturbation pixels carry no absolute c, so they never take the shortcut
+    wire issue_shortcut = shortcut_en && !issue_perturb &&
+                          (issue_wide ? in_cardioid_wide : in_cardioid);
+
+    assign issue_ready = !stage_valid || stage_ready;
+
+    always_ff @(posedge clk) begin
+        if (rst) begin
+            stage_valid <= 1'b0;
+        end else if (issue_ready) begin
+            stage_valid <= issue_valid;
+        end
+    end
+
+    always_ff @(posedge clk) begin
+        if (issue_valid && issue_ready) begin
+            stage_c_re       <= issue_c_re;
+            stage_c_im       <= issue_c_im;
+            stage_z0_re      <= issue_z0_re;
+            stage_z0_im      <= issue_z0_im;
+            stage_tag        <= issue_tag;
+            stage_wide       <= issue_wide;
+            stage_c_re_wide  <= issue_c_re_wide;
+            stage_c_im_wide  <= issue_c_im_wide;
+            stage_z0_re_wide <= issue_z0_re_wide;
+            stage_z0_im_wide <= issue_z0_im_wide;
+            stage_perturb    <= issue_perturb;
+            stage_dc_re      <= issue_dc_re;
+            stage_dc_im      <= issue_dc_im;
+            stage_dc_exp     <= issue_dc_exp;
+            stage_first      <= issue_first;
+            stage_shortcut   <= issue_shortcut;
+        end
+    end
+
+    reg                 bypass_valid;
+    reg [TAG_WIDTH-1:0] bypass_tag;
+
+    wire wide_drain    = wide_out_valid && !engine_out_valid;
+    wire perturb_drain = perturb_out_valid && !engine_out_valid && !wide_out_valid;
+    wire bypass_drain  = bypass_valid && !engine_out_valid && !wide_out_valid && !perturb_out_valid;
+
+    assign engine_issue_valid  = stage_valid && !stage_shortcut && !stage_wide && !stage_perturb;
+    assign wide_issue_valid    = stage_valid && !stage_shortcut && stage_wide && !stage_perturb;
+    assign perturb_issue_valid = stage_valid && stage_perturb;
+    assign stage_ready  = stage_shortcut ? (!bypass_valid || bypass_drain) :
+                          stage_perturb  ? perturb_issue_ready :
+                          stage_wide     ? wide_issue_ready : engine_issue_ready;
+    assign shortcut_hit = stage_valid && stage_ready && stage_shortcut;
+    assign issued_first = stage_valid && stage_ready && stage_first;
+
+    always_ff @(posedge clk) begin
+        if (rst) begin
+            bypass_valid      <= 1'b0;
+            bypass_tag        <= '0;
+            result_valid      <= 1'b0;
+            result_tag        <= '0;
+            result_iterations <= '0;
+            result_magnitude  <= '0;
+        end else begin
+            result_valid <= engine_out_valid || wide_out_valid || perturb_out_valid || bypass_valid;
+            if (engine_out_valid) begin
+                result_tag        <= engine_out_tag;
+                result_iterations <= engine_out_iterations;
+                result_magnitude  <= engine_out_magnitude;
+            end else if (wide_drain) begin
+                result_tag        <= wide_out_tag;
+                result_iterations <= wide_out_iterations;
+                result_magnitude  <= wide_out_magnitude;
+            end else if (perturb_drain) begin
+                result_tag        <= perturb_out_tag;
+                result_iterations <= perturb_out_iterations;
+                result_magnitude  <= perturb_out_magnitude;
+            end else if (bypass_valid) begin
+                result_tag        <= bypass_tag;
+                result_iterations <= max_iter;
+                result_magnitude  <= '0;
+            end
+
+            if (shortcut_hit) begin
+                bypass_valid <= 1'b1;
+                bypass_tag   <= stage_tag;
+            end else if (bypass_drain) begin
+                bypass_valid <= 1'b0;
+            end
+        end
+    end
+
+    generate
+    if (ENGINE == "BARREL") begin : barrel
+
+        wire [LANES-1:0]     core_in_ready;
+        wire [LANES-1:0]     core_out_valid;
+        logic [LANES-1:0]    core_in_valid;
+        logic [LANES-1:0]    core_out_ready;
+        wire [TAG_WIDTH-1:0] core_tag        [LANES-1:0];
+        wire [31:0]          core_iterations [LANES-1:0];
+        wire [31:0]          core_magnitude  [LANES-1:0];
+
+        // -- Dispatcher: first core with a free ring slot this cycle --
+        logic              free_found;
+        logic [LANE_W-1:0] free_core;
+
+        always_comb begin
+            free_found = 1'b0;
+            free_core  = '0;
+            for (int i = LANES - 1; i >= 0; i--) begin
+                if (core_in_ready[i]) begin
+                    free_found = 1'b1;
+                    free_core  = i[LANE_W-1:0];
+                end
+            end
+            core_in_valid = '0;
+            if (engine_issue_valid && free_found) begin
+                core_in_valid[free_core] = 1'b1;
+            end
+        end
+
+        assign engine_issue_ready = free_found;
+
+        // -- Collector: round-robin over cores with a finished context --
+        reg  [LANE_W-1:0]  rr_next;
+        logic              done_found;
+        logic [LANE_W-1:0] done_core;
+
+        always_comb begin
+            done_found = 1'b0;
+            done_core  = '0;
+            for (int k = 0; k < LANES; k++) begin
+                int idx;
+                idx = (int'(rr_next) + k) % LANES;
+                if (!done_found && core_out_valid[idx]) begin
+                    done_found = 1'b1;
+                    done_core  = idx[LANE_W-1:0];
+                end
+            end
+            core_out_ready = '0;
+            if (done_found) begin
+                core_out_ready[done_core] = 1'b1;
+            end
+        end
+
+        assign engine_out_valid      = done_found;
+        assign engine_out_tag        = core_tag[done_core];
+        assign engine_out_iterations = core_iterations[done_core];
+        assign engine_out_magnitude  = core_magnitude[done_core];
+
+        always_ff @(posedge clk) begin
+            if (rst) begin
+                rr_next <= '0;
+            end else if (done_found) begin
+                rr_next <= (done_core == LANES - 1) ? '0 : done_core + 1'b1;
+            end
+        end
+
+        genvar l;
+        for (l = 0; l < LANES; l++) begin : core
+            mandelbrot_calculator_barrel #(
+                .MULT_STAGES(BARREL_MULT_STAGES), .TAG_WIDTH(TAG_WIDTH)
+            ) barrel_inst (
+                .clk(clk), .rst(rst),
+                .in_valid(core_in_valid[l]), .in_ready(core_in_ready[l]),
+                .in_c_re(stage_c_re), .in_c_im(stage_c_im),
+                .in_z0_re(stage_z0_re), .in_z0_im(stage_z0_im), .in_tag(stage_tag),
+                .max_iter(max_iter),
+                .out_valid(core_out_valid[l]), .out_ready(core_out_ready[l]),
+                .out_tag(core_tag[l]), .out_iterations(core_iterations[l]),
+                .out_magnitude(core_magnitude[l])
+            );
+        end
+
+    end else begin : lanes
+
+        calculator_lanes #(
+            .LANES(LANES), .TAG_WIDTH(TAG_WIDTH), .SQUARE_KERNEL(SQUARE_KERNEL)
+        ) lanes_inst (
+            .clk(clk), .rst(rst),
+            .in_valid(engine_issue_valid), .in_ready(engine_issue_ready),
+            .in_c_re(stage_c_re), .in_c_im(stage_c_im),
+            .in_z0_re(stage_z0_re), .in_z0_im(stage_z0_im), .in_tag(stage_tag),
+            .max_iter(max_iter),
+            .period_en(period_en), .period_eps(period_eps),
+            .out_valid(engine_out_valid), .out_ready(1'b1),
+            .out_tag(engine_out_tag), .out_iterations(engine_out_iterations),
+            .out_magnitude(engine_out_magnitude)
+        );
+
+    end
+
+    // -- Wide lanes: WIDE_DATA_WIDTH-bit datapath for deep zoom --
+    if (WIDE_LANES > 0) begin : wide
+
+        calculator_lanes #(
+            .LANES(WIDE_LANES), .TAG_WIDTH(TAG_WIDTH),
+            .DATA_WIDTH(WIDE_DATA_WIDTH), .FRAC_WIDTH(WIDE_FRAC_WIDTH),
+            .SQUARE_KERNEL(SQUARE_KERNEL)
+        ) lanes_inst (
+            .clk(clk), .rst(rst),
+            .in_valid(wide_issue_valid), .in_ready(wide_issue_ready),
+            .in_c_re(stage_c_re_wide), .in_c_im(stage_c_im_wide),
+            .in_z0_re(stage_z0_re_wide), .in_z0_im(stage_z0_im_wide), .in_tag(stage_tag),
+            .max_iter(max_iter),
+            .period_en(period_en), .period_eps(period_eps),
+            .out_valid(wide_out_valid), .out_ready(!engine_out_valid),
+            .out_tag(wide_out_tag), .out_iterations(wide_out_iterations),
+            .out_magnitude(wide_out_magnitude)
+        );
+
+    end else begin : no_wide
+
+        assign wide_issue_ready    = 1'b0;
+        assign wide_out_valid      = 1'b0;
+        assign wide_out_tag        = '0;
+        assign wide_out_iterations = '0;
+        assign wide_out_magnitude  = '0;
+
+    end
+
+    // -- Perturbation lanes: deltas against a host-computed reference orbit --
+    if (PERTURB_LANES > 0) begin : perturb
+
+        localparam PERTURB_W = $clog2(PERTURB_LANES+1);
+
+        wire [PERTURB_W-1:0] lanes_rebase_count, lanes_glitch_count;
+
+        assign rebase_count = 8'(lanes_rebase_count);
+        assign glitch_count = 8'(lanes_glitch_count);
+
+        perturb_lanes #(
+            .LANES(PERTURB_LANES), .ORBIT_DEPTH(ORBIT_DEPTH), .TAG_WIDTH(TAG_WIDTH)
+        ) lanes_inst (
+            .clk(clk), .rst(rst),
+            .in_valid(perturb_issue_valid), .in_ready(perturb_issue_ready),
+            .in_dc_re(stage_dc_re), .in_dc_im(stage_dc_im), .in_dc_exp(stage_dc_exp),
+            .in_tag(stage_tag),
+            .max_iter(max_iter),
+            .ref_len(ref_len),
+            .orbit_wclk(orbit_wclk), .orbit_we(orbit_we),
+            .orbit_waddr(orbit_waddr), .orbit_wdata(orbit_wdata),
+            .out_valid(perturb_out_valid), .out_ready(!engine_out_valid && !wide_out_valid),
+            .out_tag(perturb_out_tag), .out_iterations(perturb_out_iterations),
+            .out_magnitude(perturb_out_magnitude),
+            .rebase_count(lanes_rebase_count), .glitch_count(lanes_glitch_count)
+        );
+
+    end else begin : no_perturb
+
+        assign perturb_issue_ready    = 1'b0;
+        assign perturb_out_valid      = 1'b0;
+        assign perturb_out_tag        = '0;
+        assign perturb_out_iterations = '0;
+        assign perturb_out_magnitude  = '0;
+        assign rebase_count           = '0;
+        assign glitch_count           = '0;
+
+    end
+    endgenerate
+
+endmodule
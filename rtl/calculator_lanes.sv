@@ -0,0 +1,163 @@
+module calculator_lanes #(
+    parameter LANES      = 4,
+    parameter DATA_WIDTH = 32,
+    parameter FRAC_WIDTH = 28,
+    parameter TAG_WIDTH  = 4,
+    parameter SQUARE_KERNEL = "MULT3"   // See mandelbrot_calculator
+)(
+    input                           clk,
+    input                           rst,
+
+    // A pixel is accepted when in_valid && in_ready
+    input                           in_valid,
+    output logic                    in_ready,
+    input      [DATA_WIDTH-1:0]     in_c_re,
+    input      [DATA_WIDTH-1:0]     in_c_im,
+    input      [DATA_WIDTH-1:0]     in_z0_re,
+    input      [DATA_WIDTH-1:0]     in_z0_im,
+    input      [TAG_WIDTH-1:0]      in_tag,
+
+    // Parameters from AXI-Lite
+    input      [31:0]               max_iter,
+    input                           period_en,
+    input      [31:0]               period_eps,
+
+    // Finished pixels. A lane holds its result until it is accepted.
+    output logic                    out_valid,
+    input                           out_ready,
+    output logic [TAG_WIDTH-1:0]    out_tag,
+    output logic [31:0]             out_iterations,
+    output logic [31:0]             out_magnitude   // Final |z|^2, Q4.28
+);
+
+    localparam LANE_W = $clog2(LANES+1);
+
+    localparam LANE_IDLE    = 2'd0;
+    localparam LANE_COMPUTE = 2'd1;
+    localparam LANE_DONE    = 2'd2;
+
+    // Per-lane state. c is latched at issue because the calculator
+    // reads it on every iteration, not only on start.
+    reg [1:0]            lane_state [LANES-1:0];
+    reg [DATA_WIDTH-1:0] lane_c_re  [LANES-1:0];
+    reg [DATA_WIDTH-1:0] lane_c_im  [LANES-1:0];
+    reg [TAG_WIDTH-1:0]  lane_tag   [LANES-1:0];
+
+    wire [LANES-1:0]    lane_ready;
+    wire [31:0]         lane_iterations [LANES-1:0];
+    wire [31:0]         lane_magnitude  [LANES-1:0];
+    logic [LANES-1:0]   lane_start;
+
+    // -- Dispatcher: hand the next pixel to the lowest-numbered idle lane --
+    logic              free_found;
+    logic [LANE_W-1:0] free_lane;
+
+    always_comb begin
+        free_found = 1'b0;
+        free_lane  = '0;
+        for (int i = LANES - 1; i >= 0; i--) begin
+            if (lane_state[i] == LANE_IDLE) begin
+                free_found = 1'b1;
+                free_lane  = i[LANE_W-1:0];
+            end
+        end
+        lane_start = '0;
+        if (in_valid && free_found) begin
+            lane_start[free_lane] = 1'b1;
+        end
+    end
+
+    assign in_ready = free_found;
+
+    // -- Collector: offer one finished lane per cycle, round-robin --
+    reg  [LANE_W-1:0]  rr_next;
+    logic              done_found;
+    logic [LANE_W-1:0] done_lane;
+
+    always_comb begin
+        done_found = 1'b0;
+        done_lane  = '0;
+        for (int k = 0; k < LANES; k++) begin
+            int idx;
+            idx = (int'(rr_next) + k) % LANES;
+            if (!done_found && lane_state[idx] == LANE_DONE) begin
+                done_found = 1'b1;
+                done_lane  = idx[LANE_W-1:0];
+            end
+        end
+    end
+
+    wire done_taken = done_found && out_ready;
+
+    assign out_valid      = done_found;
+    assign out_tag        = lane_tag[done_lane];
+    assign out_iterations = lane_iterations[done_lane];
+    assign out_magnitude  = lane_magnitude[done_lane];
+
+    always_ff @(posedge clk) begin
+        if (rst) begin
+            for (int i = 0; i < LANES; i++) begin
+                lane_state[i] <= LANE_IDLE;
+            end
+            rr_next <= '0;
+        end else begin
+            for (int i = 0; i < LANES; i++) begin
+                case (lane_state[i])
+                    LANE_IDLE: begin
+                        if (lane_start[i]) begin
+                            lane_c_re[i]  <= in_c_re;
+                            lane_c_im[i]  <= in_c_im;
+                            lane_tag[i]   <= in_tag;
+                            lane_state[i] <= LANE_COMPUTE;
+                        end
+                    end
+
+                    LANE_COMPUTE: begin
+                        // ready drops on the edge that consumed start, so a
+                        // high ready here always means the pixel is finished
+                        if (lane_ready[i]) begin
+                            lane_state[i] <= LANE_DONE;
+                        end
+                    end
+
+                    LANE_DONE: begin
+                        if (done_taken && done_lane == i[LANE_W-1:0]) begin
+                            lane_state[i] <= LANE_IDLE;
+                        end
+                    end
+
+                    default: lane_state[i] <= LANE_IDLE;
+                endcase
+            end
+
+            if (done_taken) begin
+                rr_next <= (done_lane == LANES - 1) ? '0 : done_lane + 1'b1;
+            end
+        end
+    end
+
+    // -- Lanes --
+    genvar l;
+    generate
+        for (l = 0; l < LANES; l++) begin : lane
+            mandelbrot_calculator #(
+                .DATA_WIDTH(DATA_WIDTH), .FRAC_WIDTH(FRAC_WIDTH),
+                .SQUARE_KERNEL(SQUARE_KERNEL)
+            ) mb_inst (
+                .clk(clk), .rst(rst),
+                .start(lane_start[l]),
+                .ready(lane_ready[l]),
+                // c is first used the cycle after start, by which point
+                // lane_c_* holds the issued value
+                .c_re(lane_c_re[l]), .c_im(lane_c_im[l]),
+                // z0 is only read on start, straight from the issue port
+                .z0_re(in_z0_re), .z0_im(in_z0_im),
+                .max_iter(max_iter),
+                .period_en(period_en), .period_eps(period_eps),
+                .iterations(lane_iterations[l]),
+                .magnitude(lane_magnitude[l])
+            );
+        end
+    endgenerate
+
+endmodule
@@ -0,0 +1,56 @@
+module cardioid_check #(
+    parameter DATA_WIDTH = 32,
+    parameter FRAC_WIDTH = 28,
+    // Shrinks both regions by this many LSBs of the comparisons below, for
+    // a c that has been rounded before it gets here
+    parameter MARGIN     = 0
+)(
+    // Point to test, signed fixed point with FRAC_WIDTH fractional bits
+    input      [DATA_WIDTH-1:0] c_re,
+    input      [DATA_WIDTH-1:0] c_im,
+
+    // c lies inside the main cardioid or the period-2 bulb
+    output logic            inside
+);
+
+    localparam FRAC = FRAC_WIDTH;
+    localparam W    = DATA_WIDTH + 8;   // Headroom for q(q + x) below
+
+    localparam signed [W-1:0] QUARTER   = W'(1) <<< (FRAC - 2);  // 1/4
+    localparam signed [W-1:0] ONE       = W'(1) <<< FRAC;        // 1
+    localparam signed [W-1:0] SIXTEENTH = W'(1) <<< (FRAC - 4);  // 1/16
+    localparam signed [W-1:0] TWO       = W'(2) <<< FRAC;
+    localparam signed [W-1:0] GUARD     = W'(MARGIN);
+
+    wire signed [W-1:0] x = W'($signed(c_re));
+    wire signed [W-1:0] y = W'($signed(c_im));
+
+    // Both regions lie well inside |re|, |im| < 2; outside that window the
+    // products below could overflow, so the test simply reports no hit.
+    wire in_window = (x > -TWO) && (x < TWO) && (y > -TWO) && (y < TWO);
+
+    // Main cardioid: q = (x - 1/4)^2 + y^2,  inside if q(q + (x - 1/4)) < y^2/4
+    wire signed [W-1:0] xm = x - QUARTER;
+    wire signed [2*W-1:0] xm_sq_full = xm * xm;
+    wire signed [2*W-1:0] y_sq_full  = y * y;
+    wire signed [W-1:0] xm_sq = W'(xm_sq_full >>> FRAC);
+    wire signed [W-1:0] y_sq  = W'(y_sq_full >>> FRAC);
+    wire signed [W-1:0] q     = xm_sq + y_sq;
+
+    wire signed [W-1:0] q_plus_xm = q + xm;
+    wire signed [2*W-1:0] lhs_full  = q * q_plus_xm;
+    wire signed [W-1:0] lhs       = W'(lhs_full >>> FRAC);
+    wire signed [W-1:0] rhs       = y_sq >>> 2;
+
+    wire in_cardioid = (lhs + GUARD < rhs);
+
+    // Period-2 bulb: (x + 1)^2 + y^2 < 1/16
+    wire signed [W-1:0] xp = x + ONE;
+    wire signed [2*W-1:0] xp_sq_full = xp * xp;
+    wire signed [W-1:0] xp_sq = W'(xp_sq_full >>> FRAC);
+
+    wire in_bulb = (xp_sq + y_sq + GUARD < SIXTEENTH);
+
+    assign inside = in_window && (in_cardioid || in_bulb);
+
+endmodule
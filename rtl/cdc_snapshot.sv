@@ -0,0 +1,59 @@
+// Multi-bit clock crossing for slowly changing values such as counters.
+// The source side holds a copy of data_in and flips req; the destination
+// copies the held word when the toggle arrives and flips ack back, and only
+// then does the source take a new copy. The held word is stable whenever the
+// destination samples it, so every bit of data_out comes from the same
+// source cycle. data_out lags data_in by a few clocks of each side. Either
+// reset may be applied on its own; the two sides resynchronize afterwards.
+module cdc_snapshot #(
+    parameter WIDTH = 32
+)(
+    input                       src_clk,
+    input                       src_rst,
+    input      [WIDTH-1:0]      data_in,
+
+    input                       dest_clk,
+    input                       dest_rst,
+    output reg [WIDTH-1:0]      data_out
+);
+
+    reg [WIDTH-1:0] held;
+    reg             req = 0;    // src_clk domain toggle
+    reg             ack = 0;    // dest_clk domain toggle
+    wire            req_s, ack_s;
+
+    cdc_synchronizer #(.WIDTH(1)) sync_req (
+        .dest_clk(dest_clk),
+        .rst(dest_rst),
+        .data_in(req),
+        .data_out(req_s)
+    );
+
+    cdc_synchronizer #(.WIDTH(1)) sync_ack (
+        .dest_clk(src_clk),
+        .rst(src_rst),
+        .data_in(ack),
+        .data_out(ack_s)
+    );
+
+    always_ff @(posedge src_clk) begin
+        if (src_rst) begin
+            held <= '0;
+            req  <= 0;
+        end else if (ack_s == req) begin
+            held <= data_in;
+            req  <= !req;
+        end
+    end
+
+    always_ff @(posedge dest_clk) begin
+        if (dest_rst) begin
+            data_out <= '0;
+            ack      <= 0;
+        end else if (req_s != ack) begin
+            data_out <= held;
+            ack      <= req_s;
+        end
+    end
+
+endmodule
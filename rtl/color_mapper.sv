@@ -1,14 +1,51 @@
-module color_mapper (
+module color_mapper #(
+    // Palette RAM: two banks of 2^PALETTE_AWIDTH RGB entries
+    parameter PALETTE_AWIDTH = 10
+)(
     input           clk,
     input [31:0]    iterations_in,
     input [31:0]    max_iter,
 
+    // With palette_en set, escaped points take entry
+    // ((iterations * palette_scale) >> 8) + palette_offset of palette_bank,
+    // wrapping at the bank size. palette_scale is unsigned Q8.8.
+    input           palette_en,
+    input           palette_bank,
+    input [15:0]    palette_scale,
+    input [PALETTE_AWIDTH-1:0] palette_offset,
+
+    // Palette write port, {bank, entry} addressed, in its own clock domain
+    input           palette_wclk,
+    input           palette_we,
+    input [PALETTE_AWIDTH:0] palette_waddr,
+    input [23:0]    palette_wdata,
+
     output logic [7:0] r,
     output logic [7:0] g,
     output logic [7:0] b
 );
     reg [7:0] r_reg, g_reg, b_reg;
 
+    // Block RAM with one write and one registered read port, so a lookup
+    // has the same one-cycle latency as the ramp below
+    reg [23:0] palette [0:(2 << PALETTE_AWIDTH)-1];
+    reg [23:0] palette_rgb;
+    reg        palette_hit;
+
+    wire [47:0] palette_scaled = iterations_in * palette_scale;
+    wire [PALETTE_AWIDTH-1:0] palette_index = palette_scaled[8+:PALETTE_AWIDTH] + palette_offset;
+
+    always_ff @(posedge palette_wclk) begin
+        if (palette_we) begin
+            palette[palette_waddr] <= palette_wdata;
+        end
+    end
+
+    always_ff @(posedge clk) begin
+        palette_rgb <= palette[{palette_bank, palette_index}];
+        palette_hit <= palette_en && (iterations_in < max_iter);
+    end
+
     // We can use a smaller stretch factor now that our cycle is more efficient.
     localparam STRETCH_FACTOR = 4;
 
@@ -59,8 +96,8 @@ module color_mapper (
         end
     end
 
-    assign r = r_reg;
-    assign g = g_reg;
-    assign b = b_reg;
+    assign r = palette_hit ? palette_rgb[23:16] : r_reg;
+    assign g = palette_hit ? palette_rgb[15:8]  : g_reg;
+    assign b = palette_hit ? palette_rgb[7:0]   : b_reg;
 
 endmodule
\ No newline at end of file
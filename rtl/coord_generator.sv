@@ -0,0 +1,38 @@
+module coord_generator #(
+    // Signed fixed point, as in screen_mapper
+    parameter DATA_WIDTH = 64,
+    parameter COORD_WIDTH = 11
+)(
+    // Pixel being issued, in whatever order the scheduler walks the frame
+    input [COORD_WIDTH-1:0]  x,
+    input [COORD_WIDTH-1:0]  y,
+
+    // c of pixel (0, 0), and how c moves from one pixel to the next along
+    // a line (dx) and from one line to the next (dy). Any affine view:
+    // dx = (step, 0), dy = (0, step) is the unrotated one, with +im
+    // pointing down the frame like screen_mapper.
+    input [DATA_WIDTH-1:0]   origin_re,
+    input [DATA_WIDTH-1:0]   origin_im,
+    input [DATA_WIDTH-1:0]   dx_re,
+    input [DATA_WIDTH-1:0]   dx_im,
+    input [DATA_WIDTH-1:0]   dy_re,
+    input [DATA_WIDTH-1:0]   dy_im,
+
+    output [DATA_WIDTH-1:0]  c_re,
+    output [DATA_WIDTH-1:0]  c_im
+);
+
+    // c = origin + x * dx + y * dy, wrapped to DATA_WIDTH bits. Nothing is
+    // carried from one pixel to the next, so the tile, progressive and pan
+    // schedulers can issue pixels in any order and a commit at pixel (0, 0)
+    // takes effect at once. Only the low DATA_WIDTH bits of each product
+    // are kept, where signed and unsigned agree, so each is a
+    // DATA_WIDTH x COORD_WIDTH multiply. Combinational like screen_mapper;
+    // calculator_array registers c in its issue stage.
+    wire [DATA_WIDTH-1:0] x_wide = DATA_WIDTH'(x);
+    wire [DATA_WIDTH-1:0] y_wide = DATA_WIDTH'(y);
+
+    assign c_re = origin_re + x_wide * dx_re + y_wide * dy_re;
+    assign c_im = origin_im + x_wide * dx_im + y_wide * dy_im;
+
+endmodule
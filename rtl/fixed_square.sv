@@ -0,0 +1,28 @@
+module fixed_square #(
+    // Signed input width, and the unsigned low slice split off for the
+    // partial products. 17 keeps every partial product inside one 25x18
+    // DSP48 for inputs up to 33 bits.
+    parameter WIDTH     = 32,
+    parameter LOW_WIDTH = 17
+)(
+    input      [WIDTH-1:0]      x,
+    output logic [2*WIDTH-1:0]  sq      // Exact x^2
+);
+
+    localparam HIGH_WIDTH = WIDTH - LOW_WIDTH;
+
+    // x = hi * 2^LOW_WIDTH + lo, with hi signed and lo unsigned, so
+    // x^2 = hi^2 * 2^(2 * LOW_WIDTH) + 2 * hi * lo * 2^LOW_WIDTH + lo^2.
+    // A general product would also need lo * hi a second time.
+    wire signed [HIGH_WIDTH-1:0] hi = x[WIDTH-1:LOW_WIDTH];
+    wire        [LOW_WIDTH-1:0]  lo = x[LOW_WIDTH-1:0];
+
+    wire signed [2*HIGH_WIDTH-1:0] hi_hi = hi * hi;
+    wire signed [WIDTH:0]          hi_lo = hi * $signed({1'b0, lo});
+    wire        [2*LOW_WIDTH-1:0]  lo_lo = lo * lo;
+
+    assign sq = ((2*WIDTH)'(hi_hi) << (2 * LOW_WIDTH)) +
+                ((2*WIDTH)'(hi_lo) << (LOW_WIDTH + 1)) +
+                (2*WIDTH)'(lo_lo);
+
+endmodule
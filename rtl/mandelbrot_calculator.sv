@@ -1,4 +1,17 @@
-module mandelbrot_calculator (
+module mandelbrot_calculator #(
+    // 1: one iteration per clock; the escape test runs alongside the z update.
+    // 0: the products are registered first, two clocks per iteration.
+    parameter SINGLE_CYCLE = 1,
+    // Signed fixed point: DATA_WIDTH bits with FRAC_WIDTH fractional bits
+    parameter DATA_WIDTH   = 32,
+    parameter FRAC_WIDTH   = 28,
+    // How z^2 is formed. Both give the same bits.
+    // "MULT3": re^2, im^2 and re*im as three general products.
+    // "LEAN":  re^2, im^2 and (re + im)^2 as three squarers, with
+    //          2*re*im = (re + im)^2 - re^2 - im^2. A squarer needs three
+    //          partial products where a general product needs four.
+    parameter SQUARE_KERNEL = "MULT3"
+)(
     input                   clk,
     input                   rst,
 
@@ -7,33 +20,66 @@ module mandelbrot_calculator (
     output logic            ready,
 
     // Parameters from AXI-Lite
-    input      [31:0]       c_re,
-    input      [31:0]       c_im,
+    input      [DATA_WIDTH-1:0] c_re,
+    input      [DATA_WIDTH-1:0] c_im,
+    input      [DATA_WIDTH-1:0] z0_re,      // Starting point, read on start:
+    input      [DATA_WIDTH-1:0] z0_im,      //   0 for Mandelbrot, the pixel for Julia
     input      [31:0]       max_iter,
+    input                   period_en,      // Bail out when the orbit revisits a snapshot
+    input      [31:0]       period_eps,     // Per-component match tolerance, in LSBs of z
 
     // Output
-    output logic [31:0]     iterations
+    output logic [31:0]     iterations,
+    output logic [31:0]     magnitude       // |z|^2 at the last escape test, Q4.28
 );
 
     // Internal registers
-    reg [31:0] z_re, z_im;
+    localparam PROD_WIDTH = 2 * DATA_WIDTH;
+    localparam PROD_MSB   = FRAC_WIDTH + DATA_WIDTH - 1;
+
+    reg [DATA_WIDTH-1:0] z_re, z_im;
     reg [31:0] iter_count;
 
+    // |z|^2 behind the final count, rescaled to Q4.28
+    reg [31:0] last_mag;
+
+    // Brent periodicity check: z is saved at iterations 0, 1, 2, 4, 8, ...
+    // and every later z is compared against the latest snapshot.
+    reg [DATA_WIDTH-1:0] saved_re, saved_im;
+
     // Pipeline registers for multiplication
-    reg [63:0] z_re_sq, z_im_sq, z_2ab;
-    reg [31:0] z_re_sq_reg, z_im_sq_reg, z_2ab_reg;
+    wire [PROD_WIDTH-1:0] z_re_sq, z_im_sq, z_2ab;
+    reg [DATA_WIDTH-1:0] z_re_sq_reg, z_im_sq_reg, z_2ab_reg;
     reg        cook;       // Master signal: calculation is in progress
-    reg        cook_state; // 0 = Calculate z^2; 1 = Calculate next z
+    reg        cook_state; // Two-cycle mode only: 0 = Calculate z^2; 1 = Calculate next z
     
-    localparam [31:0] ESCAPE_THRESHOLD = 32'h40000000;
+    // |z|^2 >= 4
+    localparam [DATA_WIDTH-1:0] ESCAPE_THRESHOLD = DATA_WIDTH'(4) << FRAC_WIDTH;
 
-    always_comb begin
-        z_re_sq = $signed(z_re) * $signed(z_re);
-        z_im_sq = $signed(z_im) * $signed(z_im);
-        z_2ab   = ($signed(z_re) * $signed(z_im)) << 1;
-    end
+    generate
+        if (SQUARE_KERNEL == "LEAN") begin : lean_kernel
+
+            // re + im needs one extra bit; its square is exact, so the
+            // difference is exactly 2*re*im before any truncation
+            wire [DATA_WIDTH:0]     z_sum = {z_re[DATA_WIDTH-1], z_re} + {z_im[DATA_WIDTH-1], z_im};
+            wire [2*DATA_WIDTH+1:0] z_sum_sq;
 
-    // Pipeline registers - Stage 1
+            fixed_square #(.WIDTH(DATA_WIDTH))   sq_re  (.x(z_re),  .sq(z_re_sq));
+            fixed_square #(.WIDTH(DATA_WIDTH))   sq_im  (.x(z_im),  .sq(z_im_sq));
+            fixed_square #(.WIDTH(DATA_WIDTH+1)) sq_sum (.x(z_sum), .sq(z_sum_sq));
+
+            assign z_2ab = PROD_WIDTH'(z_sum_sq) - z_re_sq - z_im_sq;
+
+        end else begin : mult3_kernel
+
+            assign z_re_sq = $signed(z_re) * $signed(z_re);
+            assign z_im_sq = $signed(z_im) * $signed(z_im);
+            assign z_2ab   = ($signed(z_re) * $signed(z_im)) << 1;
+
+        end
+    endgenerate
+
+    // Pipeline registers - Stage 1 (two-cycle mode)
     always_ff @(posedge clk) begin
         if (rst) begin
             z_re_sq_reg <= 0;
@@ -41,61 +87,98 @@ module mandelbrot_calculator (
             z_2ab_reg   <= 0;
         end else if (cook && !cook_state) begin
             // Latch pipeline values when entering calculation state
-            z_re_sq_reg <= z_re_sq[59:28];
-            z_im_sq_reg <= z_im_sq[59:28];
-            z_2ab_reg   <= z_2ab[59:28];
+            z_re_sq_reg <= z_re_sq[PROD_MSB:FRAC_WIDTH];
+            z_im_sq_reg <= z_im_sq[PROD_MSB:FRAC_WIDTH];
+            z_2ab_reg   <= z_2ab[PROD_MSB:FRAC_WIDTH];
         end
     end
 
+    wire [DATA_WIDTH-1:0] re_sq  = SINGLE_CYCLE ? z_re_sq[PROD_MSB:FRAC_WIDTH] : z_re_sq_reg;
+    wire [DATA_WIDTH-1:0] im_sq  = SINGLE_CYCLE ? z_im_sq[PROD_MSB:FRAC_WIDTH] : z_im_sq_reg;
+    wire [DATA_WIDTH-1:0] two_ab = SINGLE_CYCLE ? z_2ab[PROD_MSB:FRAC_WIDTH]   : z_2ab_reg;
+
+    // The squares of z_n give both z_(n+1) and |z_n|^2. The original
+    // two-phase loop tested |z_n|^2 at the start of iteration n + 1, so an
+    // escape seen here is reported as n + 1 to keep the same counts.
+    wire [DATA_WIDTH-1:0] z_mag     = re_sq + im_sq;
+    wire [31:0] next_iter = iter_count + 1;
+    wire        escaped   = (z_mag >= ESCAPE_THRESHOLD);
+
+    // |z|^2 in Q4.28. Wider formats can escape with |z|^2 of 16 or more,
+    // which saturates rather than wrapping back below the threshold.
+    wire [DATA_WIDTH-1:0] mag_scaled = z_mag >> (FRAC_WIDTH - 28);
+    wire [31:0] mag_q4_28 = (mag_scaled > DATA_WIDTH'(32'hFFFFFFFF)) ? 32'hFFFFFFFF : 32'(mag_scaled);
+
+    wire [DATA_WIDTH-1:0] diff_re = z_re - saved_re;
+    wire [DATA_WIDTH-1:0] diff_im = z_im - saved_im;
+    wire [DATA_WIDTH-1:0] dist_re = diff_re[DATA_WIDTH-1] ? -diff_re : diff_re;
+    wire [DATA_WIDTH-1:0] dist_im = diff_im[DATA_WIDTH-1] ? -diff_im : diff_im;
+    wire        periodic  = period_en && (iter_count != 0) &&
+                            (dist_re <= DATA_WIDTH'(period_eps)) && (dist_im <= DATA_WIDTH'(period_eps));
+    wire        snapshot  = ((iter_count & (iter_count - 1)) == 0);
+
     // Main calculation logic - Stage 2
     always_ff @(posedge clk) begin
         if (rst) begin
             z_re <= 0;
             z_im <= 0;
             iter_count <= 0;
+            last_mag <= 0;
+            saved_re <= 0;
+            saved_im <= 0;
             cook <= 0;
             cook_state <= 0;
             ready <= 1;
         end else begin
             if (start && ready) begin
-                // Start a new calculation with z0 = 0
-                z_re <= 0;
-                z_im <= 0;
+                // Start a new calculation from z0
+                z_re <= z0_re;
+                z_im <= z0_im;
                 iter_count <= 0;
+                last_mag <= 0;
+                saved_re <= z0_re;
+                saved_im <= z0_im;
                 cook <= 1;
-                cook_state <= 0; // Start with calculating z^2
+                cook_state <= 0;
                 ready <= 0;
             end else if (cook) begin
-                if (!cook_state) begin
-                    // PHASE 0: Check if we should terminate before calculating next z
+                if (!SINGLE_CYCLE && !cook_state) begin
+                    // Products of the current z are latched this cycle
+                    cook_state <= 1;
+                end else begin
+                    cook_state <= 0;
                     if (iter_count >= max_iter) begin
-                        // Max iterations reached
+                        // Max iterations reached before the first step
                         cook <= 0;
                         ready <= 1;
                     end else begin
-                        // Check escape condition using current z
-                        // For the very first iteration (iter_count == 0), z is still 0
-                        if (iter_count > 0 && (z_re_sq_reg + z_im_sq_reg >= ESCAPE_THRESHOLD)) begin
-                            // Escaped
+                        iter_count <= next_iter;
+                        last_mag <= mag_q4_28;
+                        if (next_iter >= max_iter || escaped) begin
+                            cook <= 0;
+                            ready <= 1;
+                        end else if (periodic) begin
+                            // z_n is back at an earlier value, so the orbit is
+                            // a cycle that will never escape
+                            iter_count <= max_iter;
                             cook <= 0;
                             ready <= 1;
                         end else begin
-                            // Continue to calculate next z
-                            cook_state <= 1;
+                            // z_new = z^2 + c
+                            z_re <= $signed(re_sq) - $signed(im_sq) + $signed(c_re);
+                            z_im <= $signed(two_ab) + $signed(c_im);
+                            if (snapshot) begin
+                                saved_re <= z_re;
+                                saved_im <= z_im;
+                            end
                         end
                     end
-                end else begin
-                    // PHASE 1: Calculate next z using pipeline registers
-                    // z_new = z^2 + c
-                    z_re <= $signed(z_re_sq_reg) - $signed(z_im_sq_reg) + $signed(c_re);
-                    z_im <= $signed(z_2ab_reg) + $signed(c_im);
-                    iter_count <= iter_count + 1;
-                    cook_state <= 0; // Go back to phase 0 for next iteration
                 end
             end
         end
     end
 
     assign iterations = iter_count;
+    assign magnitude  = last_mag;
 
 endmodule
@@ -0,0 +1,157 @@
+module mandelbrot_calculator_barrel #(
+    // Register stages behind the multipliers. The ring holds one pixel
+    // context per stage: MULT_STAGES + 2 contexts in flight.
+    parameter MULT_STAGES = 3,
+    parameter TAG_WIDTH   = 4
+)(
+    input                           clk,
+    input                           rst,
+
+    // New pixels enter when a context leaves the ring
+    input                           in_valid,
+    output logic                    in_ready,
+    input      [31:0]               in_c_re,
+    input      [31:0]               in_c_im,
+    input      [31:0]               in_z0_re,   // Starting point: 0, or the pixel for Julia
+    input      [31:0]               in_z0_im,
+    input      [TAG_WIDTH-1:0]      in_tag,
+
+    // Parameters from AXI-Lite
+    input      [31:0]               max_iter,
+
+    // Finished pixels. A result that is not accepted keeps circulating.
+    output logic                    out_valid,
+    input                           out_ready,
+    output logic [TAG_WIDTH-1:0]    out_tag,
+    output logic [31:0]             out_iterations,
+    output logic [31:0]             out_magnitude   // Final |z|^2, Q4.28
+);
+
+    localparam CONTEXTS  = MULT_STAGES + 2;
+    localparam CTX_WIDTH = $clog2(CONTEXTS);
+
+    localparam [31:0] ESCAPE_THRESHOLD = 32'h40000000;
+
+    // -- Context register file: per-pixel values that do not change while
+    // the context iterates. A context keeps its id for its whole life in the
+    // ring, so the id travels with the token and indexes this file.
+    reg [31:0]          ctx_c_re [CONTEXTS-1:0];
+    reg [31:0]          ctx_c_im [CONTEXTS-1:0];
+    reg [TAG_WIDTH-1:0] ctx_tag  [CONTEXTS-1:0];
+    // |z|^2 of a finished context that is still circulating; its z is
+    // no longer carried round the ring
+    reg [31:0]          ctx_mag  [CONTEXTS-1:0];
+
+    // -- Stage 0: multiplier operands --
+    reg                 op_valid, op_finished;
+    reg [CTX_WIDTH-1:0] op_ctx;
+    reg [31:0]          op_z_re, op_z_im, op_iter;
+
+    // -- Multiplier pipeline --
+    reg                 mul_valid    [MULT_STAGES-1:0];
+    reg                 mul_finished [MULT_STAGES-1:0];
+    reg [CTX_WIDTH-1:0] mul_ctx      [MULT_STAGES-1:0];
+    reg [31:0]          mul_iter     [MULT_STAGES-1:0];
+    reg [63:0]          mul_re_sq    [MULT_STAGES-1:0];
+    reg [63:0]          mul_im_sq    [MULT_STAGES-1:0];
+    reg [63:0]          mul_2ab      [MULT_STAGES-1:0];
+
+    // -- Add stage: Q4.28 slices and |z|^2 --
+    reg                 add_valid, add_finished;
+    reg [CTX_WIDTH-1:0] add_ctx;
+    reg [31:0]          add_iter;
+    reg [31:0]          add_re_sq, add_im_sq, add_2ab, add_mag;
+
+    // -- Ring exit: z_(n+1) and the escape test on |z_n|^2 are evaluated
+    // together. The single-cycle calculator tests |z_n|^2 at iteration
+    // n + 1, so an exit here reports n + 1.
+    wire [31:0] next_z_re = add_re_sq - add_im_sq + ctx_c_re[add_ctx];
+    wire [31:0] next_z_im = add_2ab + ctx_c_im[add_ctx];
+    wire [31:0] next_iter = add_iter + 1;
+
+    wire        at_limit  = (add_iter >= max_iter);
+    wire        exit_now  = add_finished || at_limit ||
+                            (next_iter >= max_iter) || (add_mag >= ESCAPE_THRESHOLD);
+    wire [31:0] exit_iter = (add_finished || at_limit) ? add_iter : next_iter;
+    wire [31:0] exit_mag  = add_finished ? ctx_mag[add_ctx] :
+                            at_limit     ? 32'h0 : add_mag;
+
+    assign out_valid      = add_valid && exit_now;
+    assign out_tag        = ctx_tag[add_ctx];
+    assign out_iterations = exit_iter;
+    assign out_magnitude  = exit_mag;
+
+    // The slot is free when the leaving context is a bubble or retires
+    assign in_ready = !add_valid || (out_valid && out_ready);
+
+    always_ff @(posedge clk) begin
+        if (rst) begin
+            op_valid    <= 1'b0;
+            op_finished <= 1'b0;
+            op_ctx      <= '0;
+            for (int s = 0; s < MULT_STAGES; s++) begin
+                mul_valid[s] <= 1'b0;
+                mul_ctx[s]   <= CTX_WIDTH'(s + 1);
+            end
+            add_valid <= 1'b0;
+            add_ctx   <= CTX_WIDTH'(CONTEXTS - 1);
+        end else begin
+            // Ring exit -> stage 0
+            op_ctx <= add_ctx;
+            if (in_ready) begin
+                op_valid    <= in_valid;
+                op_finished <= 1'b0;
+                op_z_re     <= in_z0_re;
+                op_z_im     <= in_z0_im;
+                op_iter     <= '0;
+                if (in_valid) begin
+                    ctx_c_re[add_ctx] <= in_c_re;
+                    ctx_c_im[add_ctx] <= in_c_im;
+                    ctx_tag[add_ctx]  <= in_tag;
+                end
+            end else if (exit_now) begin
+                // Finished but not accepted: freeze and go round again
+                op_valid    <= 1'b1;
+                op_finished <= 1'b1;
+                op_iter     <= exit_iter;
+                ctx_mag[add_ctx] <= exit_mag;
+            end else begin
+                op_valid    <= 1'b1;
+                op_finished <= 1'b0;
+                op_z_re     <= next_z_re;
+                op_z_im     <= next_z_im;
+                op_iter     <= next_iter;
+            end
+
+            // Stage 0 -> multipliers
+            mul_valid[0]    <= op_valid;
+            mul_finished[0] <= op_finished;
+            mul_ctx[0]      <= op_ctx;
+            mul_iter[0]     <= op_iter;
+            mul_re_sq[0]    <= $signed(op_z_re) * $signed(op_z_re);
+            mul_im_sq[0]    <= $signed(op_z_im) * $signed(op_z_im);
+            mul_2ab[0]      <= ($signed(op_z_re) * $signed(op_z_im)) << 1;
+
+            for (int s = 1; s < MULT_STAGES; s++) begin
+                mul_valid[s]    <= mul_valid[s-1];
+                mul_finished[s] <= mul_finished[s-1];
+                mul_ctx[s]      <= mul_ctx[s-1];
+                mul_iter[s]     <= mul_iter[s-1];
+                mul_re_sq[s]    <= mul_re_sq[s-1];
+                mul_im_sq[s]    <= mul_im_sq[s-1];
+                mul_2ab[s]      <= mul_2ab[s-1];
+            end
+
+            // Multipliers -> add stage
+            add_valid    <= mul_valid[MULT_STAGES-1];
+            add_finished <= mul_finished[MULT_STAGES-1];
+            add_ctx      <= mul_ctx[MULT_STAGES-1];
+            add_iter     <= mul_iter[MULT_STAGES-1];
+            add_re_sq    <= mul_re_sq[MULT_STAGES-1][59:28];
+            add_im_sq    <= mul_im_sq[MULT_STAGES-1][59:28];
+            add_2ab      <= mul_2ab[MULT_STAGES-1][59:28];
+            add_mag      <= mul_re_sq[MULT_STAGES-1][59:28] + mul_im_sq[MULT_STAGES-1][59:28];
+        end
+    end
+
+endmodule
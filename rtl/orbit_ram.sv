@@ -0,0 +1,31 @@
+module orbit_ram #(
+    parameter WIDTH  = 80,
+    parameter DEPTH  = 2048,
+    localparam AWIDTH = $clog2(DEPTH)
+)(
+    // Write port (AXI-Lite clock)
+    input                   wclk,
+    input                   we,
+    input      [AWIDTH-1:0] waddr,
+    input      [WIDTH-1:0]  wdata,
+
+    // Read port (pixel clock), one cycle latency
+    input                   rclk,
+    input      [AWIDTH-1:0] raddr,
+    output logic [WIDTH-1:0] rdata
+);
+
+    // Simple dual-port, independent clocks: maps onto block RAM
+    reg [WIDTH-1:0] mem [DEPTH-1:0];
+
+    always_ff @(posedge wclk) begin
+        if (we) begin
+            mem[waddr] <= wdata;
+        end
+    end
+
+    always_ff @(posedge rclk) begin
+        rdata <= mem[raddr];
+    end
+
+endmodule
@@ -4,6 +4,18 @@ module packer(
 
     // Pixel data input
     input [7:0]     r, g, b,
+
+    // Extended mode: send the raw iteration count and final |z|^2 (Q4.28)
+    // as two beats instead of one RGB beat
+    input           ext,
+    input [31:0]    iterations,
+    input [31:0]    magnitude,
+
+    // Raw mode: pack the iteration counts of two pixels, saturated to 16
+    // bits, into one beat, the first pixel in the low half. A line with an
+    // odd number of pixels ends on a beat with an empty high half. Takes
+    // priority over ext.
+    input           raw,
     
     // Control signals from main FSM
     input           valid,          // Input pixel is valid
@@ -22,16 +34,27 @@ module packer(
 
     localparam [1:0] STATE_IDLE = 2'b00;
     localparam [1:0] STATE_SEND = 2'b01;
+    localparam [1:0] STATE_SEND_MAG = 2'b10;
 
     reg [1:0] state_reg, state_next;
     
-    reg [23:0] data_to_send;
+    reg [31:0] data_to_send;
+    reg [31:0] mag_to_send;
+    reg        ext_to_send;
     reg        last_to_send;
     reg        user_to_send;
 
+    // Raw mode: the first pixel of a pair waits here for the second
+    reg [15:0] half_to_send;
+    reg        half_user;
+    reg        half_valid;
+
     wire input_fire  = valid && in_stream_ready;
     wire output_fire = out_stream_tvalid && out_stream_tready;
 
+    wire [15:0] raw_count = (iterations > 32'hFFFF) ? 16'hFFFF : iterations[15:0];
+    wire        raw_hold  = raw && !half_valid && !eol;
+
     always_comb begin
         state_next = state_reg;
         in_stream_ready = 1'b0;
@@ -40,12 +63,19 @@ module packer(
         case(state_reg)
             STATE_IDLE: begin
                 in_stream_ready = 1'b1;
-                if (input_fire) begin
+                if (input_fire && !raw_hold) begin
                     state_next = STATE_SEND;
                 end
             end
             
             STATE_SEND: begin
+                out_stream_tvalid = 1'b1;
+                if (output_fire) begin
+                    state_next = ext_to_send ? STATE_SEND_MAG : STATE_IDLE;
+                end
+            end
+
+            STATE_SEND_MAG: begin
                 out_stream_tvalid = 1'b1;
                 if (output_fire) begin
                     state_next = STATE_IDLE;
@@ -57,16 +87,29 @@ module packer(
     always_ff @(posedge aclk) begin
         if (!aresetn) begin
             state_reg <= STATE_IDLE;
-            data_to_send <= 24'b0;
+            data_to_send <= 32'b0;
+            mag_to_send <= 32'b0;
+            ext_to_send <= 1'b0;
             last_to_send <= 1'b0;
             user_to_send <= 1'b0;
+            half_to_send <= 16'b0;
+            half_user <= 1'b0;
+            half_valid <= 1'b0;
         end else begin
             state_reg <= state_next;
             
-            if (input_fire) begin
-                data_to_send <= {r, g, b};
+            if (input_fire && raw_hold) begin
+                half_to_send <= raw_count;
+                half_user <= sof;
+                half_valid <= 1'b1;
+            end else if (input_fire) begin
+                data_to_send <= raw ? (half_valid ? {raw_count, half_to_send} : {16'h0, raw_count}) :
+                                ext ? iterations : {8'h00, r, g, b};
+                mag_to_send <= magnitude;
+                ext_to_send <= ext && !raw;
                 last_to_send <= eol;
-                user_to_send <= sof;
+                user_to_send <= (raw && half_valid) ? half_user : sof;
+                half_valid <= 1'b0;
             end
         end
     end
@@ -81,9 +124,12 @@ module packer(
     // end
 
     // Assign outputs
-    assign out_stream_tdata = {8'h00, data_to_send};
+    // In extended mode TUSER marks the first beat and TLAST the second
+    wire second_beat = (state_reg == STATE_SEND_MAG);
+
+    assign out_stream_tdata = second_beat ? mag_to_send : data_to_send;
     assign out_stream_tkeep = 4'hF;
-    assign out_stream_tlast = last_to_send;
-    assign out_stream_tuser = user_to_send;
+    assign out_stream_tlast = last_to_send && (second_beat || !ext_to_send);
+    assign out_stream_tuser = user_to_send && !second_beat;
 
 endmodule
@@ -0,0 +1,423 @@
+module pan_scheduler #(
+    parameter X_SIZE    = 640,
+    parameter Y_SIZE    = 480,
+    parameter ROB_DEPTH = 16,
+    // Longest AXI4 burst, in 32-bit beats
+    parameter BURST     = 16,
+    localparam TAG_WIDTH = $clog2(ROB_DEPTH)
+)(
+    input                           clk,
+    input                           rst,
+
+    // Selected as the frame scheduler. While it is not, the iteration
+    // buffer is taken to be stale.
+    input                           active,
+    // The next frame is the first after a commit and uses shift_x/y
+    input                           restart,
+    // Read the overlap with the last frame back instead of computing it
+    input                           reuse,
+    // The view is symmetric about the real axis: rows below the centre row
+    // are copied from their mirror image above it. Sampled at (0, 0).
+    input                           mirror,
+    // New pixel (x, y) shows old pixel (x + shift_x, y + shift_y). A shift
+    // of a whole frame or more recomputes every pixel.
+    input      [15:0]               shift_x,
+    input      [15:0]               shift_y,
+    // Two frames of iteration counts from here, 4 bytes per pixel
+    input      [31:0]               buffer_base,
+
+    // Issue side, same handshake as raster_scheduler
+    output logic                    issue_valid,
+    input                           issue_ready,
+    output logic [9:0]              issue_x,
+    output logic [9:0]              issue_y,
+    output logic [TAG_WIDTH-1:0]    issue_tag,
+    output logic                    issue_first,
+
+    // Results coming back from the calculators, in any order
+    input                           result_valid,
+    input      [TAG_WIDTH-1:0]      result_tag,
+    input      [31:0]               result_iterations,
+
+    // In-order pixel stream
+    output logic                    out_valid,
+    input                           out_ready,
+    output logic [31:0]             out_iterations,
+    output logic                    out_sof,
+    output logic                    out_eol,
+
+    // No pixel is being computed, streamed or written back
+    output logic                    idle,
+
+    // One pulse per pixel read back instead of computed
+    output logic                    copy_valid,
+
+    // AXI4 master for the iteration buffer
+    output logic [31:0]             m_axi_awaddr,
+    output logic [7:0]              m_axi_awlen,
+    output logic                    m_axi_awvalid,
+    input                           m_axi_awready,
+    output logic [31:0]             m_axi_wdata,
+    output logic                    m_axi_wlast,
+    output logic                    m_axi_wvalid,
+    input                           m_axi_wready,
+    input                           m_axi_bvalid,
+    output logic                    m_axi_bready,
+    output logic [31:0]             m_axi_araddr,
+    output logic [7:0]              m_axi_arlen,
+    output logic                    m_axi_arvalid,
+    input                           m_axi_arready,
+    input      [31:0]               m_axi_rdata,
+    input                           m_axi_rvalid,
+    output logic                    m_axi_rready
+);
+
+    // Every streamed frame is also written to one of two frame buffers in
+    // DDR. The next frame reads the overlap with its predecessor back from
+    // the other one and only issues the pixels that were off screen. Each
+    // row is built in a row buffer: first the uncovered pixels are computed,
+    // then the covered span is read in bursts. It is streamed and written
+    // back from there while the next row is built in the other buffer.
+    //
+    // Pixel (0, 0) is always computed, so the frame start and the commit
+    // handshake work as for the other schedulers.
+    //
+    // In a mirrored frame the rows below CENTER are read back whole from the
+    // frame being written, from the row as far above CENTER. The first of
+    // them waits until the rows above have reached DDR.
+
+    localparam FRAME_BYTES = X_SIZE * Y_SIZE * 4;
+    localparam FIFO_DEPTH  = 2 * BURST;
+    localparam FIFO_AWIDTH = $clog2(FIFO_DEPTH);
+    localparam COUNT_WIDTH = FIFO_AWIDTH + 1;
+    localparam BEAT_WIDTH  = $clog2(BURST + 1);
+    localparam CENTER      = Y_SIZE / 2;
+
+    localparam [2:0] S_START = 3'd0;   // Wait for the last frame to be written
+    localparam [2:0] S_ISSUE = 3'd1;   // Issue the uncovered pixels of the row
+    localparam [2:0] S_WAIT  = 3'd2;   // Wait for their results
+    localparam [2:0] S_COPY  = 3'd3;   // Read the covered span back
+    localparam [2:0] S_ROW   = 3'd4;   // Hand the row to the output side
+
+    reg [2:0]               state;
+    reg [9:0]               row;
+    reg [9:0]               walk_x;
+
+    // -- Frame geometry --
+    reg                     prev_valid;     // The read buffer holds the last frame
+    reg                     fresh;          // Next frame is the first after a commit
+    reg                     frame_reuse;
+    reg                     frame_mirror;
+    reg signed [16:0]       frame_dx, frame_dy;
+    reg                     write_sel;      // Buffer this frame is written to
+
+    wire signed [16:0]      dx = frame_dx;
+    wire signed [16:0]      src_y = $signed({7'b0, row}) + frame_dy;
+    wire signed [16:0]      span_lo = (dx < 0) ? -dx : 17'sd0;
+    wire signed [16:0]      span_hi = (dx > 0) ? 17'(X_SIZE) - dx : 17'(X_SIZE);
+    wire                    row_mirrored = frame_mirror && (row > 10'(CENTER));
+    wire                    row_covered = row_mirrored ||
+                                          (frame_reuse && (src_y >= 0) && (src_y < 17'(Y_SIZE)) &&
+                                           (span_lo < span_hi));
+    // Covered pixels of this row are [copy_lo, copy_hi), without (0, 0)
+    wire [9:0]              copy_hi = row_mirrored ? 10'(X_SIZE) : span_hi[9:0];
+    wire [9:0]              copy_lo = row_mirrored ? 10'd0 :
+                                      (row == 0 && span_lo == 0) ? 10'd1 : span_lo[9:0];
+    wire                    walk_covered = row_covered && (walk_x >= copy_lo) && (walk_x < copy_hi);
+    wire [9:0]              walk_next = walk_covered ? copy_hi : walk_x + 1'b1;
+
+    // -- Tags --
+    reg [ROB_DEPTH-1:0]     tag_busy;
+    reg [9:0]               tag_x [ROB_DEPTH-1:0];
+    logic [TAG_WIDTH-1:0]   free_tag;
+    logic                   free_any;
+
+    always_comb begin
+        free_tag = '0;
+        free_any = 1'b0;
+        for (int t = ROB_DEPTH - 1; t >= 0; t--) begin
+            if (!tag_busy[t]) begin
+                free_tag = TAG_WIDTH'(t);
+                free_any = 1'b1;
+            end
+        end
+    end
+
+    assign issue_valid = (state == S_ISSUE) && !walk_covered && free_any;
+    assign issue_x     = walk_x;
+    assign issue_y     = row;
+    assign issue_tag   = free_tag;
+    assign issue_first = (state == S_ISSUE) && (row == 0) && (walk_x == 0);
+
+    wire issue_fire = issue_valid && issue_ready;
+    wire frame_fire = issue_fire && issue_first;
+
+    // -- Read side --
+    reg [31:0]              ar_addr;
+    reg [9:0]               ar_left, r_left;
+    reg [9:0]               copy_x;
+
+    wire [10:0]             words_to_4k = 11'd1024 - 11'(ar_addr[11:2]);
+    wire [10:0]             ar_beats = (11'(ar_left) < words_to_4k) ?
+                                       ((ar_left < 10'(BURST)) ? 11'(ar_left) : 11'(BURST)) :
+                                       ((words_to_4k < 11'(BURST)) ? words_to_4k : 11'(BURST));
+
+    assign m_axi_araddr  = ar_addr;
+    assign m_axi_arlen   = 8'(ar_beats - 1'b1);
+    assign m_axi_arvalid = (state == S_COPY) && (ar_left != 0);
+    assign m_axi_rready  = (state == S_COPY);
+
+    wire r_fire = m_axi_rvalid && m_axi_rready;
+    assign copy_valid = r_fire;
+
+    // -- Row buffers --
+    reg                     compute_bank, emit_bank;
+    reg                     emit_active, emit_primed;
+    reg [9:0]               emit_row, emit_x;
+
+    wire                    emit_row_end = (emit_x == 10'(X_SIZE - 1));
+    wire                    retire_fire = out_valid && out_ready;
+    wire [9:0]              read_x = !retire_fire ? emit_x : (emit_row_end ? 10'd0 : emit_x + 1'b1);
+
+    wire                    row_we = result_valid || r_fire;
+    wire [9:0]              row_waddr = (state == S_COPY) ? copy_x : tag_x[result_tag];
+    wire [31:0]             row_wdata = (state == S_COPY) ? m_axi_rdata : result_iterations;
+    wire [31:0]             row_q [1:0];
+
+    genvar b;
+    generate
+        for (b = 0; b < 2; b++) begin : row_buffer
+            reg [31:0] mem [X_SIZE-1:0];
+            reg [31:0] q;
+
+            always_ff @(posedge clk) begin
+                if (row_we && compute_bank == 1'(b)) begin
+                    mem[row_waddr] <= row_wdata;
+                end
+                q <= mem[read_x];
+            end
+
+            assign row_q[b] = q;
+        end
+    endgenerate
+
+    // -- Write side --
+    // Streamed pixels queue here and leave in BURST-beat bursts. A frame is
+    // a whole number of bursts, so the queue is empty between frames.
+    reg [31:0]              fifo [FIFO_DEPTH-1:0];
+    reg [COUNT_WIDTH-1:0]   fifo_count;
+    reg [FIFO_AWIDTH-1:0]   fifo_head, fifo_tail;
+    reg [31:0]              aw_addr;
+    reg                     w_active;
+    reg [BEAT_WIDTH-1:0]    w_beat;
+    reg [7:0]               b_pending;
+
+    wire                    fifo_full = (fifo_count == COUNT_WIDTH'(FIFO_DEPTH));
+    wire                    aw_fire = m_axi_awvalid && m_axi_awready;
+    wire                    w_fire = m_axi_wvalid && m_axi_wready;
+    wire                    write_idle = (fifo_count == 0) && !w_active && (b_pending == 0);
+
+    // Mirror source rows must be in DDR before they are read
+    wire                    mirror_ready = (row != 10'(CENTER + 1)) || (!emit_active && write_idle);
+
+    assign m_axi_awaddr  = aw_addr;
+    assign m_axi_awlen   = 8'(BURST - 1);
+    assign m_axi_awvalid = !w_active && (fifo_count >= COUNT_WIDTH'(BURST));
+    assign m_axi_wdata   = fifo[fifo_head];
+    assign m_axi_wlast   = (w_beat == BEAT_WIDTH'(BURST - 1));
+    assign m_axi_wvalid  = w_active;
+    assign m_axi_bready  = 1'b1;
+
+    always_ff @(posedge clk) begin
+        if (retire_fire) begin
+            fifo[fifo_tail] <= out_iterations;
+        end
+    end
+
+    always_ff @(posedge clk) begin
+        if (rst) begin
+            fifo_count <= '0;
+            fifo_head  <= '0;
+            fifo_tail  <= '0;
+            w_active   <= 1'b0;
+            w_beat     <= '0;
+            b_pending  <= '0;
+        end else begin
+            fifo_count <= fifo_count + (retire_fire ? 1'b1 : 1'b0) - (w_fire ? 1'b1 : 1'b0);
+            if (retire_fire) begin
+                fifo_tail <= fifo_tail + 1'b1;
+            end
+            if (w_fire) begin
+                fifo_head <= fifo_head + 1'b1;
+                w_beat <= w_beat + 1'b1;
+                if (m_axi_wlast) begin
+                    w_active <= 1'b0;
+                    w_beat <= '0;
+                end
+            end
+            if (aw_fire) begin
+                w_active <= 1'b1;
+            end
+            b_pending <= b_pending + (aw_fire ? 1'b1 : 1'b0) - (m_axi_bvalid ? 1'b1 : 1'b0);
+        end
+    end
+
+    // -- Output side --
+    assign out_valid      = emit_active && emit_primed && !fifo_full;
+    assign out_iterations = row_q[emit_bank];
+    assign out_sof        = (emit_row == 0) && (emit_x == 0);
+    assign out_eol        = emit_row_end;
+
+    assign idle = (tag_busy == 0) && !emit_active && write_idle;
+
+    always_ff @(posedge clk) begin
+        if (rst) begin
+            emit_active <= 1'b0;
+            emit_primed <= 1'b0;
+            emit_bank   <= 1'b1;
+            emit_row    <= '0;
+            emit_x      <= '0;
+        end else if (state == S_ROW && !emit_active) begin
+            emit_active <= 1'b1;
+            emit_primed <= 1'b0;
+            emit_bank   <= compute_bank;
+            emit_row    <= row;
+            emit_x      <= '0;
+        end else if (emit_active) begin
+            emit_primed <= 1'b1;
+            if (retire_fire) begin
+                emit_x <= emit_row_end ? 10'd0 : emit_x + 1'b1;
+                if (emit_row_end) begin
+                    emit_active <= 1'b0;
+                    emit_primed <= 1'b0;
+                end
+            end
+        end
+    end
+
+    // -- Compute side --
+    always_ff @(posedge clk) begin
+        if (rst) begin
+            state        <= S_START;
+            row          <= '0;
+            walk_x       <= '0;
+            tag_busy     <= '0;
+            compute_bank <= 1'b0;
+            prev_valid   <= 1'b0;
+            fresh        <= 1'b1;
+            frame_reuse  <= 1'b0;
+            frame_mirror <= 1'b0;
+            frame_dx     <= '0;
+            frame_dy     <= '0;
+            write_sel    <= 1'b1;
+            aw_addr      <= '0;
+            ar_addr      <= '0;
+            ar_left      <= '0;
+            r_left       <= '0;
+            copy_x       <= '0;
+        end else begin
+            if (issue_fire) begin
+                tag_x[free_tag] <= walk_x;
+            end
+            tag_busy <= (tag_busy | (issue_fire ? ROB_DEPTH'(1) << free_tag : '0)) &
+                        ~(result_valid ? ROB_DEPTH'(1) << result_tag : '0);
+
+            if (aw_fire) begin
+                aw_addr <= aw_addr + 32'(BURST * 4);
+            end
+
+            case (state)
+                // The previous frame must be in DDR before it is read back
+                S_START: begin
+                    if (!emit_active && write_idle) begin
+                        state <= S_ISSUE;
+                    end
+                end
+
+                S_ISSUE: begin
+                    // The geometry of a frame is fixed when (0, 0) issues
+                    if (frame_fire) begin
+                        frame_reuse <= prev_valid && reuse;
+                        frame_mirror <= mirror;
+                        frame_dx    <= fresh ? $signed({shift_x[15], shift_x}) : 17'sd0;
+                        frame_dy    <= fresh ? $signed({shift_y[15], shift_y}) : 17'sd0;
+                        fresh       <= 1'b0;
+                        write_sel   <= !write_sel;
+                        aw_addr     <= buffer_base + (write_sel ? 32'd0 : 32'(FRAME_BYTES));
+                    end
+                    if (issue_fire || walk_covered) begin
+                        walk_x <= walk_next;
+                        if (walk_next == 10'(X_SIZE)) begin
+                            state <= S_WAIT;
+                        end
+                    end
+                end
+
+                S_WAIT: begin
+                    if (tag_busy == 0) begin
+                        if (row_mirrored) begin
+                            // Read from the buffer this frame goes to
+                            if (mirror_ready) begin
+                                ar_addr <= buffer_base + (write_sel ? 32'(FRAME_BYTES) : 32'd0) +
+                                           32'((32'(2 * CENTER) - 32'(row)) * X_SIZE * 4);
+                                ar_left <= 10'(X_SIZE);
+                                r_left  <= 10'(X_SIZE);
+                                copy_x  <= '0;
+                                state   <= S_COPY;
+                            end
+                        end else if (row_covered) begin
+                            // Read from the buffer the last frame went to
+                            ar_addr <= buffer_base + (write_sel ? 32'd0 : 32'(FRAME_BYTES)) +
+                                       32'(((32'(src_y) * X_SIZE) + 32'(copy_lo) + 32'(dx)) * 4);
+                            ar_left <= copy_hi - copy_lo;
+                            r_left  <= copy_hi - copy_lo;
+                            copy_x  <= copy_lo;
+                            state   <= S_COPY;
+                        end else begin
+                            state <= S_ROW;
+                        end
+                    end
+                end
+
+                S_COPY: begin
+                    if (m_axi_arvalid && m_axi_arready) begin
+                        ar_addr <= ar_addr + 32'({ar_beats, 2'b00});
+                        ar_left <= ar_left - 10'(ar_beats);
+                    end
+                    if (r_fire) begin
+                        copy_x <= copy_x + 1'b1;
+                        r_left <= r_left - 1'b1;
+                        if (r_left == 1) begin
+                            state <= S_ROW;
+                        end
+                    end
+                end
+
+                S_ROW: begin
+                    if (!emit_active) begin
+                        compute_bank <= !compute_bank;
+                        walk_x <= '0;
+                        if (row == 10'(Y_SIZE - 1)) begin
+                            row <= '0;
+                            prev_valid <= 1'b1;
+                            state <= S_START;
+                        end else begin
+                            row <= row + 1'b1;
+                            state <= S_ISSUE;
+                        end
+                    end
+                end
+
+                default: state <= S_START;
+            endcase
+
+            if (restart) begin
+                fresh <= 1'b1;
+            end
+            if (!active) begin
+                prev_valid <= 1'b0;
+            end
+        end
+    end
+
+endmodule
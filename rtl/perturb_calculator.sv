@@ -0,0 +1,188 @@
+module perturb_calculator #(
+    parameter ORBIT_AWIDTH = 11
+)(
+    input                           clk,
+    input                           rst,
+
+    // Control signals
+    input                           start,
+    output logic                    ready,
+
+    // Pixel offset from the reference point, normalized: (re + i*im) * 2^exp
+    input      [31:0]               dc_re,
+    input      [31:0]               dc_im,
+    input      [15:0]               dc_exp,
+
+    // Parameters from AXI-Lite
+    input      [31:0]               max_iter,
+    input      [31:0]               ref_len,    // Valid reference orbit entries, at least 2
+
+    // Reference orbit. orbit_addr is registered by the RAM, so Z arrives
+    // the cycle after its index is presented.
+    output logic [ORBIT_AWIDTH-1:0] orbit_addr,
+    input      [31:0]               orbit_re,
+    input      [31:0]               orbit_im,
+    input      [15:0]               orbit_exp,
+
+    // Output
+    output logic [31:0]             iterations,
+    output logic [31:0]             magnitude,  // |z|^2 at the last escape test, Q4.28
+    output logic                    rebase,     // Restarted the reference orbit this cycle
+    output logic                    glitch      // ... because |z| fell below |dz|
+);
+
+    // Per-pixel state: z_n = Z_m + dz, with the delta held as a pair of
+    // mantissas sharing one exponent
+    reg [31:0] iter_count;
+    reg [31:0] last_mag;
+    reg [31:0] ref_index;
+    reg [31:0] dz_re, dz_im;
+    reg [15:0] dz_exp;
+    reg        cook;
+
+    // -- z_n = Z_m + dz --
+    wire [31:0] z_re, z_im;
+    wire [15:0] z_exp;
+
+    perturb_normalize z_sum (
+        .a_re(34'($signed(orbit_re))), .a_im(34'($signed(orbit_im))), .a_exp(18'($signed(orbit_exp))),
+        .b_re(34'($signed(dz_re))),    .b_im(34'($signed(dz_im))),    .b_exp(18'($signed(dz_exp))),
+        .c_re(34'd0), .c_im(34'd0), .c_exp(18'($signed(-16'sd16384))),
+        .re(z_re), .im(z_im), .exp(z_exp)
+    );
+
+    // -- Squared magnitudes, as mantissa * 2^(2 * exp) --
+    wire signed [63:0] z_re_sq  = $signed(z_re) * $signed(z_re);
+    wire signed [63:0] z_im_sq  = $signed(z_im) * $signed(z_im);
+    wire signed [63:0] dz_re_sq = $signed(dz_re) * $signed(dz_re);
+    wire signed [63:0] dz_im_sq = $signed(dz_im) * $signed(dz_im);
+
+    wire [63:0] z_mag  = z_re_sq + z_im_sq;
+    wire [63:0] dz_mag = dz_re_sq + dz_im_sq;
+
+    // Escape: |z|^2 >= 4  <=>  z_mag >= 2^(2 - 2 * z_exp)
+    wire signed [17:0] escape_shift = 18'sd2 - (18'($signed(z_exp)) <<< 1);
+    wire escaped = (escape_shift <= 0)  ? (z_mag != 0) :
+                   (escape_shift > 63)  ? 1'b0 :
+                   (z_mag >= (64'd1 << escape_shift[5:0]));
+
+    // The same |z|^2 in Q4.28, z_mag * 2^(2 * z_exp + 28), saturating at
+    // 32 bits. A left shift is never needed: non-zero magnitudes are at
+    // least 2^58, so any shift below 26 already saturates.
+    wire signed [17:0] mag_shift  = escape_shift - 18'sd30;
+    wire [63:0] mag_scaled = z_mag >> mag_shift[5:0];
+    wire [31:0] mag_q4_28 = (mag_shift > 63)          ? 32'h0 :
+                            (mag_shift < 0)           ? ((z_mag != 0) ? 32'hFFFFFFFF : 32'h0) :
+                            (mag_scaled[63:32] != 0)  ? 32'hFFFFFFFF :
+                                                        mag_scaled[31:0];
+
+    // Glitch: |z| < |dz|. Non-zero magnitudes lie in [2^58, 2^62), so an
+    // exponent gap of two or more decides the comparison on its own.
+    wire signed [16:0] exp_gap = 17'($signed(z_exp)) - 17'($signed(dz_exp));
+    wire [65:0] z_mag_ext  = 66'(z_mag);
+    wire [65:0] dz_mag_ext = 66'(dz_mag);
+    wire below = (exp_gap >= 2)  ? 1'b0 :
+                 (exp_gap <= -2) ? 1'b1 :
+                 (exp_gap == 1)  ? ((z_mag_ext << 2) < dz_mag_ext) :
+                 (exp_gap == -1) ? (z_mag_ext < (dz_mag_ext << 2)) :
+                                   (z_mag_ext < dz_mag_ext);
+
+    wire out_of_orbit = (ref_index + 1 >= ref_len);
+    wire need_rebase  = (ref_index != 0) && (below || out_of_orbit);
+
+    // -- dz' = 2 Z dz + dz^2 + dc --
+    wire signed [63:0] zr_dr = $signed(orbit_re) * $signed(dz_re);
+    wire signed [63:0] zi_di = $signed(orbit_im) * $signed(dz_im);
+    wire signed [63:0] zr_di = $signed(orbit_re) * $signed(dz_im);
+    wire signed [63:0] zi_dr = $signed(orbit_im) * $signed(dz_re);
+    wire signed [63:0] dr_di = $signed(dz_re) * $signed(dz_im);
+
+    wire signed [63:0] lin_re = zr_dr - zi_di;
+    wire signed [63:0] lin_im = zr_di + zi_dr;
+    wire signed [63:0] sq_re  = dz_re_sq - dz_im_sq;
+
+    wire [31:0] next_dz_re, next_dz_im;
+    wire [15:0] next_dz_exp;
+
+    perturb_normalize dz_sum (
+        .a_re(34'(lin_re >>> 30)), .a_im(34'(lin_im >>> 30)),
+        .a_exp(18'($signed(orbit_exp)) + 18'($signed(dz_exp)) + 18'sd31),
+        .b_re(34'(sq_re >>> 30)),  .b_im(34'(dr_di >>> 29)),
+        .b_exp((18'($signed(dz_exp)) <<< 1) + 18'sd30),
+        .c_re(34'($signed(dc_re))), .c_im(34'($signed(dc_im))), .c_exp(18'($signed(dc_exp))),
+        .re(next_dz_re), .im(next_dz_im), .exp(next_dz_exp)
+    );
+
+    wire [31:0] next_iter = iter_count + 1;
+    wire        finishing = (iter_count >= max_iter) || (next_iter >= max_iter) || escaped;
+    wire        rebasing  = !finishing && need_rebase;
+
+    // Index of the Z needed next cycle
+    always_comb begin
+        if (!cook || rebasing) begin
+            orbit_addr = '0;
+        end else begin
+            orbit_addr = ORBIT_AWIDTH'(ref_index + 1);
+        end
+    end
+
+    always_ff @(posedge clk) begin
+        if (rst) begin
+            iter_count <= 0;
+            last_mag <= 0;
+            ref_index <= 0;
+            dz_re <= 0;
+            dz_im <= 0;
+            dz_exp <= -16'sd16384;
+            cook <= 0;
+            ready <= 1;
+            rebase <= 0;
+            glitch <= 0;
+        end else begin
+            rebase <= 0;
+            glitch <= 0;
+            if (start && ready) begin
+                // z_0 = 0: Z_0 = 0 and no delta yet
+                iter_count <= 0;
+                last_mag <= 0;
+                ref_index <= 0;
+                dz_re <= 0;
+                dz_im <= 0;
+                dz_exp <= -16'sd16384;
+                cook <= 1;
+                ready <= 0;
+            end else if (cook) begin
+                if (iter_count >= max_iter) begin
+                    cook <= 0;
+                    ready <= 1;
+                end else if (finishing) begin
+                    // Same counting as mandelbrot_calculator: an escape
+                    // seen on z_n is reported as n + 1
+                    iter_count <= next_iter;
+                    last_mag <= mag_q4_28;
+                    cook <= 0;
+                    ready <= 1;
+                end else if (rebasing) begin
+                    // Carry the full z as the new delta and restart the
+                    // reference orbit; the iteration count does not move
+                    dz_re <= z_re;
+                    dz_im <= z_im;
+                    dz_exp <= z_exp;
+                    ref_index <= 0;
+                    rebase <= 1;
+                    glitch <= below;
+                end else begin
+                    dz_re <= next_dz_re;
+                    dz_im <= next_dz_im;
+                    dz_exp <= next_dz_exp;
+                    ref_index <= ref_index + 1;
+                    iter_count <= next_iter;
+                end
+            end
+        end
+    end
+
+    assign iterations = iter_count;
+    assign magnitude  = last_mag;
+
+endmodule
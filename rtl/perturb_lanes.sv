@@ -0,0 +1,206 @@
+module perturb_lanes #(
+    parameter LANES       = 4,
+    parameter ORBIT_DEPTH = 2048,
+    parameter TAG_WIDTH   = 4,
+    localparam ORBIT_AWIDTH = $clog2(ORBIT_DEPTH),
+    localparam LANE_W = $clog2(LANES+1)
+)(
+    input                           clk,
+    input                           rst,
+
+    // A pixel is accepted when in_valid && in_ready. Its offset from the
+    // reference point is (in_dc_re + i*in_dc_im) * 2^in_dc_exp.
+    input                           in_valid,
+    output logic                    in_ready,
+    input      [15:0]               in_dc_re,
+    input      [15:0]               in_dc_im,
+    input      [15:0]               in_dc_exp,
+    input      [TAG_WIDTH-1:0]      in_tag,
+
+    // Parameters from AXI-Lite
+    input      [31:0]               max_iter,
+    input      [31:0]               ref_len,
+
+    // Reference orbit load port, shared by every lane's copy
+    input                           orbit_wclk,
+    input                           orbit_we,
+    input      [ORBIT_AWIDTH-1:0]   orbit_waddr,
+    input      [79:0]               orbit_wdata,    // {exp[15:0], im[31:0], re[31:0]}
+
+    // Finished pixels. A lane holds its result until it is accepted.
+    output logic                    out_valid,
+    input                           out_ready,
+    output logic [TAG_WIDTH-1:0]    out_tag,
+    output logic [31:0]             out_iterations,
+    output logic [31:0]             out_magnitude,  // Final |z|^2, Q4.28
+
+    // Lanes that rebased / hit a glitch this cycle
+    output logic [LANE_W-1:0]       rebase_count,
+    output logic [LANE_W-1:0]       glitch_count
+);
+
+    localparam LANE_IDLE    = 2'd0;
+    localparam LANE_COMPUTE = 2'd1;
+    localparam LANE_DONE    = 2'd2;
+
+    // Per-lane state. dc is latched at issue because the calculator
+    // reads it on every iteration, not only on start.
+    reg [1:0]            lane_state  [LANES-1:0];
+    reg [31:0]           lane_dc_re  [LANES-1:0];
+    reg [31:0]           lane_dc_im  [LANES-1:0];
+    reg [15:0]           lane_dc_exp [LANES-1:0];
+    reg [TAG_WIDTH-1:0]  lane_tag    [LANES-1:0];
+
+    wire [LANES-1:0]    lane_ready;
+    wire [31:0]         lane_iterations [LANES-1:0];
+    wire [31:0]         lane_magnitude  [LANES-1:0];
+    logic [LANES-1:0]   lane_start;
+    wire [LANES-1:0]    lane_rebase, lane_glitch;
+
+    // The calculator reads at most ORBIT_DEPTH entries
+    wire [31:0] ref_len_limited = (ref_len > ORBIT_DEPTH) ? 32'(ORBIT_DEPTH) : ref_len;
+
+    // -- dc is normalized once here rather than in every lane --
+    wire [31:0] dc_re_norm, dc_im_norm;
+    wire [15:0] dc_exp_norm;
+
+    perturb_normalize dc_norm (
+        .a_re(34'($signed(in_dc_re))), .a_im(34'($signed(in_dc_im))), .a_exp(18'($signed(in_dc_exp))),
+        .b_re(34'd0), .b_im(34'd0), .b_exp(18'($signed(-16'sd16384))),
+        .c_re(34'd0), .c_im(34'd0), .c_exp(18'($signed(-16'sd16384))),
+        .re(dc_re_norm), .im(dc_im_norm), .exp(dc_exp_norm)
+    );
+
+    // -- Dispatcher: hand the next pixel to the lowest-numbered idle lane --
+    logic              free_found;
+    logic [LANE_W-1:0] free_lane;
+
+    always_comb begin
+        free_found = 1'b0;
+        free_lane  = '0;
+        for (int i = LANES - 1; i >= 0; i--) begin
+            if (lane_state[i] == LANE_IDLE) begin
+                free_found = 1'b1;
+                free_lane  = i[LANE_W-1:0];
+            end
+        end
+        lane_start = '0;
+        if (in_valid && free_found) begin
+            lane_start[free_lane] = 1'b1;
+        end
+    end
+
+    assign in_ready = free_found;
+
+    // -- Collector: offer one finished lane per cycle, round-robin --
+    reg  [LANE_W-1:0]  rr_next;
+    logic              done_found;
+    logic [LANE_W-1:0] done_lane;
+
+    always_comb begin
+        done_found = 1'b0;
+        done_lane  = '0;
+        for (int k = 0; k < LANES; k++) begin
+            int idx;
+            idx = (int'(rr_next) + k) % LANES;
+            if (!done_found && lane_state[idx] == LANE_DONE) begin
+                done_found = 1'b1;
+                done_lane  = idx[LANE_W-1:0];
+            end
+        end
+    end
+
+    wire done_taken = done_found && out_ready;
+
+    assign out_valid      = done_found;
+    assign out_tag        = lane_tag[done_lane];
+    assign out_iterations = lane_iterations[done_lane];
+    assign out_magnitude  = lane_magnitude[done_lane];
+
+    always_ff @(posedge clk) begin
+        if (rst) begin
+            for (int i = 0; i < LANES; i++) begin
+                lane_state[i] <= LANE_IDLE;
+            end
+            rr_next <= '0;
+        end else begin
+            for (int i = 0; i < LANES; i++) begin
+                case (lane_state[i])
+                    LANE_IDLE: begin
+                        if (lane_start[i]) begin
+                            lane_dc_re[i]  <= dc_re_norm;
+                            lane_dc_im[i]  <= dc_im_norm;
+                            lane_dc_exp[i] <= dc_exp_norm;
+                            lane_tag[i]    <= in_tag;
+                            lane_state[i] <= LANE_COMPUTE;
+                        end
+                    end
+
+                    LANE_COMPUTE: begin
+                        // ready drops on the edge that consumed start, so a
+                        // high ready here always means the pixel is finished
+                        if (lane_ready[i]) begin
+                            lane_state[i] <= LANE_DONE;
+                        end
+                    end
+
+                    LANE_DONE: begin
+                        if (done_taken && done_lane == i[LANE_W-1:0]) begin
+                            lane_state[i] <= LANE_IDLE;
+                        end
+                    end
+
+                    default: lane_state[i] <= LANE_IDLE;
+                endcase
+            end
+
+            if (done_taken) begin
+                rr_next <= (done_lane == LANES - 1) ? '0 : done_lane + 1'b1;
+            end
+        end
+    end
+
+    always_comb begin
+        rebase_count = '0;
+        glitch_count = '0;
+        for (int i = 0; i < LANES; i++) begin
+            rebase_count = rebase_count + LANE_W'(lane_rebase[i]);
+            glitch_count = glitch_count + LANE_W'(lane_glitch[i]);
+        end
+    end
+
+    // -- Lanes, each with its own copy of the reference orbit --
+    genvar l;
+    generate
+        for (l = 0; l < LANES; l++) begin : lane
+            wire [ORBIT_AWIDTH-1:0] orbit_raddr;
+            wire [79:0]             orbit_rdata;
+
+            orbit_ram #(
+                .WIDTH(80), .DEPTH(ORBIT_DEPTH)
+            ) orbit_inst (
+                .wclk(orbit_wclk), .we(orbit_we), .waddr(orbit_waddr), .wdata(orbit_wdata),
+                .rclk(clk), .raddr(orbit_raddr), .rdata(orbit_rdata)
+            );
+
+            perturb_calculator #(
+                .ORBIT_AWIDTH(ORBIT_AWIDTH)
+            ) pc_inst (
+                .clk(clk), .rst(rst),
+                .start(lane_start[l]),
+                .ready(lane_ready[l]),
+                // dc is first used the cycle after start, by which point
+                // lane_dc_* holds the issued value
+                .dc_re(lane_dc_re[l]), .dc_im(lane_dc_im[l]), .dc_exp(lane_dc_exp[l]),
+                .max_iter(max_iter),
+                .ref_len(ref_len_limited),
+                .orbit_addr(orbit_raddr),
+                .orbit_re(orbit_rdata[31:0]), .orbit_im(orbit_rdata[63:32]), .orbit_exp(orbit_rdata[79:64]),
+                .iterations(lane_iterations[l]),
+                .magnitude(lane_magnitude[l]),
+                .rebase(lane_rebase[l]), .glitch(lane_glitch[l])
+            );
+        end
+    endgenerate
+
+endmodule
@@ -0,0 +1,75 @@
+module perturb_normalize #(
+    parameter TERM_WIDTH = 34,  // Input mantissa width, signed
+    parameter EXP_WIDTH  = 18   // Input exponent width, signed
+)(
+    // Three complex terms, each worth (re + i*im) * 2^exp
+    input      [TERM_WIDTH-1:0] a_re,
+    input      [TERM_WIDTH-1:0] a_im,
+    input      [EXP_WIDTH-1:0]  a_exp,
+    input      [TERM_WIDTH-1:0] b_re,
+    input      [TERM_WIDTH-1:0] b_im,
+    input      [EXP_WIDTH-1:0]  b_exp,
+    input      [TERM_WIDTH-1:0] c_re,
+    input      [TERM_WIDTH-1:0] c_im,
+    input      [EXP_WIDTH-1:0]  c_exp,
+
+    // Sum, scaled so the larger component has its top bit at NORM.
+    // A zero sum comes out as 0 * 2^EXP_ZERO.
+    output logic [31:0]         re,
+    output logic [31:0]         im,
+    output logic [15:0]         exp
+);
+
+    localparam NORM      = 29;
+    localparam SUM_WIDTH = TERM_WIDTH + 2;
+
+    localparam signed [15:0] EXP_ZERO = -16'sd16384;
+
+    wire signed [EXP_WIDTH-1:0] ea = $signed(a_exp);
+    wire signed [EXP_WIDTH-1:0] eb = $signed(b_exp);
+    wire signed [EXP_WIDTH-1:0] ec = $signed(c_exp);
+
+    // -- Align every term to the largest exponent --
+    wire signed [EXP_WIDTH-1:0] emax_ab = (ea > eb) ? ea : eb;
+    wire signed [EXP_WIDTH-1:0] emax    = (emax_ab > ec) ? emax_ab : ec;
+
+    // emax is never below a term's exponent, so the differences are >= 0.
+    // Anything shifted 63 or more places is just its sign.
+    wire [EXP_WIDTH-1:0] da = emax - ea;
+    wire [EXP_WIDTH-1:0] db = emax - eb;
+    wire [EXP_WIDTH-1:0] dc = emax - ec;
+
+    wire [5:0] sa = (da > 63) ? 6'd63 : da[5:0];
+    wire [5:0] sb = (db > 63) ? 6'd63 : db[5:0];
+    wire [5:0] sc = (dc > 63) ? 6'd63 : dc[5:0];
+
+    wire signed [SUM_WIDTH-1:0] sum_re = (SUM_WIDTH'($signed(a_re)) >>> sa) +
+                                         (SUM_WIDTH'($signed(b_re)) >>> sb) +
+                                         (SUM_WIDTH'($signed(c_re)) >>> sc);
+    wire signed [SUM_WIDTH-1:0] sum_im = (SUM_WIDTH'($signed(a_im)) >>> sa) +
+                                         (SUM_WIDTH'($signed(b_im)) >>> sb) +
+                                         (SUM_WIDTH'($signed(c_im)) >>> sc);
+
+    // -- Renormalize on the leading bit of the larger magnitude --
+    wire [SUM_WIDTH-1:0] abs_re = sum_re[SUM_WIDTH-1] ? -sum_re : sum_re;
+    wire [SUM_WIDTH-1:0] abs_im = sum_im[SUM_WIDTH-1] ? -sum_im : sum_im;
+    wire [SUM_WIDTH-1:0] mag    = abs_re | abs_im;
+
+    logic [5:0] lead;
+    always_comb begin
+        lead = '0;
+        for (int i = 0; i < SUM_WIDTH; i++) begin
+            if (mag[i]) lead = i[5:0];
+        end
+    end
+
+    wire signed [SUM_WIDTH-1:0] norm_re = (lead > NORM) ? (sum_re >>> (lead - NORM)) : (sum_re <<< (NORM - lead));
+    wire signed [SUM_WIDTH-1:0] norm_im = (lead > NORM) ? (sum_im >>> (lead - NORM)) : (sum_im <<< (NORM - lead));
+
+    wire is_zero = (mag == 0);
+
+    assign re  = is_zero ? 32'h0 : norm_re[31:0];
+    assign im  = is_zero ? 32'h0 : norm_im[31:0];
+    assign exp = is_zero ? EXP_ZERO : 16'(emax + EXP_WIDTH'(lead) - EXP_WIDTH'(NORM));
+
+endmodule
@@ -1,5 +1,6 @@
 module pixel_generator(
     input           out_stream_aclk,
+    input           compute_aclk,
     input           s_axi_lite_aclk,
     input           axi_resetn,
     input           periph_resetn,
@@ -32,15 +33,183 @@ module pixel_generator(
 
     input  [31:0]   s_axi_lite_wdata,
     output          s_axi_lite_wready,
-    input           s_axi_lite_wvalid
+    input           s_axi_lite_wvalid,
+
+    //AXI4 M, iteration buffer in DDR (compute_aclk domain)
+    output [31:0]   m_axi_ibuf_awaddr,
+    output [7:0]    m_axi_ibuf_awlen,
+    output [2:0]    m_axi_ibuf_awsize,
+    output [1:0]    m_axi_ibuf_awburst,
+    output [3:0]    m_axi_ibuf_awcache,
+    output [2:0]    m_axi_ibuf_awprot,
+    output          m_axi_ibuf_awvalid,
+    input           m_axi_ibuf_awready,
+
+    output [31:0]   m_axi_ibuf_wdata,
+    output [3:0]    m_axi_ibuf_wstrb,
+    output          m_axi_ibuf_wlast,
+    output          m_axi_ibuf_wvalid,
+    input           m_axi_ibuf_wready,
+
+    input  [1:0]    m_axi_ibuf_bresp,
+    input           m_axi_ibuf_bvalid,
+    output          m_axi_ibuf_bready,
+
+    output [31:0]   m_axi_ibuf_araddr,
+    output [7:0]    m_axi_ibuf_arlen,
+    output [2:0]    m_axi_ibuf_arsize,
+    output [1:0]    m_axi_ibuf_arburst,
+    output [3:0]    m_axi_ibuf_arcache,
+    output [2:0]    m_axi_ibuf_arprot,
+    output          m_axi_ibuf_arvalid,
+    input           m_axi_ibuf_arready,
+
+    input  [31:0]   m_axi_ibuf_rdata,
+    input  [1:0]    m_axi_ibuf_rresp,
+    input           m_axi_ibuf_rlast,
+    input           m_axi_ibuf_rvalid,
+    output          m_axi_ibuf_rready
 
 );
 
+// Largest frame the raster path can stream; WIDTH/HEIGHT pick the frame
+// size at run time. The tile, progressive and pan engines keep buffers for
+// the native 640x480 frame only and are bypassed at any other size.
+parameter  MAX_WIDTH = 1920;
+parameter  MAX_HEIGHT = 1080;
+localparam COORD_WIDTH = $clog2(MAX_WIDTH > MAX_HEIGHT ? MAX_WIDTH : MAX_HEIGHT);
 localparam X_SIZE = 640;
 localparam Y_SIZE = 480;
-parameter  REG_FILE_SIZE = 8;
+parameter  REG_FILE_SIZE = 32;
 localparam REG_FILE_AWIDTH = $clog2(REG_FILE_SIZE);
-parameter  AXI_LITE_ADDR_WIDTH = 8;
+parameter  AXI_LITE_ADDR_WIDTH = 14;
+
+// Read-only status registers live at byte offset STATUS_BASE and up
+localparam STATUS_BASE = 'h80;
+parameter  STATUS_SIZE = 32;
+localparam STATUS_AWIDTH = $clog2(STATUS_SIZE);
+
+// CTRL register (0x10) bits
+localparam CTRL_CARDIOID_EN = 0;
+localparam CTRL_PERIOD_EN   = 1;
+localparam CTRL_WIDE_EN     = 2;
+localparam CTRL_PERTURB_EN  = 3;
+localparam CTRL_EXT_STREAM  = 4;
+localparam CTRL_JULIA_EN    = 5;
+localparam CTRL_TILE_EN     = 6;
+localparam CTRL_PROGRESSIVE_EN = 7;
+localparam CTRL_PAN_REUSE_EN = 8;
+localparam CTRL_MIRROR_EN   = 9;
+localparam CTRL_RAW_STREAM  = 10;
+localparam CTRL_SCALE_EN    = 11;
+
+// Reference orbit load port: ORBIT_INDEX counts 32-bit words, four per
+// entry (re, im, exp, unused). Each ORBIT_DATA write fills the word at
+// ORBIT_INDEX and advances it; the exp word commits the entry.
+localparam REG_ORBIT_INDEX = 13;
+localparam REG_ORBIT_DATA  = 14;
+
+// Writing COMMIT hands the parameter registers to the pixel domain as one
+// bank; reading it returns 1 until they have been applied.
+localparam REG_COMMIT = 15;
+
+// Incremental pan: PAN_SHIFT holds the shift of the committed view against
+// the last one in whole pixels, x in [15:0] and y in [31:16]. IBUF_ADDR is
+// the DDR address of the two-frame iteration buffer. A shift only goes with
+// the COMMIT that follows its write; any other commit carries
+// PAN_SHIFT_NONE, which no frame overlaps.
+localparam REG_PAN_SHIFT = 16;
+localparam REG_IBUF_ADDR = 17;
+localparam PAN_SHIFT_NONE = 32'h80008000;
+
+// Frame size in pixels, applied by COMMIT like the view registers
+localparam REG_WIDTH  = 18;
+localparam REG_HEIGHT = 19;
+
+// Affine view: with CTRL_SCALE_EN set, c of pixel (0, 0) and the steps
+// along a line (DX) and down the frame (DY) come from these Q8.56
+// registers (LO word first) instead of PAN and ZOOM, and coord_generator
+// maps every issued pixel to c
+localparam REG_ORIGIN_RE = 20;
+localparam REG_ORIGIN_IM = 22;
+localparam REG_DX_RE     = 24;
+localparam REG_DX_IM     = 26;
+localparam REG_DY_RE     = 28;
+localparam REG_DY_IM     = 30;
+
+// Palette RAM: PALETTE_DEPTH RGB entries per bank, two banks. The host
+// loads the back bank through the write-only window at PALETTE_BASE
+// ({8'h00, r, g, b} per word) and swaps banks with PALETTE_SWAP.
+// PALETTE_MAP is {enable, 5'b0, offset[9:0], scale[15:0]}; colour_mapper
+// looks up entry ((iterations * scale) >> 8) + offset, modulo the depth.
+localparam PALETTE_DEPTH = 1024;
+localparam PALETTE_AWIDTH = $clog2(PALETTE_DEPTH);
+localparam PALETTE_MAP  = 'h800;
+localparam PALETTE_SWAP = 'h804;
+localparam PALETTE_BASE = 'h1000;
+
+// Iteration histogram: HIST_BINS counts of the escaped pixels of the last
+// complete frame, read-only at HIST_BASE. Bin is iterations >> HIST_SHIFT,
+// saturating at the last bin. HIST_SHIFT applies from the next frame.
+localparam HIST_BINS = 1024;
+localparam HIST_AWIDTH = $clog2(HIST_BINS);
+localparam HIST_SHIFT = 'h808;
+localparam HIST_BASE = 'h2000;
+
+// Schedulers, calculators and colouring run on compute_aclk; only packer
+// runs on out_stream_aclk. OUT_FIFO_AWIDTH sizes the dual-clock FIFO between
+// them (2^OUT_FIFO_AWIDTH pixels).
+parameter  OUT_FIFO_AWIDTH = 4;
+
+// Number of parallel calculator lanes, and how many pixels may be in flight
+// between the dispatcher and the in-order output. CALC_ENGINE selects plain
+// mandelbrot_calculator lanes ("LANES") or interleaved barrel cores ("BARREL").
+parameter  CALC_ENGINE = "LANES";
+parameter  LANES = 4;
+parameter  ROB_DEPTH = 16;
+localparam ROB_TAG_WIDTH = $clog2(ROB_DEPTH);
+
+// z^2 kernel of the fixed-point calculators. "LEAN" builds each one from
+// three squarers (9 DSP48 slices at 32 bits instead of 12 for "MULT3") and
+// gives the same bits, so the saving can go into more LANES.
+parameter  SQUARE_KERNEL = "LEAN";
+
+// Deep-zoom datapath. WIDE_LANES calculators use a WIDE_DATA_WIDTH-bit
+// format with WIDE_FRAC_WIDTH fractional bits and take their pan from the
+// 64-bit PAN_*_LO/HI registers. CTRL_WIDE_EN picks the path per frame.
+// WIDE_LANES = 0 builds the 32-bit path only.
+parameter  WIDE_LANES = 1;
+parameter  WIDE_DATA_WIDTH = 64;
+parameter  WIDE_FRAC_WIDTH = 56;
+
+// Perturbation datapath: PERTURB_LANES calculators iterate per-pixel deltas
+// against a reference orbit of up to ORBIT_DEPTH entries loaded by the host.
+// CTRL_PERTURB_EN picks it per frame; PERTURB_LANES = 0 leaves it out.
+parameter  PERTURB_LANES = 4;
+parameter  ORBIT_DEPTH = 2048;
+localparam ORBIT_AWIDTH = $clog2(ORBIT_DEPTH);
+
+// Mariani-Silver tile engine: with CTRL_TILE_EN set, tile_scheduler computes
+// the border of each TILE_SIZE square and fills it when the border is one
+// colour. Not bit-exact, so it is off by default; TILE_ENGINE = 0 leaves it
+// out.
+parameter  TILE_ENGINE = 1;
+parameter  TILE_SIZE = 16;
+
+// Progressive rendering: with CTRL_PROGRESSIVE_EN set, progressive_scheduler
+// streams the view at 1/8, 1/4 and 1/2 resolution before the full frame,
+// reusing the samples of earlier passes. Takes priority over the tile
+// engine; PROGRESSIVE_ENGINE = 0 leaves it out.
+parameter  PROGRESSIVE_ENGINE = 1;
+
+// Incremental pan: with CTRL_PAN_REUSE_EN set, pan_scheduler keeps every
+// frame in a DDR iteration buffer and only computes the pixels a pan
+// uncovers. With CTRL_MIRROR_EN set and a view symmetric about the real
+// axis, it also copies the lower half of each frame from the upper half.
+// Truncation in 2xy makes conjugate orbits differ in the last bit, so
+// mirrored frames are not bit-exact. PAN_ENGINE = 0 leaves it and the AXI4
+// master out.
+parameter  PAN_ENGINE = 1;
 
 localparam AWAIT_WADD_AND_DATA = 3'b000;
 localparam AWAIT_WDATA = 3'b001;
@@ -56,7 +225,10 @@ localparam AXI_OK = 2'b00;
 localparam AXI_ERR = 2'b10;
 
 reg [31:0]                          regfile [REG_FILE_SIZE-1:0];
+wire [31:0]                         status [STATUS_SIZE-1:0];
 reg [REG_FILE_AWIDTH-1:0]           writeAddr, readAddr;
+reg [STATUS_AWIDTH-1:0]             statusAddr;
+reg                                 readStatus;
 reg [31:0]                          readData, writeData;
 reg [1:0]                           readState = AWAIT_RADD;
 reg [2:0]                           writeState = AWAIT_WADD_AND_DATA;
@@ -64,21 +236,71 @@ reg [2:0]                           writeState = AWAIT_WADD_AND_DATA;
 reg [AXI_LITE_ADDR_WIDTH-1:0]       axi_raddr_reg;
 reg [AXI_LITE_ADDR_WIDTH-1:0]       axi_waddr_reg;
 
+reg                                 orbit_we = 0;
+reg [ORBIT_AWIDTH-1:0]              orbit_waddr;
+reg [79:0]                          orbit_wdata;
+reg [31:0]                          orbit_stage_re, orbit_stage_im;
+reg                                 commit_write = 0;
+wire                                commit_take;
+reg                                 pan_shift_fresh = 0;    // PAN_SHIFT written since the last commit
+reg                                 readPaletteMap, readPaletteSwap;
+reg                                 palette_we = 0;
+reg [PALETTE_AWIDTH:0]              palette_waddr;
+reg [23:0]                          palette_wdata;
+reg [31:0]                          palette_map = 0;
+reg                                 palette_swap_write = 0;
+reg                                 palette_flip_write;
+reg                                 palette_swap_req = 0;    // s_axi_lite_aclk domain toggle
+reg                                 palette_swap_ack = 0;    // compute_aclk domain toggle
+reg                                 palette_swap_wanted = 0;
+reg                                 palette_flip_wanted = 0;
+reg [32:0]                          palette_cfg_axi = 0;     // {front bank, map} as handed over
+reg [32:0]                          palette_cfg_s;
+wire                                palette_swap_req_s, palette_swap_ack_s;
+wire                                palette_swap_busy = (palette_swap_req != palette_swap_ack_s);
+wire                                palette_front = palette_cfg_axi[32];
+wire                                palette_flip = palette_flip_wanted ^ (palette_swap_write && palette_flip_write);
+reg                                 readHistShift, readHist;
+reg [HIST_AWIDTH-1:0]               histAddr;
+reg [4:0]                           hist_shift = 0;
+wire [31:0]                         hist_rdata;
+wire [31:0]                         orbit_index = regfile[REG_ORBIT_INDEX];
+
 initial begin
     regfile[0] = 100;        // max_iter
     regfile[1] = 0;          // pan_x
     regfile[2] = 0;          // pan_y
     regfile[3] = 32'h10000000; // zoom = 1.0 in fixed point
-    regfile[4] = 0;
-    regfile[5] = 0;
-    regfile[6] = 0;
-    regfile[7] = 0;
+    regfile[4] = 0;          // ctrl
+    regfile[5] = 0;          // period_eps
+    regfile[6] = 0;          // julia_re, Q4.28
+    regfile[7] = 0;          // julia_im
+    regfile[8] = 0;          // pan_x_lo, Q8.56
+    regfile[9] = 0;          // pan_x_hi
+    regfile[10] = 0;         // pan_y_lo
+    regfile[11] = 0;         // pan_y_hi
+    regfile[12] = 0;         // orbit_len
+    regfile[13] = 0;         // orbit_index
+    regfile[14] = 0;         // orbit_data
+    regfile[15] = 0;         // commit
+    regfile[16] = PAN_SHIFT_NONE; // pan_shift
+    regfile[17] = 0;         // ibuf_addr
+    regfile[18] = X_SIZE;    // width
+    regfile[19] = Y_SIZE;    // height
+    for (int i = 20; i < REG_FILE_SIZE; i++) begin
+        regfile[i] = 0;
+    end
 end
 
 //Read from the register file
 always @(posedge s_axi_lite_aclk) begin
     
-    readData <= regfile[readAddr];
+    readData <= readHistShift ? {27'b0, hist_shift} :
+                readPaletteMap ? palette_map :
+                readPaletteSwap ? {31'b0, palette_swap_busy || palette_swap_wanted} :
+                readStatus ? status[statusAddr] :
+                (readAddr == REG_COMMIT) ? {31'b0, commit_busy || commit_wanted} :
+                regfile[readAddr];
 
     if (!axi_resetn) begin
         readState <= AWAIT_RADD;
@@ -87,6 +309,15 @@ always @(posedge s_axi_lite_aclk) begin
         AWAIT_RADD: begin
             if (s_axi_lite_arvalid) begin
                 readAddr <= s_axi_lite_araddr[2+:REG_FILE_AWIDTH];
+                statusAddr <= s_axi_lite_araddr[2+:STATUS_AWIDTH];
+                readStatus <= (s_axi_lite_araddr >= STATUS_BASE &&
+                               s_axi_lite_araddr < STATUS_BASE + (STATUS_SIZE * 4));
+                readPaletteMap <= (s_axi_lite_araddr == PALETTE_MAP);
+                readPaletteSwap <= (s_axi_lite_araddr == PALETTE_SWAP);
+                readHistShift <= (s_axi_lite_araddr == HIST_SHIFT);
+                readHist <= (s_axi_lite_araddr >= HIST_BASE &&
+                             s_axi_lite_araddr < HIST_BASE + (HIST_BINS * 4));
+                histAddr <= s_axi_lite_araddr[2+:HIST_AWIDTH];
                 axi_raddr_reg <= s_axi_lite_araddr;
                 readState <= AWAIT_FETCH;
             end
@@ -109,12 +340,26 @@ always @(posedge s_axi_lite_aclk) begin
 end
 
 assign s_axi_lite_arready = (readState == AWAIT_RADD);
-assign s_axi_lite_rresp = (axi_raddr_reg < (REG_FILE_SIZE * 4)) ? AXI_OK : AXI_ERR;
+assign s_axi_lite_rresp = ((axi_raddr_reg < (REG_FILE_SIZE * 4)) ||
+                           (axi_raddr_reg >= STATUS_BASE && axi_raddr_reg < STATUS_BASE + (STATUS_SIZE * 4)) ||
+                           axi_raddr_reg == PALETTE_MAP || axi_raddr_reg == PALETTE_SWAP ||
+                           axi_raddr_reg == HIST_SHIFT ||
+                           (axi_raddr_reg >= HIST_BASE &&
+                            axi_raddr_reg < HIST_BASE + (HIST_BINS * 4))) ? AXI_OK : AXI_ERR;
 assign s_axi_lite_rvalid = (readState == AWAIT_READ);
-assign s_axi_lite_rdata = readData;
+// The histogram RAM has its own registered read port
+assign s_axi_lite_rdata = readHist ? hist_rdata : readData;
 
 //Write to the register file
 always @(posedge s_axi_lite_aclk) begin
+    orbit_we <= 0;
+    commit_write <= 0;
+    palette_we <= 0;
+    palette_swap_write <= 0;
+    if (commit_take) begin
+        pan_shift_fresh <= 0;
+    end
+
     if (!axi_resetn) begin
         writeState <= AWAIT_WADD_AND_DATA;
         axi_waddr_reg <= 0;
@@ -161,6 +406,37 @@ always @(posedge s_axi_lite_aclk) begin
             // Only write if address is valid to prevent corruption
             if (axi_waddr_reg < (REG_FILE_SIZE * 4)) begin
                 regfile[writeAddr] <= writeData;
+                commit_write <= (writeAddr == REG_COMMIT);
+                if (writeAddr == REG_PAN_SHIFT) begin
+                    pan_shift_fresh <= 1;
+                end
+                if (writeAddr == REG_ORBIT_DATA) begin
+                    case (orbit_index[1:0])
+                        2'd0: orbit_stage_re <= writeData;
+                        2'd1: orbit_stage_im <= writeData;
+                        2'd2: begin
+                            orbit_we <= 1;
+                            orbit_waddr <= orbit_index[2+:ORBIT_AWIDTH];
+                            orbit_wdata <= {writeData[15:0], orbit_stage_im, orbit_stage_re};
+                        end
+                        default: ;
+                    endcase
+                    // Skip the unused fourth word so the next write starts an entry
+                    regfile[REG_ORBIT_INDEX] <= orbit_index + ((orbit_index[1:0] == 2'd2) ? 2 : 1);
+                end
+            end else if (axi_waddr_reg == PALETTE_MAP) begin
+                palette_map <= writeData;
+            end else if (axi_waddr_reg == PALETTE_SWAP) begin
+                palette_swap_write <= 1;
+                palette_flip_write <= writeData[0];
+            end else if (axi_waddr_reg == HIST_SHIFT) begin
+                hist_shift <= writeData[4:0];
+            end else if (axi_waddr_reg >= PALETTE_BASE &&
+                         axi_waddr_reg < PALETTE_BASE + (PALETTE_DEPTH * 4)) begin
+                // Entries always go to the bank that is not on screen
+                palette_we <= 1;
+                palette_waddr <= {!palette_front, axi_waddr_reg[2+:PALETTE_AWIDTH]};
+                palette_wdata <= writeData[23:0];
             end
             writeState <= AWAIT_RESP;
         end
@@ -180,162 +456,1213 @@ end
 assign s_axi_lite_awready = (writeState == AWAIT_WADD_AND_DATA || writeState == AWAIT_WADD);
 assign s_axi_lite_wready = (writeState == AWAIT_WADD_AND_DATA || writeState == AWAIT_WDATA);
 assign s_axi_lite_bvalid = (writeState == AWAIT_RESP);
-assign s_axi_lite_bresp = (axi_waddr_reg < (REG_FILE_SIZE * 4)) ? AXI_OK : AXI_ERR;
+assign s_axi_lite_bresp = ((axi_waddr_reg < (REG_FILE_SIZE * 4)) ||
+                           axi_waddr_reg == PALETTE_MAP || axi_waddr_reg == PALETTE_SWAP ||
+                           axi_waddr_reg == HIST_SHIFT ||
+                           (axi_waddr_reg >= PALETTE_BASE &&
+                            axi_waddr_reg < PALETTE_BASE + (PALETTE_DEPTH * 4))) ? AXI_OK : AXI_ERR;
 
 wire [31:0] max_iter_in = regfile[0];
 wire [31:0] pan_x_in    = regfile[1];
 wire [31:0] pan_y_in    = regfile[2];
 wire [31:0] zoom_in     = regfile[3];
+wire [31:0] ctrl_in     = regfile[4];
+wire [31:0] period_eps_in = regfile[5];
+wire [63:0] pan_x_wide_in = {regfile[9], regfile[8]};
+wire [63:0] pan_y_wide_in = {regfile[11], regfile[10]};
+wire [31:0] orbit_len_in  = regfile[12];
+wire [31:0] pan_shift_in  = pan_shift_fresh ? regfile[REG_PAN_SHIFT] : PAN_SHIFT_NONE;
+wire [31:0] ibuf_addr_in  = regfile[REG_IBUF_ADDR];
+wire [31:0] width_in      = regfile[REG_WIDTH];
+wire [31:0] height_in     = regfile[REG_HEIGHT];
+wire [63:0] origin_re_in  = {regfile[REG_ORIGIN_RE + 1], regfile[REG_ORIGIN_RE]};
+wire [63:0] origin_im_in  = {regfile[REG_ORIGIN_IM + 1], regfile[REG_ORIGIN_IM]};
+wire [63:0] dx_re_in      = {regfile[REG_DX_RE + 1], regfile[REG_DX_RE]};
+wire [63:0] dx_im_in      = {regfile[REG_DX_IM + 1], regfile[REG_DX_IM]};
+wire [63:0] dy_re_in      = {regfile[REG_DY_RE + 1], regfile[REG_DY_RE]};
+wire [63:0] dy_im_in      = {regfile[REG_DY_IM + 1], regfile[REG_DY_IM]};
+wire [63:0] julia_in      = {regfile[7], regfile[6]};
 
 wire [31:0] max_iter_s;
 wire [31:0] pan_x_s;
 wire [31:0] pan_y_s;
 wire [31:0] zoom_s;
+wire [31:0] ctrl_s;
+wire [31:0] period_eps_s;
+wire [63:0] pan_x_wide_s;
+wire [63:0] pan_y_wide_s;
+wire [31:0] orbit_len_s;
+wire [63:0] julia_s;
+wire [31:0] pan_shift_s;
+wire [31:0] ibuf_addr_s;
+wire [31:0] width_s;
+wire [31:0] height_s;
+wire [63:0] origin_re_s;
+wire [63:0] origin_im_s;
+wire [63:0] dx_re_s;
+wire [63:0] dx_im_s;
+wire [63:0] dy_re_s;
+wire [63:0] dy_im_s;
+
+// -- Frame-atomic parameter commit --
+// Registers 0x00-0x30 and 0x40-0x7C are shadows. A COMMIT write snapshots them into
+// params_axi and flips commit_req; the pixel domain copies the whole bank
+// in one cycle when the toggle arrives and flips commit_ack back. The bank
+// only changes while the two toggles agree, so it is stable whenever the
+// pixel domain samples it and no bit needs its own synchronizer.
+localparam PARAM_WIDTH = 29 * 32;
+
+wire [PARAM_WIDTH-1:0] params_in = {dy_im_in, dy_re_in, dx_im_in, dx_re_in, origin_im_in, origin_re_in,
+                                    height_in, width_in,
+                                    ibuf_addr_in, pan_shift_in, orbit_len_in, pan_y_wide_in,
+                                    pan_x_wide_in, julia_in, period_eps_in, ctrl_in, zoom_in,
+                                    pan_y_in, pan_x_in, max_iter_in};
+reg  [PARAM_WIDTH-1:0] params_axi;
+reg  [PARAM_WIDTH-1:0] params_s;
+
+assign {dy_im_s, dy_re_s, dx_im_s, dx_re_s, origin_im_s, origin_re_s,
+        height_s, width_s,
+        ibuf_addr_s, pan_shift_s, orbit_len_s, pan_y_wide_s,
+        pan_x_wide_s, julia_s, period_eps_s, ctrl_s, zoom_s,
+        pan_y_s, pan_x_s, max_iter_s} = params_s;
 
-// Instantiate synchronizers for each control signal
-cdc_synchronizer #(.WIDTH(32)) sync_max_iter (
-    .dest_clk(out_stream_aclk),
+reg         commit_req = 0;     // s_axi_lite_aclk domain toggle
+reg         commit_ack = 0;     // compute_aclk domain toggle
+reg         commit_ack_q = 0;
+reg         commit_wanted = 0;
+wire        commit_req_s, commit_ack_s;
+wire        commit_busy = (commit_req != commit_ack_s);
+assign      commit_take = periph_resetn && (commit_write || commit_wanted) && !commit_busy;
+
+// The frame the last commit took effect in. It changes on the same edge as
+// commit_ack, and the AXI side only samples it once the toggle has come
+// through its two-flop synchronizer, by which time it has settled.
+reg [31:0]  applied_frame;
+reg [31:0]  applied_frame_axi = 1;
+
+cdc_synchronizer #(.WIDTH(1)) sync_commit_req (
+    .dest_clk(compute_aclk),
     .rst(!periph_resetn),
-    .data_in(max_iter_in),
-    .data_out(max_iter_s)
+    .data_in(commit_req),
+    .data_out(commit_req_s)
 );
 
-cdc_synchronizer #(.WIDTH(32)) sync_pan_x (
-    .dest_clk(out_stream_aclk),
-    .rst(!periph_resetn),
-    .data_in(pan_x_in),
-    .data_out(pan_x_s)
+cdc_synchronizer #(.WIDTH(1)) sync_commit_ack (
+    .dest_clk(s_axi_lite_aclk),
+    .rst(!axi_resetn),
+    .data_in(commit_ack),
+    .data_out(commit_ack_s)
 );
 
-cdc_synchronizer #(.WIDTH(32)) sync_pan_y (
-    .dest_clk(out_stream_aclk),
+// A COMMIT that arrives while the previous one is still in flight is held
+// and takes the registers as they are once the handshake completes. While
+// the pixel pipeline is held in reset the bank follows the shadows, so a
+// generator programmed under periph_resetn needs no COMMIT.
+always @(posedge s_axi_lite_aclk) begin
+    commit_ack_q <= commit_ack_s;
+    if (commit_ack_s != commit_ack_q) begin
+        applied_frame_axi <= applied_frame;
+    end
+
+    if (!periph_resetn) begin
+        params_axi <= params_in;
+        commit_wanted <= 0;
+        applied_frame_axi <= 1;
+    end else if (commit_write || commit_wanted) begin
+        if (commit_busy) begin
+            commit_wanted <= 1;
+        end else begin
+            params_axi <= params_in;
+            commit_req <= !commit_req;
+            commit_wanted <= 0;
+        end
+    end
+end
+
+// -- Palette swap --
+// PALETTE_SWAP hands PALETTE_MAP and the choice of bank to the compute
+// domain with the same toggle handshake as COMMIT. It is applied where the
+// first pixel of the next frame leaves the reorder buffer rather than where
+// it is issued, so the calculators never wait for it and nothing is
+// recomputed. Bit 0 of the write puts the freshly loaded bank on screen.
+cdc_synchronizer #(.WIDTH(1)) sync_palette_swap_req (
+    .dest_clk(compute_aclk),
     .rst(!periph_resetn),
-    .data_in(pan_y_in),
-    .data_out(pan_y_s)
+    .data_in(palette_swap_req),
+    .data_out(palette_swap_req_s)
 );
 
-cdc_synchronizer #(.WIDTH(32)) sync_zoom (
-    .dest_clk(out_stream_aclk),
-    .rst(!periph_resetn),
-    .data_in(zoom_in),
-    .data_out(zoom_s)
+cdc_synchronizer #(.WIDTH(1)) sync_palette_swap_ack (
+    .dest_clk(s_axi_lite_aclk),
+    .rst(!axi_resetn),
+    .data_in(palette_swap_ack),
+    .data_out(palette_swap_ack_s)
 );
 
-// -- FSM State Definitions --
-localparam FSM_START   = 2'd0;
-localparam FSM_COMPUTE = 2'd1;
-localparam FSM_VALID   = 2'd2;
+// Like COMMIT, a swap written while one is in flight waits for it, and
+// under periph_resetn the map follows PALETTE_MAP directly
+always @(posedge s_axi_lite_aclk) begin
+    if (!periph_resetn) begin
+        palette_cfg_axi <= {palette_front ^ palette_flip, palette_map};
+        palette_swap_wanted <= 0;
+        palette_flip_wanted <= 0;
+    end else if (palette_swap_write || palette_swap_wanted) begin
+        if (palette_swap_busy) begin
+            palette_swap_wanted <= 1;
+            palette_flip_wanted <= palette_flip;
+        end else begin
+            palette_cfg_axi <= {palette_front ^ palette_flip, palette_map};
+            palette_swap_req <= !palette_swap_req;
+            palette_swap_wanted <= 0;
+            palette_flip_wanted <= 0;
+        end
+    end
+end
 
-// -- FSM and Control Registers --
-reg [1:0] state = FSM_START;
-reg [9:0] x = 0;
-reg [8:0] y = 0;
-reg start_mandel = 0;
+// The commit synchronizer comes out of reset holding zero; keep the pixel
+// pipeline in reset until it has caught up with commit_req.
+reg  [1:0]  sync_settle = 0;
+wire        pipeline_rst = !periph_resetn || (sync_settle != 2'd3);
 
-reg sof_for_packer;
-reg eol_for_packer;
+always @(posedge compute_aclk) begin
+    if (!periph_resetn) begin
+        sync_settle <= 0;
+    end else if (sync_settle != 2'd3) begin
+        sync_settle <= sync_settle + 1;
+    end
+end
 
-wire pixel_valid;
-assign pixel_valid = (state == FSM_VALID);
+// Frame size as committed, clamped to 1..MAX_WIDTH x 1..MAX_HEIGHT
+wire [COORD_WIDTH-1:0] frame_width  = (width_s == 0)  ? COORD_WIDTH'(1) :
+                                      (width_s > MAX_WIDTH) ? COORD_WIDTH'(MAX_WIDTH) : COORD_WIDTH'(width_s);
+wire [COORD_WIDTH-1:0] frame_height = (height_s == 0) ? COORD_WIDTH'(1) :
+                                      (height_s > MAX_HEIGHT) ? COORD_WIDTH'(MAX_HEIGHT) : COORD_WIDTH'(height_s);
+wire        frame_native = (frame_width == COORD_WIDTH'(X_SIZE)) && (frame_height == COORD_WIDTH'(Y_SIZE));
 
 // -- Wires for connecting modules --
+wire [COORD_WIDTH-1:0] issue_x, issue_y;
+wire [ROB_TAG_WIDTH-1:0] issue_tag;
+wire        issue_valid, issue_ready;
+wire        calc_ready, issue_hold;
+wire        sched_idle;
+
+// Frame schedulers, picked by CTRL
+localparam [1:0] SCHED_RASTER = 2'd0;
+localparam [1:0] SCHED_TILE   = 2'd1;
+localparam [1:0] SCHED_PROG   = 2'd2;
+localparam [1:0] SCHED_PAN    = 2'd3;
+localparam SCHED_COUNT = 4;
+wire [1:0]  sched;
+wire        sched_issue_first [SCHED_COUNT-1:0];
+
+wire        tile_fill_valid;
+wire [31:0] tile_fill_iterations;
+wire [2:0]  pass_done;
+wire        pan_copy_valid;
 wire [31:0] c_re, c_im;
-wire [31:0] iterations;
-wire        mandel_ready;
+wire [WIDE_DATA_WIDTH-1:0] c_re_wide, c_im_wide;
+wire [31:0] pixel_re, pixel_im;
+wire [WIDE_DATA_WIDTH-1:0] pixel_re_wide, pixel_im_wide;
+wire [31:0] mapped_re, mapped_im;
+wire [WIDE_DATA_WIDTH-1:0] mapped_re_wide, mapped_im_wide;
+wire [63:0] stepped_re, stepped_im;
+
+wire        result_valid;
+wire [ROB_TAG_WIDTH-1:0] result_tag;
+wire [31:0] result_iterations;
+wire [31:0] result_magnitude;
+wire        shortcut_hit, shortcut_first;
+wire [7:0]  rebase_count, glitch_count;
+
+wire        ordered_valid;
+wire [31:0] ordered_iterations;
+wire [31:0] ordered_magnitude;
+wire        ordered_sof, ordered_eol;
+wire        ordered_fire;
+
 wire [7:0]  r, g, b;
 wire        packer_ready;
 
-// -- Positional/Control Wires --
-wire lastx = (x == X_SIZE - 1);
-wire lasty = (y == Y_SIZE - 1);
+// Output stage, one pixel ahead of the stream FIFO
+reg         pixel_valid = 0;
+reg [31:0]  pixel_iterations;
+reg [31:0]  pixel_magnitude;
+reg [31:0]  pixel_max_iter;
+reg [32:0]  pixel_palette;
+reg         pixel_ext;
+reg         frame_ext;
+reg         pixel_raw;
+reg         frame_raw;
+reg         sof_for_packer;
+reg         eol_for_packer;
 
-// -- Control FSM --
-always @(posedge out_stream_aclk) begin
-    if (!periph_resetn) begin
-        x <= 0;
-        y <= 0;
-        state <= FSM_START;
-        start_mandel <= 0;
-        sof_for_packer <= 0;
-        eol_for_packer <= 0;
+// -- Interior shortcut statistics --
+// Counted as pixels leave calculator_array's issue stage and snapshotted
+// when pixel (0, 0) of the next frame leaves it, so the status registers
+// always describe the last complete frame.
+wire        issue_first = sched_issue_first[sched];
+wire        frame_start = issue_valid && issue_ready && issue_first;
+
+// The datapath is chosen when pixel (0, 0) issues and kept for the frame
+reg         frame_wide, frame_perturb, frame_julia;
+wire        issue_julia = issue_first ? ctrl_s[CTRL_JULIA_EN] : frame_julia;
+wire        issue_wide = (WIDE_LANES > 0) &&
+                         (issue_first ? ctrl_s[CTRL_WIDE_EN] : frame_wide);
+// The reference orbit is a Mandelbrot orbit, so Julia frames stay on the
+// fixed-point paths
+wire        issue_perturb = (PERTURB_LANES > 0) && !issue_julia &&
+                            (issue_first ? ctrl_s[CTRL_PERTURB_EN] : frame_perturb);
+
+// A pending commit holds pixel (0, 0) until the previous frame has left
+// the calculators, then swaps the whole bank in one cycle, so every pixel
+// of a frame sees the same parameters.
+reg [31:0]  frame_number;       // Frames started since reset, from 1
+reg [31:0]  frame_number_gray;
+wire [31:0] frame_number_next = frame_number + 1;
+wire        commit_pending = (commit_req_s != commit_ack);
+wire        commit_apply = issue_hold && sched_idle;
+
+assign issue_hold  = commit_pending && issue_first;
+assign issue_ready = calc_ready && !issue_hold;
+
+always @(posedge compute_aclk) begin
+    if (pipeline_rst) begin
+        params_s <= params_axi;
+        commit_ack <= commit_req_s;
+        applied_frame <= 1;
+        frame_number <= 0;
+        frame_number_gray <= 0;
+    end else if (commit_apply) begin
+        params_s <= params_axi;
+        commit_ack <= !commit_ack;
+        applied_frame <= frame_number_next;
+    end else if (frame_start) begin
+        frame_number <= frame_number_next;
+        frame_number_gray <= frame_number_next ^ (frame_number_next >> 1);
+    end
+end
+
+always @(posedge compute_aclk) begin
+    if (pipeline_rst) begin
+        frame_wide <= 0;
+        frame_perturb <= 0;
+        frame_julia <= 0;
+    end else if (frame_start) begin
+        frame_wide <= issue_wide;
+        frame_perturb <= issue_perturb;
+        frame_julia <= issue_julia;
+    end
+end
+
+// Julia mode: the pixel becomes z0 and c is the JULIA_RE/IM constant,
+// extended to Q8.56 for the wide lanes
+wire [31:0] julia_re = julia_s[31:0];
+wire [31:0] julia_im = julia_s[63:32];
+wire [WIDE_DATA_WIDTH-1:0] julia_re_wide = WIDE_DATA_WIDTH'($signed(julia_re)) <<< (WIDE_FRAC_WIDTH - 28);
+wire [WIDE_DATA_WIDTH-1:0] julia_im_wide = WIDE_DATA_WIDTH'($signed(julia_im)) <<< (WIDE_FRAC_WIDTH - 28);
+
+assign c_re      = issue_julia ? julia_re : pixel_re;
+assign c_im      = issue_julia ? julia_im : pixel_im;
+assign c_re_wide = issue_julia ? julia_re_wide : pixel_re_wide;
+assign c_im_wide = issue_julia ? julia_im_wide : pixel_im_wide;
+
+wire [31:0] z0_re = issue_julia ? pixel_re : 32'h0;
+wire [31:0] z0_im = issue_julia ? pixel_im : 32'h0;
+wire [WIDE_DATA_WIDTH-1:0] z0_re_wide = issue_julia ? pixel_re_wide : '0;
+wire [WIDE_DATA_WIDTH-1:0] z0_im_wide = issue_julia ? pixel_im_wide : '0;
+
+// Conjugate pixels have the same count when the view is centred on the real
+// axis on the datapath in use. A Julia set is symmetric too if c is real.
+// An affine view is symmetric when its lines run parallel to the real axis
+// and the centre row, Y_SIZE / 2, lies on it.
+wire        scaled_symmetric = (dx_im_s == 0) && (dy_re_s == 0) &&
+                               (origin_im_s + 64'(Y_SIZE / 2) * dy_im_s == 0);
+wire        view_symmetric = (issue_perturb         ? (pan_y_wide_s == 0) :
+                              ctrl_s[CTRL_SCALE_EN] ? scaled_symmetric :
+                              issue_wide            ? (pan_y_wide_s == 0) :
+                                                      (pan_y_s == 0)) &&
+                             (!issue_julia || julia_im == 0);
+
+// Perturbation pixels are offsets from the reference point at the view
+// centre: dc = ((x - width/2) + i(y - height/2)) * 2^-(8 + zoom), with the
+// full 16-bit zoom since there is no fixed-point floor to hit.
+wire [15:0] dc_re  = 16'(issue_x) - 16'(frame_width >> 1);
+wire [15:0] dc_im  = 16'(issue_y) - 16'(frame_height >> 1);
+wire [15:0] dc_exp = -16'd8 - zoom_s[15:0];
+
+// -- Perturbation statistics, per frame like the cardioid counters --
+reg [31:0]  rebases, glitches;
+reg [31:0]  rebases_frame, glitches_frame;
+
+always @(posedge compute_aclk) begin
+    if (pipeline_rst) begin
+        rebases <= 0;
+        glitches <= 0;
+        rebases_frame <= 0;
+        glitches_frame <= 0;
+    end else if (frame_start) begin
+        rebases_frame <= rebases;
+        glitches_frame <= glitches;
+        rebases <= 32'(rebase_count);
+        glitches <= 32'(glitch_count);
     end else begin
-        start_mandel <= 0;
+        rebases <= rebases + 32'(rebase_count);
+        glitches <= glitches + 32'(glitch_count);
+    end
+end
+reg [31:0]  cardioid_hits, cardioid_saved;
+reg [31:0]  cardioid_hits_frame, cardioid_saved_frame;
 
-        case(state)
-            FSM_START: begin
-                //$display("In FSM_START");
-                start_mandel <= 1; // Assert start for one cycle
-                state <= FSM_COMPUTE;
-            end
+always @(posedge compute_aclk) begin
+    if (pipeline_rst) begin
+        cardioid_hits <= 0;
+        cardioid_saved <= 0;
+        cardioid_hits_frame <= 0;
+        cardioid_saved_frame <= 0;
+    end else if (shortcut_first) begin
+        cardioid_hits_frame <= cardioid_hits;
+        cardioid_saved_frame <= cardioid_saved;
+        cardioid_hits <= shortcut_hit ? 1 : 0;
+        cardioid_saved <= shortcut_hit ? max_iter_s : 0;
+    end else if (shortcut_hit) begin
+        cardioid_hits <= cardioid_hits + 1;
+        cardioid_saved <= cardioid_saved + max_iter_s;
+    end
+end
 
-            FSM_COMPUTE: begin
-                //$display("In FSM_COMPUTE: ", mandel_ready);
-                if (mandel_ready) begin
-                    state <= FSM_VALID;
-                    sof_for_packer <= (x == 0 && y == 0);
-                    eol_for_packer <= lastx;
-                end
+// Tile engine fills, counted like the cardioid shortcut
+reg [31:0]  tile_filled, tile_saved;
+reg [31:0]  tile_filled_frame, tile_saved_frame;
+
+always @(posedge compute_aclk) begin
+    if (pipeline_rst) begin
+        tile_filled <= 0;
+        tile_saved <= 0;
+        tile_filled_frame <= 0;
+        tile_saved_frame <= 0;
+    end else if (frame_start) begin
+        tile_filled_frame <= tile_filled;
+        tile_saved_frame <= tile_saved;
+        tile_filled <= 0;
+        tile_saved <= 0;
+    end else if (tile_fill_valid) begin
+        tile_filled <= tile_filled + 1;
+        tile_saved <= tile_saved + tile_fill_iterations;
+    end
+end
+
+// Pixels the pan scheduler read back instead of computing, from the last
+// frame or the mirror row
+reg [31:0]  pan_copied, pan_copied_frame;
+
+always @(posedge compute_aclk) begin
+    if (pipeline_rst) begin
+        pan_copied <= 0;
+        pan_copied_frame <= 0;
+    end else if (frame_start) begin
+        pan_copied_frame <= pan_copied;
+        pan_copied <= 0;
+    end else if (pan_copy_valid) begin
+        pan_copied <= pan_copied + 1;
+    end
+end
+
+// -- Performance counters --
+// Counted on the output side and snapshotted when the next frame's first
+// pixel leaves the reorder buffer, so pixels are credited to their own
+// frame whatever order the lanes finish in.
+wire        frame_end = ordered_fire && ordered_sof;
+wire        issue_stall = calc_ready && !(issue_valid && !issue_hold);
+
+reg [31:0]  perf_cycles, perf_idle, perf_max_iter;
+reg [63:0]  perf_iterations;
+reg [31:0]  perf_cycles_frame, perf_idle_frame, perf_max_iter_frame;
+reg [63:0]  perf_iterations_frame;
+
+always @(posedge compute_aclk) begin
+    if (pipeline_rst) begin
+        perf_cycles <= 0;
+        perf_idle <= 0;
+        perf_max_iter <= 0;
+        perf_iterations <= 0;
+        perf_cycles_frame <= 0;
+        perf_idle_frame <= 0;
+        perf_max_iter_frame <= 0;
+        perf_iterations_frame <= 0;
+    end else if (frame_end) begin
+        perf_cycles_frame <= perf_cycles;
+        perf_idle_frame <= perf_idle;
+        perf_max_iter_frame <= perf_max_iter;
+        perf_iterations_frame <= perf_iterations;
+        perf_cycles <= 1;
+        perf_idle <= issue_stall ? 1 : 0;
+        perf_max_iter <= ordered_iterations;
+        perf_iterations <= 64'(ordered_iterations);
+    end else begin
+        perf_cycles <= perf_cycles + 1;
+        perf_idle <= perf_idle + (issue_stall ? 1 : 0);
+        if (ordered_fire) begin
+            perf_iterations <= perf_iterations + 64'(ordered_iterations);
+            if (ordered_iterations > perf_max_iter) begin
+                perf_max_iter <= ordered_iterations;
             end
+        end
+    end
+end
 
-            FSM_VALID: begin
-                //$display("In FSM_VALID");
-                if (packer_ready) begin // Wait for packer to accept the data
-                    //$display("Pixel is valid and ready");
-                    if (lastx) begin
-                        x <= 0;
-                        y <= y + 1;
-                    end else begin
-                        x <= x+ 1;
-                    end
-                    state <= FSM_START;
-                end
+// -- Iteration histogram --
+// Binned on the output side like the performance counters. Two counting
+// banks take turns: one counts the current frame while the other, holding
+// the frame that just ended, is copied into hist_ram and cleared, one bin
+// per clock. hist_ram has two banks of its own, written here and read from
+// the AXI clock. Each of the three RAMs thus has one read and one write
+// port, and a bank is cleared by the copy rather than by a flag per bin.
+localparam HIST_WORDS = 2 * HIST_BINS;
+
+reg [31:0]  hist_ram [0:HIST_WORDS-1];
+reg         hist_bank;          // Counting bank
+reg         hist_out_bank;      // hist_ram bank of the last copied frame
+reg [4:0]   hist_shift_frame;
+reg [31:0]  hist_accum_frame, hist_frame, hist_frame_out;
+reg [31:0]  hist_interior, hist_interior_frame, hist_interior_out;
+reg [31:0]  hist_max_escaped, hist_max_escaped_frame, hist_max_escaped_out;  // Highest count below max_iter
+wire [4:0]  hist_shift_s;
+
+cdc_synchronizer #(.WIDTH(5)) sync_hist_shift (
+    .dest_clk(compute_aclk),
+    .rst(!periph_resetn),
+    .data_in(hist_shift),
+    .data_out(hist_shift_s)
+);
+
+// Pixel (0, 0) already belongs to the next bank and shift
+wire        hist_px_bank = frame_end ? !hist_bank : hist_bank;
+wire [4:0]  hist_px_shift = frame_end ? hist_shift_s : hist_shift_frame;
+wire [31:0] hist_binned = ordered_iterations >> hist_px_shift;
+wire [HIST_AWIDTH-1:0] hist_bin = (hist_binned >= HIST_BINS) ? HIST_AWIDTH'(HIST_BINS - 1) :
+                                  hist_binned[HIST_AWIDTH-1:0];
+wire        hist_escaped = ordered_iterations < max_iter_s;
+
+always @(posedge compute_aclk) begin
+    if (pipeline_rst) begin
+        hist_bank <= 0;
+        hist_shift_frame <= 0;
+        hist_accum_frame <= 0;
+        hist_frame <= 0;
+        hist_interior <= 0;
+        hist_interior_frame <= 0;
+        hist_max_escaped <= 0;
+        hist_max_escaped_frame <= 0;
+    end else if (frame_end) begin
+        hist_bank <= hist_px_bank;
+        hist_shift_frame <= hist_shift_s;
+        // 0 until a whole frame has been binned since reset
+        hist_accum_frame <= hist_accum_frame + 1;
+        hist_frame <= hist_accum_frame;
+        hist_interior_frame <= hist_interior;
+        hist_interior <= hist_escaped ? 0 : 1;
+        hist_max_escaped_frame <= hist_max_escaped;
+        hist_max_escaped <= hist_escaped ? ordered_iterations : 0;
+    end else if (ordered_fire) begin
+        if (!hist_escaped) begin
+            hist_interior <= hist_interior + 1;
+        end else if (ordered_iterations > hist_max_escaped) begin
+            hist_max_escaped <= ordered_iterations;
+        end
+    end
+end
+
+// Copy and clear. Each frame_end starts a pass over the bank that was
+// counting, reading a bin on one clock and on the next writing it to the
+// back bank of hist_ram and 0 back to the counting bank. The pass after
+// reset clears both counting banks and zeroes hist_ram instead. The
+// statistics of a frame are published with its bins, when the pass ends.
+// Pixel (0, 0) waits at the reorder buffer while a pass runs. A pass takes
+// HIST_BINS clocks and pixels leave at most one per clock, so that happens
+// after reset and at every frame smaller than HIST_BINS pixels, down to
+// the 1x1 minimum of WIDTH/HEIGHT; such frames run at one per pass.
+reg                 hist_copy_busy, hist_copy_publish, hist_copy_valid, hist_copy_end;
+reg [HIST_AWIDTH:0] hist_copy_addr, hist_copy_waddr;
+wire [31:0]         hist_copy_word;
+wire                hist_copy_last = hist_copy_publish ? &hist_copy_addr[HIST_AWIDTH-1:0] :
+                                                         &hist_copy_addr;
+
+always @(posedge compute_aclk) begin
+    if (pipeline_rst) begin
+        hist_copy_busy <= 1;
+        hist_copy_publish <= 0;
+        hist_copy_addr <= 0;
+        hist_copy_valid <= 0;
+        hist_copy_end <= 0;
+        hist_out_bank <= 0;
+        hist_frame_out <= 0;
+        hist_interior_out <= 0;
+        hist_max_escaped_out <= 0;
+    end else begin
+        if (frame_end) begin
+            hist_copy_busy <= 1;
+            hist_copy_publish <= 1;
+            hist_copy_addr <= {hist_bank, HIST_AWIDTH'(0)};
+        end else if (hist_copy_busy) begin
+            hist_copy_busy <= !hist_copy_last;
+            hist_copy_addr <= hist_copy_addr + 1;
+        end
+        hist_copy_valid <= hist_copy_busy;
+        hist_copy_waddr <= hist_copy_addr;
+        hist_copy_end <= hist_copy_busy && hist_copy_last;
+        if (hist_copy_end && hist_copy_publish) begin
+            hist_out_bank <= !hist_out_bank;
+            hist_frame_out <= hist_frame;
+            hist_interior_out <= hist_interior_frame;
+            hist_max_escaped_out <= hist_max_escaped_frame;
+        end
+    end
+end
+
+always @(posedge compute_aclk) begin
+    if (hist_copy_valid) begin
+        if (hist_copy_publish) begin
+            hist_ram[{!hist_out_bank, hist_copy_waddr[HIST_AWIDTH-1:0]}] <= hist_copy_word;
+        end else begin
+            hist_ram[hist_copy_waddr] <= 32'h0;
+        end
+    end
+end
+
+// Read-modify-write, one pixel per clock. A pixel's read happens on the
+// edge that writes the pixel before it, so the RAM returns the old count
+// for back-to-back pixels in the same bin; forward the written one instead.
+// The last pixel of a frame is written the clock before its bank's copy
+// pass first reads, and the pass never touches the bank being counted.
+reg                 hist_rd_valid, hist_wr_valid;
+reg [HIST_AWIDTH:0] hist_rd_addr, hist_wr_addr;
+reg [31:0]          hist_wr_count;
+wire [31:0]         hist_count_word [0:1];
+
+wire [31:0] hist_rd_count = (hist_wr_valid && hist_wr_addr == hist_rd_addr) ? hist_wr_count :
+                            hist_count_word[hist_rd_addr[HIST_AWIDTH]];
+
+assign hist_copy_word = hist_count_word[hist_copy_waddr[HIST_AWIDTH]];
+
+genvar hb;
+generate
+    for (hb = 0; hb < 2; hb++) begin : hist_count
+        reg [31:0] count [0:HIST_BINS-1];
+        reg [31:0] word;
+        wire       copy_rd = hist_copy_busy && hist_copy_addr[HIST_AWIDTH] == 1'(hb);
+
+        always @(posedge compute_aclk) begin
+            word <= count[copy_rd ? hist_copy_addr[HIST_AWIDTH-1:0] : hist_bin];
+            if (hist_copy_valid && hist_copy_waddr[HIST_AWIDTH] == 1'(hb)) begin
+                count[hist_copy_waddr[HIST_AWIDTH-1:0]] <= 32'h0;
+            end else if (hist_rd_valid && hist_rd_addr[HIST_AWIDTH] == 1'(hb)) begin
+                count[hist_rd_addr[HIST_AWIDTH-1:0]] <= hist_rd_count + 1;
             end
-            default: state <= FSM_START;
-        endcase
+        end
+
+        assign hist_count_word[hb] = word;
+    end
+endgenerate
+
+always @(posedge compute_aclk) begin
+    if (pipeline_rst) begin
+        hist_rd_valid <= 0;
+        hist_wr_valid <= 0;
+    end else begin
+        hist_rd_valid <= ordered_fire && hist_escaped;
+        hist_rd_addr <= {hist_px_bank, hist_bin};
+        hist_wr_valid <= hist_rd_valid;
+        hist_wr_addr <= hist_rd_addr;
+        hist_wr_count <= hist_rd_count + 1;
+    end
+end
+
+// TREADY stalls are counted where TREADY is, in the stream clock, and
+// snapshotted at the TUSER beat of the next frame
+wire        stream_stall = out_stream_tvalid && !out_stream_tready;
+wire        stream_sof = out_stream_tvalid && out_stream_tready && out_stream_tuser;
+
+reg [31:0]  stream_stalls, stream_stalls_frame;
+
+always @(posedge out_stream_aclk) begin
+    if (!periph_resetn) begin
+        stream_stalls <= 0;
+        stream_stalls_frame <= 0;
+    end else if (stream_sof) begin
+        stream_stalls_frame <= stream_stalls;
+        stream_stalls <= 0;
+    end else if (stream_stall) begin
+        stream_stalls <= stream_stalls + 1;
+    end
+end
+
+// Commit latency: from the COMMIT toggle reaching this clock to the SOF
+// pixel of the frame that uses it entering the stream FIFO
+reg         latency_run, latency_applied;
+reg [31:0]  latency_count, commit_latency;
+
+always @(posedge compute_aclk) begin
+    if (pipeline_rst) begin
+        latency_run <= 0;
+        latency_applied <= 0;
+        latency_count <= 0;
+        commit_latency <= 0;
+    end else if (!latency_run) begin
+        if (commit_pending) begin
+            latency_run <= 1;
+            latency_applied <= 0;
+            latency_count <= 1;
+        end
+    end else begin
+        latency_count <= latency_count + 1;
+        if (commit_apply) begin
+            latency_applied <= 1;
+        end
+        if (latency_applied && pixel_valid && packer_ready && sof_for_packer) begin
+            commit_latency <= latency_count;
+            latency_run <= 0;
+        end
+    end
+end
+
+// -- Status registers (read-only, s_axi_lite_aclk domain) --
+// The per-frame snapshots of the compute domain cross as one bank through
+// cdc_snapshot, so every word, and both halves of FRAME_ITERS, come from
+// the same compute cycle. STREAM_STALLS has its own bank in the stream
+// clock.
+localparam PERF_BASE = 6;
+localparam PERF_COUNT = 9;
+localparam PASS_DONE_STATUS = PERF_BASE + PERF_COUNT;
+localparam PAN_COPIED_STATUS = PASS_DONE_STATUS + 1;
+localparam HIST_FRAME_STATUS = PAN_COPIED_STATUS + 1;
+localparam HIST_INTERIOR_STATUS = HIST_FRAME_STATUS + 1;
+// MAX_PIXEL_ITERS is max_iter as soon as one pixel is interior; this is
+// the highest count that escaped, which says how close max_iter is to
+// cutting off detail
+localparam HIST_MAX_ESCAPED_STATUS = HIST_INTERIOR_STATUS + 1;
+
+localparam SNAPSHOT_WIDTH = 16 * 32 + 1;
+
+wire [31:0] cardioid_hits_axi, cardioid_saved_axi, rebases_axi, glitches_axi;
+wire [31:0] perf_cycles_axi, perf_idle_axi, perf_max_iter_axi, commit_latency_axi;
+wire [63:0] perf_iterations_axi;
+wire [31:0] tile_filled_axi, tile_saved_axi, pan_copied_axi;
+wire [31:0] hist_frame_axi, hist_interior_axi, hist_max_escaped_axi;
+wire        hist_out_bank_axi;
+wire [31:0] stream_stalls_axi;
+
+cdc_snapshot #(.WIDTH(SNAPSHOT_WIDTH)) sync_status (
+    .src_clk(compute_aclk),
+    .src_rst(pipeline_rst),
+    .data_in({hist_out_bank, hist_max_escaped_out, hist_interior_out, hist_frame_out,
+              pan_copied_frame, tile_saved_frame, tile_filled_frame, commit_latency,
+              perf_max_iter_frame, perf_idle_frame, perf_iterations_frame, perf_cycles_frame,
+              glitches_frame, rebases_frame, cardioid_saved_frame, cardioid_hits_frame}),
+    .dest_clk(s_axi_lite_aclk),
+    .dest_rst(!axi_resetn),
+    .data_out({hist_out_bank_axi, hist_max_escaped_axi, hist_interior_axi, hist_frame_axi,
+               pan_copied_axi, tile_saved_axi, tile_filled_axi, commit_latency_axi,
+               perf_max_iter_axi, perf_idle_axi, perf_iterations_axi, perf_cycles_axi,
+               glitches_axi, rebases_axi, cardioid_saved_axi, cardioid_hits_axi})
+);
+
+cdc_snapshot #(.WIDTH(32)) sync_stream_stalls (
+    .src_clk(out_stream_aclk),
+    .src_rst(!periph_resetn),
+    .data_in(stream_stalls_frame),
+    .dest_clk(s_axi_lite_aclk),
+    .dest_rst(!axi_resetn),
+    .data_out(stream_stalls_axi)
+);
+
+assign status[0] = cardioid_hits_axi;
+assign status[1] = cardioid_saved_axi;
+assign status[2] = rebases_axi;
+assign status[3] = glitches_axi;
+assign status[4] = applied_frame_axi;
+
+// The frame counter crosses Gray-coded, so a read mid-increment is off by
+// at most one frame rather than torn
+wire [31:0] frame_number_gray_s;
+logic [31:0] frame_number_axi;
+
+cdc_synchronizer #(.WIDTH(32)) sync_frame_number (
+    .dest_clk(s_axi_lite_aclk),
+    .rst(!axi_resetn),
+    .data_in(frame_number_gray),
+    .data_out(frame_number_gray_s)
+);
+
+always_comb begin
+    frame_number_axi[31] = frame_number_gray_s[31];
+    for (int i = 30; i >= 0; i--) begin
+        frame_number_axi[i] = frame_number_axi[i + 1] ^ frame_number_gray_s[i];
+    end
+end
+
+assign status[5] = frame_number_axi;
+
+// Performance snapshots from 0x98 up
+assign status[PERF_BASE + 0] = perf_cycles_axi;
+assign status[PERF_BASE + 1] = perf_iterations_axi[31:0];
+assign status[PERF_BASE + 2] = perf_iterations_axi[63:32];
+assign status[PERF_BASE + 3] = stream_stalls_axi;
+assign status[PERF_BASE + 4] = perf_idle_axi;
+assign status[PERF_BASE + 5] = perf_max_iter_axi;
+assign status[PERF_BASE + 6] = commit_latency_axi;
+assign status[PERF_BASE + 7] = tile_filled_axi;
+assign status[PERF_BASE + 8] = tile_saved_axi;
+
+// Progressive passes streamed since the last commit, Gray-coded like the
+// frame counter. The scheduler steps it back to 0 one pass at a time after
+// a commit, so only one bit of the code ever changes at once.
+wire [2:0]  pass_done_gray = pass_done ^ (pass_done >> 1);
+wire [2:0]  pass_done_gray_s;
+
+cdc_synchronizer #(.WIDTH(3)) sync_pass_done (
+    .dest_clk(s_axi_lite_aclk),
+    .rst(!axi_resetn),
+    .data_in(pass_done_gray),
+    .data_out(pass_done_gray_s)
+);
+
+assign status[PASS_DONE_STATUS] = {29'h0, pass_done_gray_s[2],
+                                   ^pass_done_gray_s[2:1], ^pass_done_gray_s};
+
+assign status[PAN_COPIED_STATUS] = pan_copied_axi;
+assign status[HIST_FRAME_STATUS] = hist_frame_axi;
+assign status[HIST_INTERIOR_STATUS] = hist_interior_axi;
+assign status[HIST_MAX_ESCAPED_STATUS] = hist_max_escaped_axi;
+
+// The histogram is read from the hist_ram bank of the last copied frame;
+// the copy only writes the other one. The bank crosses in the same
+// snapshot as HIST_FRAME, so a host that reads HIST_FRAME before and after
+// the bins knows whether they all come from one frame.
+reg [31:0]  hist_axi_word;
+
+always @(posedge s_axi_lite_aclk) begin
+    hist_axi_word <= hist_ram[{hist_out_bank_axi, histAddr}];
+end
+
+assign hist_rdata = hist_axi_word;
+
+genvar st;
+generate
+    for (st = HIST_MAX_ESCAPED_STATUS + 1; st < STATUS_SIZE; st++) begin : status_unused
+        assign status[st] = 32'h0;
+    end
+endgenerate
+
+// -- Output stage --
+// color_mapper registers its input, so it is fed from the same mux that
+// loads pixel_iterations; r/g/b then always belong to the held pixel.
+wire        ordered_ready = (!pixel_valid || packer_ready) && !(ordered_sof && hist_copy_busy);
+assign      ordered_fire  = ordered_valid && ordered_ready;
+wire [31:0] color_iterations = ordered_fire ? ordered_iterations : pixel_iterations;
+// A pixel waiting for the packer keeps the max_iter it was computed with
+wire [31:0] color_max_iter = ordered_fire ? max_iter_s : pixel_max_iter;
+
+// A pending palette swap takes effect with the first pixel of a frame
+wire        palette_swap_apply = (palette_swap_req_s != palette_swap_ack) && ordered_fire && ordered_sof;
+wire [32:0] ordered_palette = palette_swap_apply ? palette_cfg_axi : palette_cfg_s;
+wire [32:0] color_palette = ordered_fire ? ordered_palette : pixel_palette;
+
+always @(posedge compute_aclk) begin
+    if (pipeline_rst) begin
+        palette_cfg_s <= palette_cfg_axi;
+        palette_swap_ack <= palette_swap_req_s;
+    end else if (palette_swap_apply) begin
+        palette_cfg_s <= palette_cfg_axi;
+        palette_swap_ack <= !palette_swap_ack;
+    end
+end
+
+// The stream format is chosen when pixel (0, 0) leaves the reorder buffer,
+// so the VDMA never sees a frame that changes beat count part way through
+wire        ordered_ext = ordered_sof ? ctrl_s[CTRL_EXT_STREAM] : frame_ext;
+// Raw counts, two pixels per beat; EXT_STREAM wins if both are set
+wire        ordered_raw = ordered_sof ? (ctrl_s[CTRL_RAW_STREAM] && !ctrl_s[CTRL_EXT_STREAM]) : frame_raw;
+
+always @(posedge compute_aclk) begin
+    if (pipeline_rst) begin
+        pixel_valid <= 0;
+        pixel_iterations <= 0;
+        pixel_magnitude <= 0;
+        pixel_max_iter <= 0;
+        pixel_palette <= 0;
+        pixel_ext <= 0;
+        frame_ext <= 0;
+        pixel_raw <= 0;
+        frame_raw <= 0;
+        sof_for_packer <= 0;
+        eol_for_packer <= 0;
+    end else begin
+        if (ordered_fire) begin
+            pixel_valid <= 1;
+            pixel_iterations <= ordered_iterations;
+            pixel_magnitude <= ordered_magnitude;
+            pixel_max_iter <= max_iter_s;
+            pixel_palette <= ordered_palette;
+            pixel_ext <= ordered_ext;
+            frame_ext <= ordered_ext;
+            pixel_raw <= ordered_raw;
+            frame_raw <= ordered_raw;
+            sof_for_packer <= ordered_sof;
+            eol_for_packer <= ordered_eol;
+        end else if (packer_ready) begin
+            pixel_valid <= 0;
+        end
     end
 end
 
 // --- DEBUG
-// always @(posedge out_stream_aclk) begin
+// always @(posedge compute_aclk) begin
 //     // Only print on the first or last pixel of a line to reduce noise
-//     if ( (pixel_valid && packer_ready) && (sof_for_packer || lastx) ) begin
-//         $display("[%0t] PIXEL_GEN: Handshake for interesting pixel! (x=%0d, y=%0d). sof_for_packer=%b, lastx=%b, lasty=%b, tlast=%b",
-//                  $time, x, y, sof_for_packer, lastx, lasty, out_stream_tlast);
+//     if ( (pixel_valid && packer_ready) && (sof_for_packer || eol_for_packer) ) begin
+//         $display("[%0t] PIXEL_GEN: Handshake for interesting pixel! sof_for_packer=%b, eol_for_packer=%b, tlast=%b",
+//                  $time, sof_for_packer, eol_for_packer, out_stream_tlast);
 //     end
 // end
 
 // -- Module Instantiations --
 
-screen_mapper sm_inst (
-    .x(x), .y(y),
+// One scheduler owns each frame. CTRL only changes at a commit, which waits
+// at pixel (0, 0) for the active one to drain, so the others are always
+// parked at the start of a frame when one takes over. The progressive and
+// pan schedulers keep no |z|^2, so their frames carry a magnitude of 0.
+// Only the raster scheduler follows WIDTH/HEIGHT; the others need the
+// native frame size. Every one of them can run with CTRL_SCALE_EN.
+assign sched = !frame_native                                            ? SCHED_RASTER :
+               (PROGRESSIVE_ENGINE != 0 && ctrl_s[CTRL_PROGRESSIVE_EN]) ? SCHED_PROG :
+               (TILE_ENGINE != 0 && ctrl_s[CTRL_TILE_EN])               ? SCHED_TILE :
+               (PAN_ENGINE != 0 && (ctrl_s[CTRL_PAN_REUSE_EN] ||
+                                    ctrl_s[CTRL_MIRROR_EN]))            ? SCHED_PAN :
+                                                                          SCHED_RASTER;
+
+wire        sched_issue_valid [SCHED_COUNT-1:0];
+wire [COORD_WIDTH-1:0] sched_issue_x [SCHED_COUNT-1:0];
+wire [COORD_WIDTH-1:0] sched_issue_y [SCHED_COUNT-1:0];
+wire [ROB_TAG_WIDTH-1:0] sched_issue_tag [SCHED_COUNT-1:0];
+wire        sched_out_valid [SCHED_COUNT-1:0];
+wire [31:0] sched_out_iterations [SCHED_COUNT-1:0];
+wire [31:0] sched_out_magnitude [SCHED_COUNT-1:0];
+wire        sched_out_sof [SCHED_COUNT-1:0];
+wire        sched_out_eol [SCHED_COUNT-1:0];
+wire        sched_idle_each [SCHED_COUNT-1:0];
+
+assign issue_valid        = sched_issue_valid[sched];
+assign issue_x            = sched_issue_x[sched];
+assign issue_y            = sched_issue_y[sched];
+assign issue_tag          = sched_issue_tag[sched];
+assign ordered_valid      = sched_out_valid[sched];
+assign ordered_iterations = sched_out_iterations[sched];
+assign ordered_magnitude  = sched_out_magnitude[sched];
+assign ordered_sof        = sched_out_sof[sched];
+assign ordered_eol        = sched_out_eol[sched];
+assign sched_idle         = sched_idle_each[sched];
+
+assign sched_issue_first[SCHED_RASTER] = (sched_issue_x[SCHED_RASTER] == 0 &&
+                                          sched_issue_y[SCHED_RASTER] == 0);
+
+raster_scheduler #(
+    .MAX_WIDTH(MAX_WIDTH), .MAX_HEIGHT(MAX_HEIGHT), .ROB_DEPTH(ROB_DEPTH)
+) sched_inst (
+    .clk(compute_aclk), .rst(pipeline_rst),
+    .width(frame_width), .height(frame_height),
+    .issue_valid(sched_issue_valid[SCHED_RASTER]),
+    .issue_ready(issue_ready && sched == SCHED_RASTER),
+    .issue_x(sched_issue_x[SCHED_RASTER]), .issue_y(sched_issue_y[SCHED_RASTER]),
+    .issue_tag(sched_issue_tag[SCHED_RASTER]),
+    .result_valid(result_valid && sched == SCHED_RASTER), .result_tag(result_tag),
+    .result_iterations(result_iterations), .result_magnitude(result_magnitude),
+    .out_valid(sched_out_valid[SCHED_RASTER]), .out_ready(ordered_ready && sched == SCHED_RASTER),
+    .out_iterations(sched_out_iterations[SCHED_RASTER]),
+    .out_magnitude(sched_out_magnitude[SCHED_RASTER]),
+    .out_sof(sched_out_sof[SCHED_RASTER]), .out_eol(sched_out_eol[SCHED_RASTER]),
+    .idle(sched_idle_each[SCHED_RASTER])
+);
+
+generate
+    if (TILE_ENGINE != 0) begin : tile_engine
+        wire [9:0] native_x, native_y;
+
+        assign sched_issue_x[SCHED_TILE] = COORD_WIDTH'(native_x);
+        assign sched_issue_y[SCHED_TILE] = COORD_WIDTH'(native_y);
+
+        tile_scheduler #(
+            .X_SIZE(X_SIZE), .Y_SIZE(Y_SIZE), .ROB_DEPTH(ROB_DEPTH), .TILE(TILE_SIZE)
+        ) tile_inst (
+            .clk(compute_aclk), .rst(pipeline_rst),
+            .issue_valid(sched_issue_valid[SCHED_TILE]),
+            .issue_ready(issue_ready && sched == SCHED_TILE),
+            .issue_x(native_x), .issue_y(native_y),
+            .issue_tag(sched_issue_tag[SCHED_TILE]),
+            .issue_first(sched_issue_first[SCHED_TILE]),
+            .result_valid(result_valid && sched == SCHED_TILE), .result_tag(result_tag),
+            .result_iterations(result_iterations), .result_magnitude(result_magnitude),
+            .out_valid(sched_out_valid[SCHED_TILE]), .out_ready(ordered_ready && sched == SCHED_TILE),
+            .out_iterations(sched_out_iterations[SCHED_TILE]),
+            .out_magnitude(sched_out_magnitude[SCHED_TILE]),
+            .out_sof(sched_out_sof[SCHED_TILE]), .out_eol(sched_out_eol[SCHED_TILE]),
+            .idle(sched_idle_each[SCHED_TILE]),
+            .fill_valid(tile_fill_valid), .fill_iterations(tile_fill_iterations)
+        );
+    end else begin : no_tile_engine
+        assign sched_issue_valid[SCHED_TILE] = 1'b0;
+        assign sched_issue_x[SCHED_TILE] = '0;
+        assign sched_issue_y[SCHED_TILE] = '0;
+        assign sched_issue_tag[SCHED_TILE] = '0;
+        assign sched_issue_first[SCHED_TILE] = 1'b0;
+        assign sched_out_valid[SCHED_TILE] = 1'b0;
+        assign sched_out_iterations[SCHED_TILE] = '0;
+        assign sched_out_magnitude[SCHED_TILE] = '0;
+        assign sched_out_sof[SCHED_TILE] = 1'b0;
+        assign sched_out_eol[SCHED_TILE] = 1'b0;
+        assign sched_idle_each[SCHED_TILE] = 1'b1;
+        assign tile_fill_valid = 1'b0;
+        assign tile_fill_iterations = '0;
+    end
+endgenerate
+
+assign sched_out_magnitude[SCHED_PROG] = '0;
+
+generate
+    if (PROGRESSIVE_ENGINE != 0) begin : progressive_engine
+        wire [9:0] native_x, native_y;
+
+        assign sched_issue_x[SCHED_PROG] = COORD_WIDTH'(native_x);
+        assign sched_issue_y[SCHED_PROG] = COORD_WIDTH'(native_y);
+
+        progressive_scheduler #(
+            .X_SIZE(X_SIZE), .Y_SIZE(Y_SIZE), .ROB_DEPTH(ROB_DEPTH)
+        ) prog_inst (
+            .clk(compute_aclk), .rst(pipeline_rst),
+            .restart(commit_apply),
+            .issue_valid(sched_issue_valid[SCHED_PROG]),
+            .issue_ready(issue_ready && sched == SCHED_PROG),
+            .issue_x(native_x), .issue_y(native_y),
+            .issue_tag(sched_issue_tag[SCHED_PROG]),
+            .issue_first(sched_issue_first[SCHED_PROG]),
+            .result_valid(result_valid && sched == SCHED_PROG), .result_tag(result_tag),
+            .result_iterations(result_iterations),
+            .out_valid(sched_out_valid[SCHED_PROG]), .out_ready(ordered_ready && sched == SCHED_PROG),
+            .out_iterations(sched_out_iterations[SCHED_PROG]),
+            .out_sof(sched_out_sof[SCHED_PROG]), .out_eol(sched_out_eol[SCHED_PROG]),
+            .idle(sched_idle_each[SCHED_PROG]),
+            .pass_done(pass_done)
+        );
+    end else begin : no_progressive_engine
+        assign sched_issue_valid[SCHED_PROG] = 1'b0;
+        assign sched_issue_x[SCHED_PROG] = '0;
+        assign sched_issue_y[SCHED_PROG] = '0;
+        assign sched_issue_tag[SCHED_PROG] = '0;
+        assign sched_issue_first[SCHED_PROG] = 1'b0;
+        assign sched_out_valid[SCHED_PROG] = 1'b0;
+        assign sched_out_iterations[SCHED_PROG] = '0;
+        assign sched_out_sof[SCHED_PROG] = 1'b0;
+        assign sched_out_eol[SCHED_PROG] = 1'b0;
+        assign sched_idle_each[SCHED_PROG] = 1'b1;
+        assign pass_done = '0;
+    end
+endgenerate
+
+// The iteration buffer only holds counts, 4 bytes per pixel, written and
+// read in INCR bursts
+assign sched_out_magnitude[SCHED_PAN] = '0;
+assign m_axi_ibuf_awsize  = 3'b010;
+assign m_axi_ibuf_awburst = 2'b01;
+assign m_axi_ibuf_awcache = 4'b0011;
+assign m_axi_ibuf_awprot  = 3'b000;
+assign m_axi_ibuf_wstrb   = 4'hF;
+assign m_axi_ibuf_arsize  = 3'b010;
+assign m_axi_ibuf_arburst = 2'b01;
+assign m_axi_ibuf_arcache = 4'b0011;
+assign m_axi_ibuf_arprot  = 3'b000;
+
+generate
+    if (PAN_ENGINE != 0) begin : pan_engine
+        wire [9:0] native_x, native_y;
+
+        assign sched_issue_x[SCHED_PAN] = COORD_WIDTH'(native_x);
+        assign sched_issue_y[SCHED_PAN] = COORD_WIDTH'(native_y);
+
+        pan_scheduler #(
+            .X_SIZE(X_SIZE), .Y_SIZE(Y_SIZE), .ROB_DEPTH(ROB_DEPTH)
+        ) pan_inst (
+            .clk(compute_aclk), .rst(pipeline_rst),
+            .active(sched == SCHED_PAN),
+            .restart(commit_apply),
+            .reuse(ctrl_s[CTRL_PAN_REUSE_EN]),
+            .mirror(ctrl_s[CTRL_MIRROR_EN] && view_symmetric),
+            .shift_x(pan_shift_s[15:0]), .shift_y(pan_shift_s[31:16]),
+            .buffer_base(ibuf_addr_s),
+            .issue_valid(sched_issue_valid[SCHED_PAN]),
+            .issue_ready(issue_ready && sched == SCHED_PAN),
+            .issue_x(native_x), .issue_y(native_y),
+            .issue_tag(sched_issue_tag[SCHED_PAN]),
+            .issue_first(sched_issue_first[SCHED_PAN]),
+            .result_valid(result_valid && sched == SCHED_PAN), .result_tag(result_tag),
+            .result_iterations(result_iterations),
+            .out_valid(sched_out_valid[SCHED_PAN]), .out_ready(ordered_ready && sched == SCHED_PAN),
+            .out_iterations(sched_out_iterations[SCHED_PAN]),
+            .out_sof(sched_out_sof[SCHED_PAN]), .out_eol(sched_out_eol[SCHED_PAN]),
+            .idle(sched_idle_each[SCHED_PAN]),
+            .copy_valid(pan_copy_valid),
+            .m_axi_awaddr(m_axi_ibuf_awaddr), .m_axi_awlen(m_axi_ibuf_awlen),
+            .m_axi_awvalid(m_axi_ibuf_awvalid), .m_axi_awready(m_axi_ibuf_awready),
+            .m_axi_wdata(m_axi_ibuf_wdata), .m_axi_wlast(m_axi_ibuf_wlast),
+            .m_axi_wvalid(m_axi_ibuf_wvalid), .m_axi_wready(m_axi_ibuf_wready),
+            .m_axi_bvalid(m_axi_ibuf_bvalid), .m_axi_bready(m_axi_ibuf_bready),
+            .m_axi_araddr(m_axi_ibuf_araddr), .m_axi_arlen(m_axi_ibuf_arlen),
+            .m_axi_arvalid(m_axi_ibuf_arvalid), .m_axi_arready(m_axi_ibuf_arready),
+            .m_axi_rdata(m_axi_ibuf_rdata), .m_axi_rvalid(m_axi_ibuf_rvalid),
+            .m_axi_rready(m_axi_ibuf_rready)
+        );
+    end else begin : no_pan_engine
+        assign sched_issue_valid[SCHED_PAN] = 1'b0;
+        assign sched_issue_x[SCHED_PAN] = '0;
+        assign sched_issue_y[SCHED_PAN] = '0;
+        assign sched_issue_tag[SCHED_PAN] = '0;
+        assign sched_issue_first[SCHED_PAN] = 1'b0;
+        assign sched_out_valid[SCHED_PAN] = 1'b0;
+        assign sched_out_iterations[SCHED_PAN] = '0;
+        assign sched_out_sof[SCHED_PAN] = 1'b0;
+        assign sched_out_eol[SCHED_PAN] = 1'b0;
+        assign sched_idle_each[SCHED_PAN] = 1'b1;
+        assign pan_copy_valid = 1'b0;
+        assign m_axi_ibuf_awaddr = '0;
+        assign m_axi_ibuf_awlen = '0;
+        assign m_axi_ibuf_awvalid = 1'b0;
+        assign m_axi_ibuf_wdata = '0;
+        assign m_axi_ibuf_wlast = 1'b0;
+        assign m_axi_ibuf_wvalid = 1'b0;
+        assign m_axi_ibuf_bready = 1'b1;
+        assign m_axi_ibuf_araddr = '0;
+        assign m_axi_ibuf_arlen = '0;
+        assign m_axi_ibuf_arvalid = 1'b0;
+        assign m_axi_ibuf_rready = 1'b1;
+    end
+endgenerate
+
+screen_mapper #(
+    .COORD_WIDTH(COORD_WIDTH)
+) sm_inst (
+    .x(issue_x), .y(issue_y),
+    .width(frame_width), .height(frame_height),
     .pan_x(pan_x_s), .pan_y(pan_y_s), 
     .zoom(zoom_s[7:0]), 
-    .c_re(c_re), .c_im(c_im)
+    .c_re(mapped_re), .c_im(mapped_im)
 );
 
-mandelbrot_calculator mb_inst (
-    .clk(out_stream_aclk), .rst(!periph_resetn),
-    .start(start_mandel),
-    .ready(mandel_ready),
-    .c_re(c_re), .c_im(c_im), .max_iter(max_iter_s),
-    .iterations(iterations)
+screen_mapper #(
+    .DATA_WIDTH(WIDE_DATA_WIDTH), .FRAC_WIDTH(WIDE_FRAC_WIDTH), .COORD_WIDTH(COORD_WIDTH)
+) sm_wide_inst (
+    .x(issue_x), .y(issue_y),
+    .width(frame_width), .height(frame_height),
+    .pan_x(WIDE_DATA_WIDTH'(pan_x_wide_s)), .pan_y(WIDE_DATA_WIDTH'(pan_y_wide_s)),
+    .zoom(zoom_s[7:0]),
+    .c_re(mapped_re_wide), .c_im(mapped_im_wide)
 );
 
-color_mapper cm_inst (
-    .clk(out_stream_aclk),
-    .iterations_in(iterations),
+// CTRL_SCALE_EN: c is ORIGIN plus DX per pixel and DY per line, at any
+// scale, rotation or shear, for the pixel being issued whichever scheduler
+// issues it. The Q8.56 sum is exact, so the Q4.28 path just truncates it.
+// Perturbation frames keep ZOOM.
+coord_generator #(
+    .DATA_WIDTH(64), .COORD_WIDTH(COORD_WIDTH)
+) coord_inst (
+    .x(issue_x), .y(issue_y),
+    .origin_re(origin_re_s), .origin_im(origin_im_s),
+    .dx_re(dx_re_s), .dx_im(dx_im_s), .dy_re(dy_re_s), .dy_im(dy_im_s),
+    .c_re(stepped_re), .c_im(stepped_im)
+);
+
+assign pixel_re      = ctrl_s[CTRL_SCALE_EN] ? stepped_re[59:28] : mapped_re;
+assign pixel_im      = ctrl_s[CTRL_SCALE_EN] ? stepped_im[59:28] : mapped_im;
+assign pixel_re_wide = ctrl_s[CTRL_SCALE_EN] ? WIDE_DATA_WIDTH'(stepped_re) : mapped_re_wide;
+assign pixel_im_wide = ctrl_s[CTRL_SCALE_EN] ? WIDE_DATA_WIDTH'(stepped_im) : mapped_im_wide;
+
+calculator_array #(
+    .ENGINE(CALC_ENGINE), .LANES(LANES), .TAG_WIDTH(ROB_TAG_WIDTH),
+    .SQUARE_KERNEL(SQUARE_KERNEL),
+    .WIDE_LANES(WIDE_LANES), .WIDE_DATA_WIDTH(WIDE_DATA_WIDTH), .WIDE_FRAC_WIDTH(WIDE_FRAC_WIDTH),
+    .PERTURB_LANES(PERTURB_LANES), .ORBIT_DEPTH(ORBIT_DEPTH)
+) calc_inst (
+    .clk(compute_aclk), .rst(pipeline_rst),
+    .issue_valid(issue_valid && !issue_hold), .issue_ready(calc_ready),
+    .issue_c_re(c_re), .issue_c_im(c_im), .issue_tag(issue_tag),
+    .issue_z0_re(z0_re), .issue_z0_im(z0_im),
+    .issue_wide(issue_wide), .issue_c_re_wide(c_re_wide), .issue_c_im_wide(c_im_wide),
+    .issue_z0_re_wide(z0_re_wide), .issue_z0_im_wide(z0_im_wide),
+    .issue_perturb(issue_perturb),
+    .issue_dc_re(dc_re), .issue_dc_im(dc_im), .issue_dc_exp(dc_exp),
+    .issue_first(issue_first),
     .max_iter(max_iter_s),
+    // The cardioid and bulb are Mandelbrot regions; Julia pixels always iterate
+    .shortcut_en(ctrl_s[CTRL_CARDIOID_EN] && !issue_julia),
+    .period_en(ctrl_s[CTRL_PERIOD_EN]),
+    .period_eps(period_eps_s),
+    .ref_len(orbit_len_s),
+    .orbit_wclk(s_axi_lite_aclk), .orbit_we(orbit_we),
+    .orbit_waddr(orbit_waddr), .orbit_wdata(orbit_wdata),
+    .result_valid(result_valid), .result_tag(result_tag),
+    .result_iterations(result_iterations), .result_magnitude(result_magnitude),
+    .shortcut_hit(shortcut_hit), .issued_first(shortcut_first),
+    .rebase_count(rebase_count), .glitch_count(glitch_count)
+);
+
+color_mapper #(
+    .PALETTE_AWIDTH(PALETTE_AWIDTH)
+) cm_inst (
+    .clk(compute_aclk),
+    .iterations_in(color_iterations),
+    .max_iter(color_max_iter),
+    .palette_en(color_palette[31]),
+    .palette_bank(color_palette[32]),
+    .palette_scale(color_palette[15:0]),
+    .palette_offset(color_palette[16+:PALETTE_AWIDTH]),
+    .palette_wclk(s_axi_lite_aclk),
+    .palette_we(palette_we),
+    .palette_waddr(palette_waddr),
+    .palette_wdata(palette_wdata),
     .r(r), .g(g), .b(b)
 );
 
+// -- Stream clock crossing --
+// Everything packer needs for a pixel crosses as one FIFO word, so the
+// calculators run at compute_aclk and the VDMA at out_stream_aclk.
+localparam OUT_FIFO_WIDTH = 24 + 32 + 32 + 4;
+
+wire        stream_valid;
+wire        stream_ready;
+wire [7:0]  stream_r, stream_g, stream_b;
+wire [31:0] stream_iterations, stream_magnitude;
+wire        stream_ext, stream_raw, stream_sof, stream_eol;
+
+async_fifo #(
+    .WIDTH(OUT_FIFO_WIDTH), .ADDR_WIDTH(OUT_FIFO_AWIDTH)
+) out_fifo (
+    .wclk(compute_aclk), .wrst(pipeline_rst),
+    .w_valid(pixel_valid), .w_ready(packer_ready),
+    .w_data({r, g, b, pixel_iterations, pixel_magnitude,
+             pixel_ext, pixel_raw, sof_for_packer, eol_for_packer}),
+    .rclk(out_stream_aclk), .rrst(!periph_resetn),
+    .r_valid(stream_valid), .r_ready(stream_ready),
+    .r_data({stream_r, stream_g, stream_b, stream_iterations, stream_magnitude,
+             stream_ext, stream_raw, stream_sof, stream_eol})
+);
+
 packer pixel_packer(
     .aclk(out_stream_aclk),
     .aresetn(periph_resetn),
-    .r(r), .g(g), .b(b),
-    .eol(eol_for_packer), 
-    .in_stream_ready(packer_ready), 
-    .valid(pixel_valid), 
-    .sof(sof_for_packer),
+    .r(stream_r), .g(stream_g), .b(stream_b),
+    .ext(stream_ext),
+    .raw(stream_raw),
+    .iterations(stream_iterations), .magnitude(stream_magnitude),
+    .eol(stream_eol), 
+    .in_stream_ready(stream_ready), 
+    .valid(stream_valid), 
+    .sof(stream_sof),
     .out_stream_tdata(out_stream_tdata), 
     .out_stream_tkeep(out_stream_tkeep),
     .out_stream_tlast(out_stream_tlast), 
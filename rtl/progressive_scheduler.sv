@@ -0,0 +1,296 @@
+module progressive_scheduler #(
+    parameter X_SIZE     = 640,
+    parameter Y_SIZE     = 480,
+    parameter ROB_DEPTH  = 16,
+    // Sample spacing of the first pass; each later pass halves it
+    parameter COARSE     = 8,
+    // Samples on this grid are kept for reuse by later passes. 2 reuses
+    // every earlier sample; 4 stores a quarter as much and recomputes the
+    // 1/2 pass samples in the full pass.
+    parameter STORE_STEP = 4,
+    localparam TAG_WIDTH = $clog2(ROB_DEPTH)
+)(
+    input                           clk,
+    input                           rst,
+
+    // Start again from the coarsest pass. Only asserted at pixel (0, 0).
+    input                           restart,
+
+    // Issue side, same handshake as raster_scheduler
+    output logic                    issue_valid,
+    input                           issue_ready,
+    output logic [9:0]              issue_x,
+    output logic [9:0]              issue_y,
+    output logic [TAG_WIDTH-1:0]    issue_tag,
+    output logic                    issue_first,
+
+    // Results coming back from the calculators, in any order
+    input                           result_valid,
+    input      [TAG_WIDTH-1:0]      result_tag,
+    input      [31:0]               result_iterations,
+
+    // In-order pixel stream, one full frame per pass
+    output logic                    out_valid,
+    input                           out_ready,
+    output logic [31:0]             out_iterations,
+    output logic                    out_sof,
+    output logic                    out_eol,
+
+    // No pixel is being computed or waiting to be streamed
+    output logic                    idle,
+
+    // Passes fully streamed since the last restart, saturating at the
+    // full-resolution pass
+    output logic [2:0]              pass_done
+);
+
+    // Pass p computes one sample every STEP = COARSE >> p pixels in both
+    // directions and streams a full frame with each sample repeated over
+    // its STEP x STEP block. Samples on the grid of the previous pass are
+    // read back from the store instead of being issued again, apart from
+    // (0, 0), which every frame issues first.
+    //
+    // A sample row is collected in a row buffer, then streamed STEP times
+    // while the next sample row is computed into the other buffer.
+
+    localparam COARSE_LS   = $clog2(COARSE);
+    localparam LEVELS      = COARSE_LS + 1;
+    localparam LEVEL_WIDTH = $clog2(LEVELS);
+    localparam LS_WIDTH    = $clog2(COARSE_LS + 1);
+    localparam ROW_AWIDTH  = $clog2(X_SIZE);
+    localparam STORE_LS    = $clog2(STORE_STEP);
+    localparam STORE_W     = X_SIZE / STORE_STEP;
+    localparam STORE_SIZE  = STORE_W * (Y_SIZE / STORE_STEP);
+    localparam STORE_AWIDTH = $clog2(STORE_SIZE);
+
+    localparam [1:0] S_ISSUE = 2'd0;   // Walk the sample row
+    localparam [1:0] S_WAIT  = 2'd1;   // Wait for its results
+    localparam [1:0] S_ROW   = 2'd2;   // Hand it to the output side
+
+    function automatic [9:0] level_step(input [LEVEL_WIDTH-1:0] lvl);
+        level_step = 10'(COARSE) >> lvl;
+    endfunction
+
+    // Computed in an earlier pass and kept in the store
+    function automatic reused(input [LEVEL_WIDTH-1:0] lvl, input [9:0] x0, input [9:0] y0);
+        logic [10:0] prev_step = 11'(level_step(lvl)) << 1;
+        reused = (lvl != 0) && !(x0 == 0 && y0 == 0) &&
+                 (({1'b0, x0 | y0} & (prev_step - 1'b1)) == 0) &&
+                 (prev_step >= 11'(STORE_STEP));
+    endfunction
+
+    function automatic stored(input [9:0] x0, input [9:0] y0);
+        stored = ((x0 | y0) & 10'(STORE_STEP - 1)) == 0;
+    endfunction
+
+    function automatic [STORE_AWIDTH-1:0] store_addr(input [9:0] x0, input [9:0] y0);
+        store_addr = STORE_AWIDTH'((y0 >> STORE_LS) * STORE_W + (x0 >> STORE_LS));
+    endfunction
+
+    reg [1:0]               state;
+    reg [LEVEL_WIDTH-1:0]   level;
+    reg [9:0]               row;        // Frame row of the sample row
+    reg [9:0]               walk_x;
+
+    wire [LS_WIDTH-1:0]     ls   = LS_WIDTH'(COARSE_LS) - LS_WIDTH'(level);
+    wire [9:0]              step = level_step(level);
+    wire                    skip = reused(level, walk_x, row);
+    wire                    walk_last = (walk_x == 10'(X_SIZE) - step);
+
+    // -- Tags --
+    reg [ROB_DEPTH-1:0]     tag_busy;
+    reg [ROW_AWIDTH-1:0]    tag_index [ROB_DEPTH-1:0];
+    reg                     tag_store [ROB_DEPTH-1:0];
+    reg [STORE_AWIDTH-1:0]  tag_saddr [ROB_DEPTH-1:0];
+    logic [TAG_WIDTH-1:0]   free_tag;
+    logic                   free_any;
+
+    always_comb begin
+        free_tag = '0;
+        free_any = 1'b0;
+        for (int t = ROB_DEPTH - 1; t >= 0; t--) begin
+            if (!tag_busy[t]) begin
+                free_tag = TAG_WIDTH'(t);
+                free_any = 1'b1;
+            end
+        end
+    end
+
+    assign issue_valid = (state == S_ISSUE) && !skip && free_any;
+    assign issue_x     = walk_x;
+    assign issue_y     = row;
+    assign issue_tag   = free_tag;
+    assign issue_first = (state == S_ISSUE) && (row == 0) && (walk_x == 0);
+
+    wire issue_fire = issue_valid && issue_ready;
+
+    // -- Output side --
+    reg                     compute_bank, emit_bank;
+    reg                     emit_active, emit_primed;
+    reg [LEVEL_WIDTH-1:0]   emit_level;
+    reg [9:0]               emit_y0, emit_dy, emit_x;
+
+    wire [9:0]              emit_step = level_step(emit_level);
+    wire                    retire_fire = out_valid && out_ready;
+    wire                    emit_row_end = (emit_x == 10'(X_SIZE - 1));
+    wire                    emit_last = emit_row_end && (emit_dy == emit_step - 1);
+
+    // The buffers are read one clock ahead, at the pixel shown next
+    wire [9:0]              read_x  = !retire_fire ? emit_x : (emit_row_end ? 10'd0 : emit_x + 1'b1);
+    wire [9:0]              read_x0 = read_x & ~(emit_step - 1'b1);
+    wire                    read_reused = reused(emit_level, read_x0, emit_y0);
+    wire [ROW_AWIDTH-1:0]   read_index = ROW_AWIDTH'(read_x >> (LS_WIDTH'(COARSE_LS) - LS_WIDTH'(emit_level)));
+
+    // -- Sample store --
+    reg [31:0]  store_mem [STORE_SIZE-1:0];
+    reg [31:0]  store_q;
+    reg         q_reused;
+
+    always_ff @(posedge clk) begin
+        if (result_valid && tag_store[result_tag]) begin
+            store_mem[tag_saddr[result_tag]] <= result_iterations;
+        end
+        store_q <= store_mem[store_addr(read_x0, emit_y0)];
+        q_reused <= read_reused;
+    end
+
+    // -- Row buffers --
+    wire [31:0] row_q [1:0];
+
+    genvar b;
+    generate
+        for (b = 0; b < 2; b++) begin : row_buffer
+            reg [31:0] mem [X_SIZE-1:0];
+            reg [31:0] q;
+
+            always_ff @(posedge clk) begin
+                if (result_valid && compute_bank == 1'(b)) begin
+                    mem[tag_index[result_tag]] <= result_iterations;
+                end
+                q <= mem[read_index];
+            end
+
+            assign row_q[b] = q;
+        end
+    endgenerate
+
+    assign out_valid      = emit_active && emit_primed;
+    assign out_iterations = q_reused ? store_q : row_q[emit_bank];
+    assign out_sof        = (emit_y0 == 0) && (emit_dy == 0) && (emit_x == 0);
+    assign out_eol        = emit_row_end;
+
+    assign idle = (tag_busy == 0) && !emit_active;
+
+    // PASS_DONE crosses to the AXI clock Gray-coded, so it may only ever
+    // step by one. A restart counts it back down a step per clock instead
+    // of clearing it; no pass can finish that quickly after one.
+    reg pass_rewind;
+    wire pass_finished = emit_active && retire_fire && emit_last &&
+                         (emit_y0 == 10'(Y_SIZE) - emit_step);
+
+    always_ff @(posedge clk) begin
+        if (rst) begin
+            pass_done   <= '0;
+            pass_rewind <= 1'b0;
+        end else if (restart || pass_rewind) begin
+            pass_rewind <= (pass_done > 1);
+            if (pass_done != 0) begin
+                pass_done <= pass_done - 1'b1;
+            end
+        end else if (pass_finished && pass_done != 3'(LEVELS)) begin
+            pass_done <= pass_done + 1'b1;
+        end
+    end
+
+    always_ff @(posedge clk) begin
+        if (rst) begin
+            emit_active <= 1'b0;
+            emit_primed <= 1'b0;
+            emit_bank   <= 1'b1;
+            emit_level  <= '0;
+            emit_y0     <= '0;
+            emit_dy     <= '0;
+            emit_x      <= '0;
+        end else if (state == S_ROW && !emit_active) begin
+            emit_active <= 1'b1;
+            emit_primed <= 1'b0;
+            emit_bank   <= compute_bank;
+            emit_level  <= level;
+            emit_y0     <= row;
+            emit_dy     <= '0;
+            emit_x      <= '0;
+        end else if (emit_active) begin
+            emit_primed <= 1'b1;
+            if (retire_fire) begin
+                emit_x <= emit_row_end ? 10'd0 : emit_x + 1'b1;
+                if (emit_row_end) begin
+                    emit_dy <= emit_dy + 1'b1;
+                end
+                if (emit_last) begin
+                    emit_active <= 1'b0;
+                    emit_primed <= 1'b0;
+                end
+            end
+        end
+    end
+
+    // -- Compute side --
+    always_ff @(posedge clk) begin
+        if (rst) begin
+            state        <= S_ISSUE;
+            level        <= '0;
+            row          <= '0;
+            walk_x       <= '0;
+            tag_busy     <= '0;
+            compute_bank <= 1'b0;
+        end else begin
+            if (issue_fire) begin
+                tag_index[free_tag] <= ROW_AWIDTH'(walk_x >> ls);
+                tag_store[free_tag] <= stored(walk_x, row);
+                tag_saddr[free_tag] <= store_addr(walk_x, row);
+            end
+            tag_busy <= (tag_busy | (issue_fire ? ROB_DEPTH'(1) << free_tag : '0)) &
+                        ~(result_valid ? ROB_DEPTH'(1) << result_tag : '0);
+
+            case (state)
+                S_ISSUE: begin
+                    if (skip || issue_fire) begin
+                        walk_x <= walk_x + step;
+                        if (walk_last) begin
+                            state <= S_WAIT;
+                        end
+                    end
+                end
+
+                S_WAIT: begin
+                    if (tag_busy == 0) begin
+                        state <= S_ROW;
+                    end
+                end
+
+                S_ROW: begin
+                    if (!emit_active) begin
+                        compute_bank <= !compute_bank;
+                        walk_x <= '0;
+                        if (row == 10'(Y_SIZE) - step) begin
+                            row <= '0;
+                            if (level != LEVEL_WIDTH'(LEVELS - 1)) begin
+                                level <= level + 1'b1;
+                            end
+                        end else begin
+                            row <= row + step;
+                        end
+                        state <= S_ISSUE;
+                    end
+                end
+
+                default: state <= S_ISSUE;
+            endcase
+
+            if (restart) begin
+                level <= '0;
+            end
+        end
+    end
+
+endmodule
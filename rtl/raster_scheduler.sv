@@ -0,0 +1,113 @@
+module raster_scheduler #(
+    // Largest frame the counters can walk; the actual size comes from
+    // width/height and may only change while the scheduler is idle at (0, 0)
+    parameter MAX_WIDTH  = 1920,
+    parameter MAX_HEIGHT = 1080,
+    parameter ROB_DEPTH  = 16,
+    localparam COORD_WIDTH = $clog2(MAX_WIDTH > MAX_HEIGHT ? MAX_WIDTH : MAX_HEIGHT),
+    localparam TAG_WIDTH = $clog2(ROB_DEPTH)
+)(
+    input                           clk,
+    input                           rst,
+
+    // Frame size, 1 to MAX_WIDTH x 1 to MAX_HEIGHT
+    input      [COORD_WIDTH-1:0]    width,
+    input      [COORD_WIDTH-1:0]    height,
+
+    // Issue side: next pixel in raster order, tagged with its ROB slot
+    output logic                    issue_valid,
+    input                           issue_ready,
+    output logic [COORD_WIDTH-1:0]  issue_x,
+    output logic [COORD_WIDTH-1:0]  issue_y,
+    output logic [TAG_WIDTH-1:0]    issue_tag,
+
+    // Results coming back from the calculators, in any order
+    input                           result_valid,
+    input      [TAG_WIDTH-1:0]      result_tag,
+    input      [31:0]               result_iterations,
+    input      [31:0]               result_magnitude,
+
+    // In-order pixel stream
+    output logic                    out_valid,
+    input                           out_ready,
+    output logic [31:0]             out_iterations,
+    output logic [31:0]             out_magnitude,
+    output logic                    out_sof,
+    output logic                    out_eol,
+
+    // No pixel is in flight between issue and retire
+    output logic                    idle
+);
+
+    // -- Reorder buffer --
+    // Slots are allocated in raster order at issue and released in the same
+    // order, so the stream framing only depends on the retire counters.
+    reg [31:0]          rob_iterations [ROB_DEPTH-1:0];
+    reg [31:0]          rob_magnitude  [ROB_DEPTH-1:0];
+    reg [ROB_DEPTH-1:0] rob_filled;
+    reg [TAG_WIDTH:0]   issue_ptr, retire_ptr;
+
+    wire [TAG_WIDTH:0]   rob_count   = issue_ptr - retire_ptr;
+    wire [TAG_WIDTH-1:0] retire_slot = retire_ptr[TAG_WIDTH-1:0];
+
+    // -- Raster counters --
+    reg [COORD_WIDTH-1:0] retire_x, retire_y;
+
+    wire [COORD_WIDTH-1:0] x_last = width - 1'b1;
+    wire [COORD_WIDTH-1:0] y_last = height - 1'b1;
+
+    wire issue_fire  = issue_valid && issue_ready;
+    wire retire_fire = out_valid && out_ready;
+
+    assign issue_valid = (rob_count != ROB_DEPTH);
+    assign issue_tag   = issue_ptr[TAG_WIDTH-1:0];
+
+    assign out_valid      = rob_filled[retire_slot];
+    assign out_iterations = rob_iterations[retire_slot];
+    assign out_magnitude  = rob_magnitude[retire_slot];
+    assign out_sof        = (retire_x == 0) && (retire_y == 0);
+    assign out_eol        = (retire_x == x_last);
+    assign idle           = (rob_count == 0);
+
+    always_ff @(posedge clk) begin
+        if (rst) begin
+            issue_ptr  <= '0;
+            retire_ptr <= '0;
+            rob_filled <= '0;
+            issue_x    <= '0;
+            issue_y    <= '0;
+            retire_x   <= '0;
+            retire_y   <= '0;
+        end else begin
+            if (issue_fire) begin
+                issue_ptr <= issue_ptr + 1'b1;
+                if (issue_x == x_last) begin
+                    issue_x <= '0;
+                    issue_y <= (issue_y == y_last) ? '0 : issue_y + 1'b1;
+                end else begin
+                    issue_x <= issue_x + 1'b1;
+                end
+            end
+
+            // A slot is only re-issued after it retires, so the result write
+            // and the retire clear never target the same slot in one cycle.
+            if (retire_fire) begin
+                rob_filled[retire_slot] <= 1'b0;
+                retire_ptr <= retire_ptr + 1'b1;
+                if (retire_x == x_last) begin
+                    retire_x <= '0;
+                    retire_y <= (retire_y == y_last) ? '0 : retire_y + 1'b1;
+                end else begin
+                    retire_x <= retire_x + 1'b1;
+                end
+            end
+
+            if (result_valid) begin
+                rob_filled[result_tag]     <= 1'b1;
+                rob_iterations[result_tag] <= result_iterations;
+                rob_magnitude[result_tag]  <= result_magnitude;
+            end
+        end
+    end
+
+endmodule
@@ -1,31 +1,46 @@
-module screen_mapper (
+module screen_mapper #(
+    // Signed fixed point: DATA_WIDTH bits with FRAC_WIDTH fractional bits.
+    // At zoom 0 one pixel is 2^-8, or 2^(FRAC_WIDTH - 8) LSBs; each zoom
+    // step halves it. Past zoom FRAC_WIDTH - 8 a pixel is under one LSB and
+    // neighbouring pixels map to the same c.
+    parameter DATA_WIDTH = 32,
+    parameter FRAC_WIDTH = 28,
+    // Pixel coordinates cover frames up to 2^COORD_WIDTH - 1 pixels across
+    parameter COORD_WIDTH = 11
+)(
     // Inputs
-    input [9:0]  x,
-    input [9:0]  y,
-    input [31:0] pan_x, 
-    input [31:0] pan_y,
+    input [COORD_WIDTH-1:0]  x,
+    input [COORD_WIDTH-1:0]  y,
+    // Frame size; (width / 2, height / 2) maps to the pan point
+    input [COORD_WIDTH-1:0]  width,
+    input [COORD_WIDTH-1:0]  height,
+    input [DATA_WIDTH-1:0] pan_x,
+    input [DATA_WIDTH-1:0] pan_y,
     input [7:0]  zoom,
 
-    output logic [31:0] c_re,
-    output logic [31:0] c_im
+    output logic [DATA_WIDTH-1:0] c_re,
+    output logic [DATA_WIDTH-1:0] c_im
 );
 
-    localparam H_CENTER = 640 / 2; 
-    localparam V_CENTER = 480 / 2;
-
-    wire signed [11:0] x_centered = $signed({2'b00, x}) - H_CENTER;
-    wire signed [11:0] y_centered = $signed({2'b00, y}) - V_CENTER;
-    
-    wire signed [35:0] x_fixed = $signed(x_centered) <<< 24;
-    wire signed [35:0] y_fixed = $signed(y_centered) <<< 24;
-    
-    wire [4:0] zoom_limited = (zoom > 5'd24) ? 5'd24 : zoom[4:0];
-    wire signed [35:0] x_zoomed = x_fixed >>> zoom_limited;
-    wire signed [35:0] y_zoomed = y_fixed >>> zoom_limited;
-    
-    wire signed [31:0] x_scaled = x_zoomed[35:4];  
-    wire signed [31:0] y_scaled = y_zoomed[35:4];
-    
+    localparam FIXED_WIDTH = DATA_WIDTH + 4;
+    localparam STEP_SHIFT  = FRAC_WIDTH - 4;
+    localparam ZOOM_MAX    = FRAC_WIDTH - 4;
+
+    localparam CENTERED_WIDTH = COORD_WIDTH + 1;
+
+    wire signed [CENTERED_WIDTH-1:0] x_centered = $signed({1'b0, x}) - $signed({2'b00, width[COORD_WIDTH-1:1]});
+    wire signed [CENTERED_WIDTH-1:0] y_centered = $signed({1'b0, y}) - $signed({2'b00, height[COORD_WIDTH-1:1]});
+
+    wire signed [FIXED_WIDTH-1:0] x_fixed = FIXED_WIDTH'(x_centered) <<< STEP_SHIFT;
+    wire signed [FIXED_WIDTH-1:0] y_fixed = FIXED_WIDTH'(y_centered) <<< STEP_SHIFT;
+
+    wire [7:0] zoom_limited = (zoom > 8'(ZOOM_MAX)) ? 8'(ZOOM_MAX) : zoom;
+    wire signed [FIXED_WIDTH-1:0] x_zoomed = x_fixed >>> zoom_limited;
+    wire signed [FIXED_WIDTH-1:0] y_zoomed = y_fixed >>> zoom_limited;
+
+    wire signed [DATA_WIDTH-1:0] x_scaled = x_zoomed[FIXED_WIDTH-1:4];
+    wire signed [DATA_WIDTH-1:0] y_scaled = y_zoomed[FIXED_WIDTH-1:4];
+
     assign c_re = x_scaled + $signed(pan_x);
     assign c_im = y_scaled + $signed(pan_y);
 
@@ -0,0 +1,473 @@
+module tile_scheduler #(
+    parameter X_SIZE    = 640,
+    parameter Y_SIZE    = 480,
+    parameter ROB_DEPTH = 16,
+    // Tile edge in pixels, a power of two of at least 8 that divides both
+    // X_SIZE and Y_SIZE
+    parameter TILE      = 16,
+    // Tiles in flight at once, at least 2
+    parameter CONTEXTS  = 4,
+    localparam TAG_WIDTH = $clog2(ROB_DEPTH)
+)(
+    input                           clk,
+    input                           rst,
+
+    // Issue side, same handshake as raster_scheduler. issue_first marks
+    // pixel (0, 0), the first pixel issued in every frame.
+    output logic                    issue_valid,
+    input                           issue_ready,
+    output logic [9:0]              issue_x,
+    output logic [9:0]              issue_y,
+    output logic [TAG_WIDTH-1:0]    issue_tag,
+    output logic                    issue_first,
+
+    // Results coming back from the calculators, in any order
+    input                           result_valid,
+    input      [TAG_WIDTH-1:0]      result_tag,
+    input      [31:0]               result_iterations,
+    input      [31:0]               result_magnitude,
+
+    // In-order pixel stream
+    output logic                    out_valid,
+    input                           out_ready,
+    output logic [31:0]             out_iterations,
+    output logic [31:0]             out_magnitude,
+    output logic                    out_sof,
+    output logic                    out_eol,
+
+    // No pixel is being computed or waiting to be streamed
+    output logic                    idle,
+
+    // One pulse per pixel filled without iterating, with its value
+    output logic                    fill_valid,
+    output logic [31:0]             fill_iterations
+);
+
+    // -- Mariani-Silver subdivision --
+    // Each TILE x TILE tile has its border computed. A rectangle whose border
+    // holds one iteration count is filled with it. Otherwise the two middle
+    // rows and columns are computed and the four quadrants, whose borders
+    // are now all known, are checked the same way. At size 4 the middle
+    // lines are the whole interior, so recursion stops there.
+    //
+    // Up to CONTEXTS tiles of a band are worked on at once. A tile whose
+    // border or cross has been issued is parked until its pixels are back,
+    // and meanwhile the walker reads back, fills or issues for the others,
+    // so the lanes only drain at the end of a band.
+    //
+    // Results land in a band buffer holding TILE rows of the frame. There
+    // are two of them: one band is streamed out in raster order while the
+    // next one is computed.
+
+    localparam BAND_PIXELS = TILE * X_SIZE;
+    localparam ADDR_WIDTH  = $clog2(BAND_PIXELS);
+    localparam TW          = $clog2(TILE) + 1;      // Holds TILE itself
+    localparam TOP_LS      = $clog2(TILE);
+    localparam LS_WIDTH    = $clog2(TOP_LS + 1);
+    // Every split below the tile pushes three quadrants and works on the
+    // fourth; size 4 does not split
+    localparam STACK_DEPTH = 3 * (TOP_LS - 2);
+    localparam SP_WIDTH    = $clog2(STACK_DEPTH + 1);
+    localparam CTX_WIDTH   = $clog2(CONTEXTS);
+
+    localparam [1:0] MODE_BORDER   = 2'd0;     // Outer ring
+    localparam [1:0] MODE_CROSS    = 2'd1;     // Two middle rows and columns
+    localparam [1:0] MODE_INTERIOR = 2'd2;     // Everything inside the ring
+
+    localparam [2:0] S_PICK   = 3'd0;  // Resume a tile or start the next
+    localparam [2:0] S_ISSUE  = 3'd1;  // Issue border or cross pixels
+    localparam [2:0] S_RESUME = 3'd2;  // They are back; read or split
+    localparam [2:0] S_EVAL   = 3'd3;  // Read the border back
+    localparam [2:0] S_DECIDE = 3'd4;  // Fill, split or finish
+    localparam [2:0] S_FILL   = 3'd5;  // Write the interior
+    localparam [2:0] S_NEXT   = 3'd6;  // Pop a quadrant or move on
+    localparam [2:0] S_BAND   = 3'd7;  // Hand the band to the output side
+
+    // -- Ring walker --
+    // Visits the pixels of one mode in raster order within the rectangle.
+    // Full rows are walked pixel by pixel; other rows jump between their
+    // two columns.
+    function automatic [TW-1:0] walk_lo(input [1:0] m);
+        walk_lo = (m == MODE_BORDER) ? TW'(0) : TW'(1);
+    endfunction
+
+    function automatic [TW-1:0] walk_hi(input [1:0] m, input [TW-1:0] s);
+        walk_hi = (m == MODE_BORDER) ? s - 1'b1 : s - 2'd2;
+    endfunction
+
+    function automatic [TW-1:0] walk_col_a(input [1:0] m, input [TW-1:0] s);
+        walk_col_a = (m == MODE_BORDER) ? TW'(0) : (s >> 1) - 1'b1;
+    endfunction
+
+    function automatic [TW-1:0] walk_col_b(input [1:0] m, input [TW-1:0] s);
+        walk_col_b = (m == MODE_BORDER) ? s - 1'b1 : (s >> 1);
+    endfunction
+
+    function automatic walk_full(input [1:0] m, input [TW-1:0] row, input [TW-1:0] s);
+        case (m)
+            MODE_BORDER: walk_full = (row == 0) || (row == s - 1'b1);
+            MODE_CROSS:  walk_full = (row == (s >> 1) - 1'b1) || (row == (s >> 1));
+            default:     walk_full = 1'b1;
+        endcase
+    endfunction
+
+    reg [2:0]           state;
+    reg [9:0]           band_y;         // Frame row of the band being computed
+    reg [9:0]           tile_x;         // Next tile to start
+    reg                 band_issued;    // Every tile of the band has started
+    reg [CTX_WIDTH-1:0] ctx;            // Tile the walker is working on
+    reg [9:0]           cur_x;          // Current rectangle, x in the frame
+    reg [TW-1:0]        cur_y;          // and row in the band
+    reg [LS_WIDTH-1:0]  cur_ls;         // log2 of its size
+    reg [1:0]           mode;
+    reg [TW-1:0]        walk_i, walk_j;
+    reg                 after_cross;
+
+    reg [9:0]           stack_x  [CONTEXTS-1:0][STACK_DEPTH-1:0];
+    reg [TW-1:0]        stack_y  [CONTEXTS-1:0][STACK_DEPTH-1:0];
+    reg [LS_WIDTH-1:0]  stack_ls [CONTEXTS-1:0][STACK_DEPTH-1:0];
+    reg [SP_WIDTH-1:0]  sp;
+
+    // Parked tiles, waiting for their pixels
+    reg [CONTEXTS-1:0]  parked;
+    reg [9:0]           ctx_x     [CONTEXTS-1:0];
+    reg [TW-1:0]        ctx_y     [CONTEXTS-1:0];
+    reg [LS_WIDTH-1:0]  ctx_ls    [CONTEXTS-1:0];
+    reg                 ctx_after [CONTEXTS-1:0];
+    reg [SP_WIDTH-1:0]  ctx_sp    [CONTEXTS-1:0];
+
+    wire [TW-1:0] size = TW'(1) << cur_ls;
+    wire [TW-1:0] half = size >> 1;
+
+    wire          row_full = walk_full(mode, walk_j, size);
+    wire          row_end  = row_full ? (walk_i == walk_hi(mode, size)) : (walk_i == walk_col_b(mode, size));
+    wire          walk_last = (walk_j == walk_hi(mode, size)) && row_end;
+    wire [TW-1:0] next_row = walk_j + 1'b1;
+
+    wire [ADDR_WIDTH-1:0] walk_addr = ADDR_WIDTH'((cur_y + walk_j) * X_SIZE + cur_x + walk_i);
+
+    // -- Tags --
+    // Any free tag will do; results come back in any order.
+    reg [ROB_DEPTH-1:0]     tag_busy;
+    reg [ADDR_WIDTH-1:0]    tag_addr [ROB_DEPTH-1:0];
+    reg [CTX_WIDTH-1:0]     tag_ctx  [ROB_DEPTH-1:0];
+    logic [TAG_WIDTH-1:0]   free_tag;
+    logic                   free_any;
+
+    always_comb begin
+        free_tag = '0;
+        free_any = 1'b0;
+        for (int t = ROB_DEPTH - 1; t >= 0; t--) begin
+            if (!tag_busy[t]) begin
+                free_tag = TAG_WIDTH'(t);
+                free_any = 1'b1;
+            end
+        end
+    end
+
+    // A parked tile is ready once none of its tags is busy
+    logic [CONTEXTS-1:0]    ctx_busy;
+    logic [CTX_WIDTH-1:0]   ready_ctx, free_ctx;
+    logic                   ready_any, free_ctx_any;
+
+    always_comb begin
+        ctx_busy = '0;
+        for (int t = 0; t < ROB_DEPTH; t++) begin
+            if (tag_busy[t]) begin
+                ctx_busy[tag_ctx[t]] = 1'b1;
+            end
+        end
+        ready_ctx = '0;
+        ready_any = 1'b0;
+        free_ctx = '0;
+        free_ctx_any = 1'b0;
+        for (int c = CONTEXTS - 1; c >= 0; c--) begin
+            if (parked[c] && !ctx_busy[c]) begin
+                ready_ctx = CTX_WIDTH'(c);
+                ready_any = 1'b1;
+            end
+            if (!parked[c]) begin
+                free_ctx = CTX_WIDTH'(c);
+                free_ctx_any = 1'b1;
+            end
+        end
+    end
+
+    assign issue_valid = (state == S_ISSUE) && free_any;
+    assign issue_x     = cur_x + 10'(walk_i);
+    assign issue_y     = band_y + 10'(cur_y) + 10'(walk_j);
+    assign issue_tag   = free_tag;
+    assign issue_first = (state == S_ISSUE) && (band_y == 0) && (cur_x == 0) && (cur_y == 0) &&
+                         (cur_ls == TOP_LS) && (mode == MODE_BORDER) &&
+                         (walk_i == 0) && (walk_j == 0);
+
+    wire issue_fire = issue_valid && issue_ready;
+
+    // -- Band buffers --
+    reg                     compute_bank, emit_bank;
+    reg                     emit_active, emit_primed;
+    reg [ADDR_WIDTH-1:0]    emit_index;
+    reg [9:0]               emit_x;
+    reg [9:0]               emit_band_y;
+    reg [31:0]              ref_iter;
+
+    wire                    retire_fire = out_valid && out_ready;
+    wire [ADDR_WIDTH-1:0]   emit_addr = retire_fire ? emit_index + 1'b1 : emit_index;
+
+    // Other tiles' results keep arriving during a fill and take the write
+    // port; the fill waits for a free cycle
+    wire                    fill_write = (state == S_FILL) && !result_valid;
+    wire                    wr_en   = result_valid || fill_write;
+    wire [ADDR_WIDTH-1:0]   wr_addr = result_valid ? tag_addr[result_tag] : walk_addr;
+    wire [63:0]             wr_data = result_valid ? {result_magnitude, result_iterations} : {32'h0, ref_iter};
+
+    wire [63:0]             bank_q [1:0];
+
+    genvar b;
+    generate
+        for (b = 0; b < 2; b++) begin : band
+            reg [63:0] mem [BAND_PIXELS-1:0];
+            reg [63:0] q;
+            wire       computing = (compute_bank == b);
+
+            always_ff @(posedge clk) begin
+                if (wr_en && computing) begin
+                    mem[wr_addr] <= wr_data;
+                end
+                q <= mem[computing ? walk_addr : emit_addr];
+            end
+
+            assign bank_q[b] = q;
+        end
+    endgenerate
+
+    wire [31:0] eval_iter = bank_q[compute_bank][31:0];
+
+    assign out_valid      = emit_active && emit_primed;
+    assign out_iterations = bank_q[emit_bank][31:0];
+    assign out_magnitude  = bank_q[emit_bank][63:32];
+    assign out_sof        = (emit_band_y == 0) && (emit_index == 0);
+    assign out_eol        = (emit_x == X_SIZE - 1);
+
+    assign idle = (tag_busy == 0) && !emit_active;
+
+    assign fill_valid      = fill_write;
+    assign fill_iterations = ref_iter;
+
+    // -- Border check --
+    // The buffer read takes a clock, so each compare runs one behind the walk
+    reg         eval_q_valid, eval_first, mismatch;
+    wire        uniform = !mismatch && (eval_iter == ref_iter);
+
+    always_ff @(posedge clk) begin
+        eval_q_valid <= (state == S_EVAL);
+        if (state != S_EVAL && !eval_q_valid) begin
+            eval_first <= 1'b1;
+            mismatch <= 1'b0;
+        end else if (eval_q_valid) begin
+            if (eval_first) begin
+                ref_iter <= eval_iter;
+                eval_first <= 1'b0;
+            end else if (eval_iter != ref_iter) begin
+                mismatch <= 1'b1;
+            end
+        end
+    end
+
+    // -- Output side --
+    always_ff @(posedge clk) begin
+        if (rst) begin
+            emit_active <= 1'b0;
+            emit_primed <= 1'b0;
+            emit_index  <= '0;
+            emit_x      <= '0;
+        end else if (state == S_BAND && !emit_active) begin
+            emit_active <= 1'b1;
+            emit_primed <= 1'b0;
+            emit_index  <= '0;
+            emit_x      <= '0;
+        end else if (emit_active) begin
+            emit_primed <= 1'b1;
+            if (retire_fire) begin
+                if (emit_index == BAND_PIXELS - 1) begin
+                    emit_active <= 1'b0;
+                    emit_primed <= 1'b0;
+                end
+                emit_index <= emit_index + 1'b1;
+                emit_x <= (emit_x == X_SIZE - 1) ? '0 : emit_x + 1'b1;
+            end
+        end
+    end
+
+    // -- Compute side --
+    task automatic walk_start(input [1:0] m, input [TW-1:0] s);
+        mode   <= m;
+        walk_j <= walk_lo(m);
+        walk_i <= walk_full(m, walk_lo(m), s) ? walk_lo(m) : walk_col_a(m, s);
+    endtask
+
+    task automatic walk_step();
+        if (!row_end) begin
+            walk_i <= row_full ? walk_i + 1'b1 : walk_col_b(mode, size);
+        end else begin
+            walk_j <= next_row;
+            walk_i <= walk_full(mode, next_row, size) ? walk_lo(mode) : walk_col_a(mode, size);
+        end
+    endtask
+
+    always_ff @(posedge clk) begin
+        if (rst) begin
+            state        <= S_PICK;
+            band_y       <= '0;
+            tile_x       <= '0;
+            band_issued  <= 1'b0;
+            ctx          <= '0;
+            parked       <= '0;
+            cur_x        <= '0;
+            cur_y        <= '0;
+            cur_ls       <= LS_WIDTH'(TOP_LS);
+            mode         <= MODE_BORDER;
+            walk_i       <= '0;
+            walk_j       <= '0;
+            after_cross  <= 1'b0;
+            sp           <= '0;
+            tag_busy     <= '0;
+            compute_bank <= 1'b0;
+            emit_bank    <= 1'b1;
+            emit_band_y  <= '0;
+        end else begin
+            if (issue_fire) begin
+                tag_addr[free_tag] <= walk_addr;
+                tag_ctx[free_tag] <= ctx;
+            end
+            tag_busy <= (tag_busy | (issue_fire ? ROB_DEPTH'(1) << free_tag : '0)) &
+                        ~(result_valid ? ROB_DEPTH'(1) << result_tag : '0);
+
+            case (state)
+                S_PICK: begin
+                    if (ready_any) begin
+                        ctx <= ready_ctx;
+                        cur_x <= ctx_x[ready_ctx];
+                        cur_y <= ctx_y[ready_ctx];
+                        cur_ls <= ctx_ls[ready_ctx];
+                        after_cross <= ctx_after[ready_ctx];
+                        sp <= ctx_sp[ready_ctx];
+                        parked[ready_ctx] <= 1'b0;
+                        state <= S_RESUME;
+                    end else if (!band_issued && free_ctx_any) begin
+                        ctx <= free_ctx;
+                        cur_x <= tile_x;
+                        cur_y <= '0;
+                        cur_ls <= LS_WIDTH'(TOP_LS);
+                        after_cross <= 1'b0;
+                        sp <= '0;
+                        walk_start(MODE_BORDER, TW'(TILE));
+                        band_issued <= (tile_x == X_SIZE - TILE);
+                        tile_x <= tile_x + 10'(TILE);
+                        state <= S_ISSUE;
+                    end else if (band_issued && parked == 0) begin
+                        state <= S_BAND;
+                    end
+                end
+
+                S_ISSUE: begin
+                    if (issue_fire) begin
+                        walk_step();
+                        if (walk_last) begin
+                            ctx_x[ctx] <= cur_x;
+                            ctx_y[ctx] <= cur_y;
+                            ctx_ls[ctx] <= cur_ls;
+                            ctx_after[ctx] <= after_cross;
+                            ctx_sp[ctx] <= sp;
+                            parked[ctx] <= 1'b1;
+                            state <= S_PICK;
+                        end
+                    end
+                end
+
+                S_RESUME: begin
+                    if (!after_cross) begin
+                        walk_start(MODE_BORDER, size);
+                        state <= S_EVAL;
+                    end else if (cur_ls == 2) begin
+                        state <= S_NEXT;
+                    end else begin
+                        // Work on the top-left quadrant, stack the rest
+                        stack_x[ctx][sp]      <= cur_x + 10'(half);
+                        stack_y[ctx][sp]      <= cur_y;
+                        stack_ls[ctx][sp]     <= cur_ls - 1'b1;
+                        stack_x[ctx][sp + 1]  <= cur_x;
+                        stack_y[ctx][sp + 1]  <= cur_y + half;
+                        stack_ls[ctx][sp + 1] <= cur_ls - 1'b1;
+                        stack_x[ctx][sp + 2]  <= cur_x + 10'(half);
+                        stack_y[ctx][sp + 2]  <= cur_y + half;
+                        stack_ls[ctx][sp + 2] <= cur_ls - 1'b1;
+                        sp <= sp + 2'd3;
+                        cur_ls <= cur_ls - 1'b1;
+                        after_cross <= 1'b0;
+                        walk_start(MODE_BORDER, half);
+                        state <= S_EVAL;
+                    end
+                end
+
+                S_EVAL: begin
+                    walk_step();
+                    if (walk_last) begin
+                        state <= S_DECIDE;
+                    end
+                end
+
+                S_DECIDE: begin
+                    if (uniform) begin
+                        walk_start(MODE_INTERIOR, size);
+                        state <= S_FILL;
+                    end else begin
+                        after_cross <= 1'b1;
+                        walk_start(MODE_CROSS, size);
+                        state <= S_ISSUE;
+                    end
+                end
+
+                S_FILL: begin
+                    if (fill_write) begin
+                        walk_step();
+                        if (walk_last) begin
+                            state <= S_NEXT;
+                        end
+                    end
+                end
+
+                S_NEXT: begin
+                    if (sp != 0) begin
+                        cur_x <= stack_x[ctx][sp - 1'b1];
+                        cur_y <= stack_y[ctx][sp - 1'b1];
+                        cur_ls <= stack_ls[ctx][sp - 1'b1];
+                        sp <= sp - 1'b1;
+                        after_cross <= 1'b0;
+                        walk_start(MODE_BORDER, TW'(1) << stack_ls[ctx][sp - 1'b1]);
+                        state <= S_EVAL;
+                    end else begin
+                        // The tile is done and its context free
+                        state <= S_PICK;
+                    end
+                end
+
+                S_BAND: begin
+                    // The other buffer must have been streamed out first
+                    if (!emit_active) begin
+                        emit_bank <= compute_bank;
+                        emit_band_y <= band_y;
+                        compute_bank <= !compute_bank;
+                        band_y <= (band_y == Y_SIZE - TILE) ? '0 : band_y + 10'(TILE);
+                        tile_x <= '0;
+                        band_issued <= 1'b0;
+                        state <= S_PICK;
+                    end
+                end
+
+                default: state <= S_PICK;
+            endcase
+        end
+    end
+
+endmodule
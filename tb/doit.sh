@@ -38,15 +38,22 @@ for file in "${files[@]}"; do
         #name="top"
     #fi
 
+    # A test may bring its own top level, e.g. to build several
+    # parameterizations of one module side by side
+    top_file="${RTL_FOLDER}/${name}.sv"
+    if [[ -f "${TEST_FOLDER}/${name}_top.sv" ]]; then
+        top_file="${TEST_FOLDER}/${name}_top.sv"
+    fi
+
     # Translate Verilog -> C++ including testbench
     verilator   -Wall --trace \
-                -cc "${RTL_FOLDER}/${name}.sv" \
+                -cc "${top_file}" \
                 --exe "$file" \
                 -y "${RTL_FOLDER}" \
                 --prefix "Vdut" \
                 -o Vdut \
-                -CFLAGS "-isystem /opt/homebrew/Cellar/googletest/1.15.2/include"\
-                -LDFLAGS "-L/opt/homebrew/Cellar/googletest/1.15.2/lib -lgtest -lgtest_main -lpthread" \
+                -CFLAGS "-isystem /opt/homebrew/Cellar/googletest/1.15.2/include -isystem /opt/homebrew/include"\
+                -LDFLAGS "-L/opt/homebrew/Cellar/googletest/1.15.2/lib -L/opt/homebrew/lib -lgtest -lgtest_main -lpthread -lgmp" \
                 --coverage
 
     # Build C++ project with automatically generated Makefile
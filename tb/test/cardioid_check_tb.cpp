@@ -0,0 +1,90 @@
+#include "base_testbench.h"
+#include "mandelbrot_model.h"
+#include <cstdint>
+#include <verilated_cov.h>
+#include <gtest/gtest.h>
+
+unsigned int ticks = 0;
+
+// Convert double to Q4.28 fixed point format
+int32_t double_to_fixed_point(double val) {
+    return static_cast<int32_t>(val * (1LL << 28));
+}
+
+class CardioidCheckTestbench : public BaseTestbench {
+protected:
+    void initializeInputs() override {
+        top->c_re = 0;
+        top->c_im = 0;
+    }
+
+    bool inside(double re, double im) {
+        return insideFixed(double_to_fixed_point(re), double_to_fixed_point(im));
+    }
+
+    bool insideFixed(int32_t re, int32_t im) {
+        top->c_re = re;
+        top->c_im = im;
+        top->eval();
+        #ifndef __APPLE__
+        tfp->dump(ticks);
+        #endif
+        ticks++;
+        return top->inside;
+    }
+};
+
+// Test 1: Points well inside the main cardioid
+TEST_F(CardioidCheckTestbench, MainCardioidInterior) {
+    EXPECT_TRUE(inside(0.0, 0.0));
+    EXPECT_TRUE(inside(-0.1, 0.0));
+    EXPECT_TRUE(inside(0.2, 0.3));
+    EXPECT_TRUE(inside(-0.5, 0.4));
+    EXPECT_TRUE(inside(0.2, -0.3));
+}
+
+// Test 2: Points well inside the period-2 bulb
+TEST_F(CardioidCheckTestbench, PeriodTwoBulbInterior) {
+    EXPECT_TRUE(inside(-1.0, 0.0));
+    EXPECT_TRUE(inside(-1.1, 0.1));
+    EXPECT_TRUE(inside(-0.9, -0.15));
+}
+
+// Test 3: Points outside both regions, including other parts of the set
+TEST_F(CardioidCheckTestbench, Outside) {
+    EXPECT_FALSE(inside(0.3, 0.0));       // just past the cusp
+    EXPECT_FALSE(inside(-1.3, 0.0));      // past the bulb, still in the set
+    EXPECT_FALSE(inside(-0.12, 0.75));    // period-3 bulb
+    EXPECT_FALSE(inside(2.0, 0.0));
+    EXPECT_FALSE(inside(-2.0, 0.0));
+    EXPECT_FALSE(inside(0.0, 1.5));
+}
+
+// Test 4: Far-away points must not overflow into a false hit
+TEST_F(CardioidCheckTestbench, LargeValuesAreOutside) {
+    EXPECT_FALSE(inside(7.9, 7.9));
+    EXPECT_FALSE(inside(-7.9, 0.0));
+    EXPECT_FALSE(inside(0.0, -7.9));
+    EXPECT_FALSE(insideFixed(INT32_MIN, INT32_MIN));
+    EXPECT_FALSE(insideFixed(INT32_MAX, 0));
+}
+
+// Test 5: Every hit on a grid over the default view is a point the
+// calculator would have run to max_iter anyway.
+TEST_F(CardioidCheckTestbench, HitsNeverEscape) {
+    const uint32_t max_iter = 500;
+    const int n = 64;
+    int hits = 0;
+    for (int j = 0; j < n; j++) {
+        for (int i = 0; i < n; i++) {
+            int32_t re = double_to_fixed_point(-2.2 + 2.8 * i / (n - 1));
+            int32_t im = double_to_fixed_point(-1.2 + 2.4 * j / (n - 1));
+            if (insideFixed(re, im)) {
+                hits++;
+                EXPECT_EQ(mandelbrot_model::iterations(re, im, max_iter), max_iter)
+                    << "c = (" << re << ", " << im << ") flagged inside but escapes";
+            }
+        }
+    }
+    EXPECT_GT(hits, n * n / 8);
+}
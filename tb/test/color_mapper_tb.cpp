@@ -25,6 +25,32 @@ protected:
     void initializeInputs() override {
         top->iterations_in = 0;
         top->max_iter = 100;
+        top->palette_en = 0;
+        top->palette_bank = 0;
+        top->palette_scale = 0x100;
+        top->palette_offset = 0;
+        top->palette_wclk = 0;
+        top->palette_we = 0;
+        top->palette_waddr = 0;
+        top->palette_wdata = 0;
+    }
+
+    // One write through the palette port, on its own clock
+    void writePalette(int bank, int entry, uint32_t rgb) {
+        top->palette_we = 1;
+        top->palette_waddr = (bank << 10) | entry;
+        top->palette_wdata = rgb;
+        top->palette_wclk = 0;
+        top->eval();
+        top->palette_wclk = 1;
+        top->eval();
+        top->palette_we = 0;
+        top->palette_wclk = 0;
+        top->eval();
+    }
+
+    uint32_t rgb() {
+        return (static_cast<uint32_t>(top->r) << 16) | (static_cast<uint32_t>(top->g) << 8) | top->b;
     }
 
     void resetDUT() {
@@ -270,4 +296,73 @@ TEST_F(ColorMapperTestbench, RapidInputChanges) {
     EXPECT_EQ(top->r, 255);
     EXPECT_EQ(top->g, 245);  // 500 - 255 = 245
     EXPECT_EQ(top->b, 0);
-}
\ No newline at end of file
+}
+// Test 11: With the palette enabled, escaped points read their entry
+TEST_F(ColorMapperTestbench, PaletteLookup) {
+    resetDUT();
+    for (int i = 0; i < 8; i++) {
+        writePalette(0, i, 0x010203 * (i + 1));
+    }
+    top->palette_en = 1;
+
+    for (uint32_t iter = 0; iter < 8; iter++) {
+        run_color_test(iter, 100);
+        EXPECT_EQ(rgb(), 0x010203u * (iter + 1)) << "Entry " << iter;
+    }
+
+    // Interior points stay black whatever the palette says
+    run_color_test(100, 100);
+    EXPECT_EQ(rgb(), 0u);
+}
+
+// Test 12: Scale and offset pick the entry, wrapping at the bank size
+TEST_F(ColorMapperTestbench, PaletteScaleAndOffsetWrap) {
+    resetDUT();
+    writePalette(0, 30, 0x112233);
+    writePalette(0, 1023, 0x445566);
+    writePalette(0, 5, 0x778899);
+    top->palette_en = 1;
+
+    // 2.5x: iteration 12 -> entry 30
+    top->palette_scale = 0x280;
+    run_color_test(12, 1000);
+    EXPECT_EQ(rgb(), 0x112233u);
+
+    // Offset 1001 moves iteration 9 (entry 22 at 2.5x) to the last entry
+    top->palette_offset = 1001;
+    run_color_test(9, 1000);
+    EXPECT_EQ(rgb(), 0x445566u);
+
+    // ... and past the end of the bank back to 5
+    top->palette_scale = 0x100;
+    top->palette_offset = 1020;
+    run_color_test(9, 1000);
+    EXPECT_EQ(rgb(), 0x778899u);
+}
+
+// Test 13: The two banks are independent, and palette_en off is the ramp
+TEST_F(ColorMapperTestbench, PaletteBanks) {
+    resetDUT();
+    writePalette(0, 50, 0xAA0000);
+    writePalette(1, 50, 0x00BB00);
+    top->palette_en = 1;
+
+    top->palette_bank = 0;
+    run_color_test(50, 100);
+    EXPECT_EQ(rgb(), 0xAA0000u);
+
+    top->palette_bank = 1;
+    run_color_test(50, 100);
+    EXPECT_EQ(rgb(), 0x00BB00u);
+
+    // Loading one bank does not disturb the other
+    writePalette(0, 50, 0x0000CC);
+    run_color_test(50, 100);
+    EXPECT_EQ(rgb(), 0x00BB00u);
+
+    top->palette_en = 0;
+    ColorResult ramp = run_color_test(50, 100);
+    EXPECT_EQ(ramp.r, 200);
+    EXPECT_EQ(ramp.g, 0);
+    EXPECT_EQ(ramp.b, 0);
+}
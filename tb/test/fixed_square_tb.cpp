@@ -0,0 +1,141 @@
+#include "base_testbench.h"
+#include <cstdint>
+#include <random>
+#include <vector>
+#include <verilated_cov.h>
+#include <gtest/gtest.h>
+
+unsigned int ticks = 0;
+
+using u128 = unsigned __int128;
+
+// The DUT is fixed_square_top: one fixed_square per width below
+constexpr int WIDTHS[] = {32, 33, 64, 65};
+constexpr int LOW_WIDTH = 17;
+
+u128 widthMask(int width) {
+    return (u128(1) << width) - 1;
+}
+
+// Exact x^2 of a WIDTH-bit two's complement input, up to 65 bits, as 32-bit
+// words from the least significant. |x| <= 2^64, and its bit 64 is only set
+// for |x| = 2^64 itself, whose square is exactly 2^128; below that the
+// square is one 128-bit product.
+std::vector<uint32_t> exactSquare(int width, u128 bits) {
+    u128 sign = u128(1) << (width - 1);
+    u128 mag = (bits & sign) ? ((~bits + 1) & widthMask(width)) : bits;
+    bool top = (mag >> 64) != 0;
+    u128 low = top ? 0 : u128(uint64_t(mag)) * uint64_t(mag);
+    std::vector<uint32_t> words(5, 0);
+    for (int i = 0; i < 4; i++) {
+        words[i] = uint32_t(low >> (32 * i));
+    }
+    words[4] = top ? 1 : 0;
+    return words;
+}
+
+void setPort(uint32_t &port, u128 bits) { port = uint32_t(bits); }
+void setPort(uint64_t &port, u128 bits) { port = uint64_t(bits); }
+
+template <std::size_t N>
+void setPort(VlWide<N> &port, u128 bits) {
+    for (std::size_t i = 0; i < N; i++) {
+        port[i] = (i < 4) ? uint32_t(bits >> (32 * i)) : 0;
+    }
+}
+
+std::vector<uint32_t> portWords(uint64_t port) {
+    return {uint32_t(port), uint32_t(port >> 32), 0, 0, 0};
+}
+
+template <std::size_t N>
+std::vector<uint32_t> portWords(const VlWide<N> &port) {
+    std::vector<uint32_t> words(5, 0);
+    for (std::size_t i = 0; i < N; i++) {
+        words[i] = port[i];
+    }
+    return words;
+}
+
+std::string hex(u128 bits) {
+    char buf[40];
+    snprintf(buf, sizeof(buf), "0x%016llx%016llx",
+             (unsigned long long)(bits >> 64), (unsigned long long)bits);
+    return buf;
+}
+
+class FixedSquareTestbench : public BaseTestbench {
+protected:
+    void initializeInputs() override {
+        top->x32 = 0;
+        top->x33 = 0;
+        top->x64 = 0;
+        setPort(top->x65, 0);
+    }
+
+    // Drives x into the instance of the given width (truncated to it) and
+    // checks its square against the exact one
+    void expectSquare(int width, u128 bits) {
+        bits &= widthMask(width);
+        std::vector<uint32_t> got;
+        switch (width) {
+            case 32: setPort(top->x32, bits); break;
+            case 33: setPort(top->x33, bits); break;
+            case 64: setPort(top->x64, bits); break;
+            default: setPort(top->x65, bits); break;
+        }
+        top->eval();
+        #ifndef __APPLE__
+        tfp->dump(ticks);
+        #endif
+        ticks++;
+        switch (width) {
+            case 32: got = portWords(top->sq32); break;
+            case 33: got = portWords(top->sq33); break;
+            case 64: got = portWords(top->sq64); break;
+            default: got = portWords(top->sq65); break;
+        }
+        EXPECT_EQ(got, exactSquare(width, bits)) << "WIDTH " << width << ", x = " << hex(bits);
+    }
+};
+
+// Test 1: Ends of the range and the split between the high and low slices
+TEST_F(FixedSquareTestbench, CornerCases) {
+    for (int width : WIDTHS) {
+        u128 sign = u128(1) << (width - 1);
+        u128 low_ones = (u128(1) << LOW_WIDTH) - 1;
+        u128 low_top = u128(1) << LOW_WIDTH;
+        const u128 values[] = {
+            0, 1, ~u128(0),                 // 0, 1, -1
+            sign,                           // Most negative
+            sign - 1,                       // Most positive
+            sign | 1,                       // Most negative + 1
+            low_ones,                       // All-ones low slice, high slice 0
+            sign | low_ones,                // ... under the most negative high slice
+            (sign - 1) & ~low_ones,         // Most positive high slice, low slice 0
+            ~low_ones,                      // High slice -1, low slice 0
+            low_top,                        // High slice 1, low slice 0
+            low_top | low_ones,             // High slice 1, all-ones low slice
+            u128(1) << (LOW_WIDTH - 1),     // Top bit of the low slice alone
+            ~(u128(1) << (LOW_WIDTH - 1)),
+        };
+        for (u128 x : values) {
+            expectSquare(width, x);
+        }
+    }
+}
+
+// Test 2: Random inputs, full range and near the slice boundary
+TEST_F(FixedSquareTestbench, RandomValues) {
+    std::mt19937_64 rng(0x5eed);
+    for (int width : WIDTHS) {
+        for (int i = 0; i < 20000; i++) {
+            u128 x = (u128(rng()) << 64) | rng();
+            expectSquare(width, x);
+            // All-ones low slice under a random high slice
+            expectSquare(width, x | ((u128(1) << LOW_WIDTH) - 1));
+            // Small magnitudes, where the high slice is 0 or -1
+            expectSquare(width, u128(__int128(int32_t(rng()) >> (rng() % 32))));
+        }
+    }
+}
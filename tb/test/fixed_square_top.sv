@@ -0,0 +1,19 @@
+// Test top for fixed_square: the widths mandelbrot_calculator builds it at,
+// each datapath's z and the one-bit-wider re + im, side by side
+module fixed_square_top (
+    input  [31:0]   x32,
+    output [63:0]   sq32,
+    input  [32:0]   x33,
+    output [65:0]   sq33,
+    input  [63:0]   x64,
+    output [127:0]  sq64,
+    input  [64:0]   x65,
+    output [129:0]  sq65
+);
+
+    fixed_square #(.WIDTH(32)) sq32_inst (.x(x32), .sq(sq32));
+    fixed_square #(.WIDTH(33)) sq33_inst (.x(x33), .sq(sq33));
+    fixed_square #(.WIDTH(64)) sq64_inst (.x(x64), .sq(sq64));
+    fixed_square #(.WIDTH(65)) sq65_inst (.x(x65), .sq(sq65));
+
+endmodule
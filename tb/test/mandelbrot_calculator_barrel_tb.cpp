@@ -0,0 +1,205 @@
+#include "base_testbench.h"
+#include "mandelbrot_model.h"
+#include <cstdint>
+#include <map>
+#include <vector>
+#include <verilated_cov.h>
+#include <gtest/gtest.h>
+
+unsigned int ticks = 0;
+
+// Convert double to Q4.28 fixed point format
+int32_t double_to_fixed_point(double val) {
+    return static_cast<int32_t>(val * (1LL << 28));
+}
+
+class MandelbrotCalculatorBarrelTestbench : public BaseTestbench {
+protected:
+    struct Point {
+        int32_t c_re, c_im;
+    };
+
+    struct Result {
+        size_t index;
+        uint32_t iterations;
+        uint32_t magnitude;
+    };
+
+    void clockCycle() {
+        top->clk = 0;
+        top->eval();
+        #ifndef __APPLE__
+        tfp->dump(2 * ticks);
+        #endif
+
+        top->clk = 1;
+        top->eval();
+        #ifndef __APPLE__
+        tfp->dump(2 * ticks + 1);
+        #endif
+        ticks++;
+    }
+
+    void initializeInputs() override {
+        top->rst = 1;
+        top->in_valid = 0;
+        top->in_c_re = 0;
+        top->in_c_im = 0;
+        top->in_z0_re = 0;
+        top->in_z0_im = 0;
+        top->in_tag = 0;
+        top->max_iter = 0;
+        top->out_ready = 1;
+    }
+
+    void resetDUT() {
+        top->rst = 1;
+        clockCycle();
+        top->rst = 0;
+        clockCycle();
+        ASSERT_EQ(top->out_valid, 0);
+        ASSERT_EQ(top->in_ready, 1);
+    }
+
+    // Pushes every point through the ring as fast as it accepts them and
+    // returns the results in completion order. Each in-flight point holds
+    // one of the 16 tags until its result comes back.
+    std::vector<Result> run(const std::vector<Point> &points, uint32_t max_iter,
+                            int ready_period = 1, uint64_t *cycles = nullptr) {
+        std::vector<Result> results;
+        std::map<uint32_t, size_t> in_flight;
+        size_t next = 0;
+        long timeout = (long)(points.size() + 8) * (max_iter + 8) * 4;
+        uint64_t start = ticks;
+
+        top->max_iter = max_iter;
+        while (results.size() < points.size() && timeout-- > 0) {
+            uint32_t tag = 0;
+            while (in_flight.count(tag)) tag++;
+
+            top->in_valid = next < points.size() && tag < 16;
+            if (top->in_valid) {
+                top->in_c_re = points[next].c_re;
+                top->in_c_im = points[next].c_im;
+                top->in_tag = tag;
+            }
+            top->out_ready = (ticks % ready_period) == 0;
+            top->eval();
+
+            bool in_fire = top->in_valid && top->in_ready;
+            if (top->out_valid && top->out_ready) {
+                auto it = in_flight.find(top->out_tag);
+                EXPECT_NE(it, in_flight.end()) << "Result for unknown tag " << top->out_tag;
+                if (it != in_flight.end()) {
+                    results.push_back({it->second, top->out_iterations, top->out_magnitude});
+                    in_flight.erase(it);
+                }
+            }
+            clockCycle();
+            if (in_fire) {
+                in_flight[tag] = next++;
+            }
+        }
+        top->in_valid = 0;
+        EXPECT_GT(timeout, 0) << "Simulation timed out!";
+        if (cycles) *cycles = ticks - start;
+        return results;
+    }
+
+    void expectMatchesModel(const std::vector<Point> &points, const std::vector<Result> &results,
+                            uint32_t max_iter) {
+        ASSERT_EQ(results.size(), points.size());
+        for (auto &r : results) {
+            uint32_t magnitude;
+            uint32_t iter = mandelbrot_model::iterations(points[r.index].c_re, points[r.index].c_im, max_iter,
+                                                         &magnitude);
+            EXPECT_EQ(r.iterations, iter) << "point " << r.index;
+            if (iter < max_iter) {
+                EXPECT_EQ(r.magnitude, magnitude) << "point " << r.index;
+            }
+        }
+    }
+
+    std::vector<Point> grid(double re0, double re1, double im0, double im1, int n) {
+        std::vector<Point> points;
+        for (int j = 0; j < n; j++) {
+            for (int i = 0; i < n; i++) {
+                points.push_back({double_to_fixed_point(re0 + (re1 - re0) * i / (n - 1)),
+                                  double_to_fixed_point(im0 + (im1 - im0) * j / (n - 1))});
+            }
+        }
+        return points;
+    }
+};
+
+// Test 1: single points with known behaviour
+TEST_F(MandelbrotCalculatorBarrelTestbench, KnownPoints) {
+    resetDUT();
+    std::vector<Point> points = {
+        {double_to_fixed_point(0.0), double_to_fixed_point(0.0)},
+        {double_to_fixed_point(-1.0), double_to_fixed_point(0.0)},
+        {double_to_fixed_point(2.0), double_to_fixed_point(0.0)},
+        {double_to_fixed_point(0.3), double_to_fixed_point(0.6)},
+    };
+    auto results = run(points, 100);
+    expectMatchesModel(points, results, 100);
+}
+
+// Test 2: a grid over the default view must match the single-lane calculator
+TEST_F(MandelbrotCalculatorBarrelTestbench, GridMatchesSingleLane) {
+    resetDUT();
+    auto points = grid(-2.2, 0.8, -1.2, 1.2, 24);
+    auto results = run(points, 64);
+    expectMatchesModel(points, results, 64);
+}
+
+// Test 3: max_iter = 0 and 1 retire on the first pass
+TEST_F(MandelbrotCalculatorBarrelTestbench, TinyMaxIter) {
+    resetDUT();
+    auto points = grid(-2.0, 2.0, -2.0, 2.0, 4);
+    auto results = run(points, 0);
+    expectMatchesModel(points, results, 0);
+    results = run(points, 1);
+    expectMatchesModel(points, results, 1);
+}
+
+// Test 4: results held back by out_ready keep circulating and are not lost
+TEST_F(MandelbrotCalculatorBarrelTestbench, BackPressure) {
+    resetDUT();
+    auto points = grid(-2.0, 0.5, -1.0, 1.0, 8);
+    auto results = run(points, 40, 3);
+    expectMatchesModel(points, results, 40);
+}
+
+// Test 5: an interior-heavy workload should approach one iteration per clock
+TEST_F(MandelbrotCalculatorBarrelTestbench, Throughput) {
+    resetDUT();
+    const uint32_t max_iter = 200;
+    std::vector<Point> points(20, {double_to_fixed_point(-0.1), double_to_fixed_point(0.0)});
+    uint64_t cycles = 0;
+    auto results = run(points, max_iter, 1, &cycles);
+    expectMatchesModel(points, results, max_iter);
+
+    double iters_per_clock = (double)points.size() * max_iter / cycles;
+    std::cout << "Barrel core: " << iters_per_clock << " iterations/clock" << std::endl;
+    EXPECT_GT(iters_per_clock, 0.9);
+}
+
+// Test 6: the |z|^2 of the escape test comes out with the count, also for
+// results that circulate under back-pressure, and is never below 4
+TEST_F(MandelbrotCalculatorBarrelTestbench, MagnitudeMatchesModel) {
+    resetDUT();
+    const uint32_t max_iter = 40;
+    auto points = grid(-7.9, 7.9, -7.9, 7.9, 9);
+    auto more = grid(-2.2, 0.8, -1.2, 1.2, 8);
+    points.insert(points.end(), more.begin(), more.end());
+    for (int ready_period : {1, 3}) {
+        auto results = run(points, max_iter, ready_period);
+        expectMatchesModel(points, results, max_iter);
+        for (auto &r : results) {
+            if (r.iterations < max_iter) {
+                EXPECT_GE(r.magnitude, 0x40000000u) << "point " << r.index;
+            }
+        }
+    }
+}
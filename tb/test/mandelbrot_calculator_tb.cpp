@@ -1,5 +1,7 @@
 #include "base_testbench.h"
+#include "mandelbrot_model.h"
 #include <cstdint>
+#include <iostream>
 #include <verilated_cov.h>
 #include <gtest/gtest.h>
 #include <bit>
@@ -33,7 +35,11 @@ protected:
         top->start = 0;
         top->c_re = 0;
         top->c_im = 0;
+        top->z0_re = 0;
+        top->z0_im = 0;
         top->max_iter = 0;
+        top->period_en = 0;
+        top->period_eps = 0;
     }
 
     void resetDUT() {
@@ -46,20 +52,27 @@ protected:
     }
 
     uint32_t run_test(double c_real, double c_imag, uint32_t max_iter) {
+        return run_fixed(double_to_fixed_point(c_real), double_to_fixed_point(c_imag), max_iter);
+    }
+
+    // Runs one pixel given raw Q4.28 inputs; optionally reports the clocks
+    // from start to ready.
+    uint32_t run_fixed(int32_t c_re, int32_t c_im, uint32_t max_iter, unsigned int *cycles = nullptr) {
         // Wait for ready state
         while (!top->ready) {
             clockCycle();
         }
 
         // Set up inputs
-        top->c_re = double_to_fixed_point(c_real);
-        top->c_im = double_to_fixed_point(c_imag);
+        top->c_re = c_re;
+        top->c_im = c_im;
         top->max_iter = max_iter;
         
         // Start calculation
         top->start = 1;
         clockCycle();
         top->start = 0;
+        unsigned int start_tick = ticks;
 
         // Wait for completion with timeout
         int timeout = (max_iter + 10) * 3; // Extra margin for pipeline delays
@@ -69,6 +82,7 @@ protected:
         }
 
         EXPECT_NE(timeout, 0) << "Simulation timed out!";
+        if (cycles) *cycles = ticks - start_tick;
         
         uint32_t final_iter_count = top->iterations;
 
@@ -179,4 +193,162 @@ TEST_F(MandelbrotCalculatorTestbench, PointInMainCardioid) {
     const uint32_t max_iter = 100;
     uint32_t result = run_test(-0.1, 0.0, max_iter);
     EXPECT_EQ(result, max_iter);
-}
\ No newline at end of file
+}
+
+// Test 11: Every point of a grid over the default view must give exactly the
+// iteration count of the original two-clock calculator.
+TEST_F(MandelbrotCalculatorTestbench, GridMatchesTwoPhaseReference) {
+    resetDUT();
+    const uint32_t max_iter = 60;
+    const int n = 32;
+    for (int j = 0; j < n; j++) {
+        for (int i = 0; i < n; i++) {
+            int32_t c_re = double_to_fixed_point(-2.5 + 3.5 * i / (n - 1));
+            int32_t c_im = double_to_fixed_point(-1.5 + 3.0 * j / (n - 1));
+            uint32_t expected = mandelbrot_model::iterations(c_re, c_im, max_iter);
+            ASSERT_EQ(run_fixed(c_re, c_im, max_iter), expected)
+                << "c = (" << c_re << ", " << c_im << ")";
+        }
+    }
+}
+
+// Test 12: Large |c| wraps the Q4.28 squares; the result must still match
+TEST_F(MandelbrotCalculatorTestbench, WrappingMatchesTwoPhaseReference) {
+    resetDUT();
+    const uint32_t max_iter = 20;
+    const double values[] = {-7.9, -3.0, -1.99, 1.5, 3.3, 7.9};
+    for (double re : values) {
+        for (double im : values) {
+            int32_t c_re = double_to_fixed_point(re);
+            int32_t c_im = double_to_fixed_point(im);
+            EXPECT_EQ(run_fixed(c_re, c_im, max_iter), mandelbrot_model::iterations(c_re, c_im, max_iter))
+                << "c = (" << re << ", " << im << ")";
+        }
+    }
+}
+
+// Test 13: One iteration per clock. An interior point takes max_iter clocks
+// plus a small constant for the start/ready handshake.
+TEST_F(MandelbrotCalculatorTestbench, OneIterationPerCycle) {
+    resetDUT();
+    const uint32_t max_iter = 200;
+    unsigned int cycles = 0;
+    uint32_t result = run_fixed(0, 0, max_iter, &cycles);
+    EXPECT_EQ(result, max_iter);
+    EXPECT_LE(cycles, max_iter + 2) << "Calculator is not iterating once per clock";
+}
+
+// Test 14: max_iter = 0 finishes immediately with zero iterations
+TEST_F(MandelbrotCalculatorTestbench, ZeroMaxIterations) {
+    resetDUT();
+    EXPECT_EQ(run_test(0.0, 0.0, 0), 0);
+    EXPECT_EQ(run_test(2.0, 0.0, 0), 0);
+}
+
+// Test 15: With periodicity checking, the orbit of c = 0 repeats at once
+TEST_F(MandelbrotCalculatorTestbench, PeriodicityBailsOutOnFixedPoint) {
+    resetDUT();
+    top->period_en = 1;
+    top->period_eps = 16;
+    unsigned int cycles = 0;
+    EXPECT_EQ(run_fixed(0, 0, 1000, &cycles), 1000);
+    EXPECT_LT(cycles, 10);
+}
+
+// Test 16: Benchmark on standard views. Results must stay identical to the
+// full iteration while interior points finish early.
+TEST_F(MandelbrotCalculatorTestbench, PeriodicitySavesIterationsOnStandardViews) {
+    struct View { const char *name; double re, im, width; };
+    const View views[] = {
+        {"full set",        -0.7,    0.0,   3.0},
+        {"seahorse valley", -0.745,  0.113, 0.1},
+        {"upper bulb edge", -0.1,    0.9,   0.3},
+    };
+    const uint32_t max_iter = 1000;
+    const int n = 24;
+
+    resetDUT();
+    top->period_eps = 16;   // 2^-24
+    for (const View &v : views) {
+        unsigned long full_cycles = 0, period_cycles = 0;
+        for (int j = 0; j < n; j++) {
+            for (int i = 0; i < n; i++) {
+                int32_t c_re = double_to_fixed_point(v.re - v.width / 2 + v.width * i / (n - 1));
+                int32_t c_im = double_to_fixed_point(v.im - v.width / 2 + v.width * j / (n - 1));
+                unsigned int cycles = 0;
+
+                top->period_en = 0;
+                uint32_t full = run_fixed(c_re, c_im, max_iter, &cycles);
+                full_cycles += cycles;
+
+                top->period_en = 1;
+                ASSERT_EQ(run_fixed(c_re, c_im, max_iter, &cycles), full)
+                    << v.name << ": c = (" << c_re << ", " << c_im << ")";
+                period_cycles += cycles;
+            }
+        }
+        std::cout << "[ BENCH    ] " << v.name << ": " << full_cycles << " -> " << period_cycles
+                  << " cycles (" << 100.0 * (full_cycles - period_cycles) / full_cycles << "% saved)"
+                  << std::endl;
+        EXPECT_LT(period_cycles, full_cycles) << v.name;
+    }
+}
+
+// Test 17: magnitude holds the |z|^2 that ended the loop, including when
+// the squares wrap
+TEST_F(MandelbrotCalculatorTestbench, MagnitudeMatchesReference) {
+    resetDUT();
+    const uint32_t max_iter = 40;
+    const double values[] = {-7.9, -2.1, -1.2, -0.3, 0.26, 0.5, 1.5, 7.9};
+    for (double re : values) {
+        for (double im : values) {
+            int32_t c_re = double_to_fixed_point(re);
+            int32_t c_im = double_to_fixed_point(im);
+            uint32_t expected_mag;
+            uint32_t expected = mandelbrot_model::iterations(c_re, c_im, max_iter, &expected_mag);
+            EXPECT_EQ(run_fixed(c_re, c_im, max_iter), expected) << "c = (" << re << ", " << im << ")";
+            EXPECT_EQ(top->magnitude, expected_mag) << "c = (" << re << ", " << im << ")";
+        }
+    }
+
+    // c = 2: z_1 = 2 is the first point with |z|^2 >= 4, reported as 2 iterations
+    EXPECT_EQ(run_test(2.0, 0.0, max_iter), 2u);
+    EXPECT_EQ(top->magnitude, 0x40000000u);
+}
+
+// Test 18: Julia mode starts from the pixel with a constant c. Every point
+// of a grid around the Julia set of c = -0.8 + 0.156i must match the model.
+TEST_F(MandelbrotCalculatorTestbench, JuliaGridMatchesReference) {
+    resetDUT();
+    const uint32_t max_iter = 100;
+    const int32_t c_re = double_to_fixed_point(-0.8);
+    const int32_t c_im = double_to_fixed_point(0.156);
+    const int n = 24;
+    for (int j = 0; j < n; j++) {
+        for (int i = 0; i < n; i++) {
+            int32_t z_re = double_to_fixed_point(-1.6 + 3.2 * i / (n - 1));
+            int32_t z_im = double_to_fixed_point(-1.2 + 2.4 * j / (n - 1));
+            top->z0_re = z_re;
+            top->z0_im = z_im;
+            uint32_t expected = mandelbrot_model::iterations_from(z_re, z_im, c_re, c_im, max_iter);
+            ASSERT_EQ(run_fixed(c_re, c_im, max_iter), expected)
+                << "z0 = (" << z_re << ", " << z_im << ")";
+        }
+    }
+}
+
+// Test 19: Julia mode keeps one iteration per clock. With c = 0 the set is
+// the unit disk, so z0 = 0.5 never escapes.
+TEST_F(MandelbrotCalculatorTestbench, JuliaOneIterationPerCycle) {
+    resetDUT();
+    const uint32_t max_iter = 200;
+    top->z0_re = double_to_fixed_point(0.5);
+    top->z0_im = 0;
+    unsigned int cycles = 0;
+    EXPECT_EQ(run_fixed(0, 0, max_iter, &cycles), max_iter);
+    EXPECT_LE(cycles, max_iter + 2) << "Julia mode is not iterating once per clock";
+
+    // z0 = 2 is outside the disk and escapes on the first test
+    top->z0_re = double_to_fixed_point(2.0);
+    EXPECT_EQ(run_fixed(0, 0, max_iter), 1u);
+}
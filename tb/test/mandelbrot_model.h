@@ -0,0 +1,418 @@
+#pragma once
+
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <initializer_list>
+#include <vector>
+
+/**
+ * Bit-exact C++ model of the single-lane datapath:
+ * screen_mapper -> mandelbrot_calculator -> color_mapper -> packer.
+ * Multi-lane and alternative engines must reproduce these values exactly.
+ */
+namespace mandelbrot_model {
+
+constexpr int X_SIZE = 640;
+constexpr int Y_SIZE = 480;
+
+struct Complex {
+    int32_t re;
+    int32_t im;
+};
+
+// screen_mapper: centre, shift into Q4.28 pixel steps, zoom, add pan
+inline Complex screen_map(int x, int y, int32_t pan_x, int32_t pan_y, uint8_t zoom,
+                          int width = X_SIZE, int height = Y_SIZE) {
+    int zoom_limited = (zoom > 24) ? 24 : zoom;
+    int64_t x_fixed = static_cast<int64_t>(x - width / 2) * (1LL << 24);
+    int64_t y_fixed = static_cast<int64_t>(y - height / 2) * (1LL << 24);
+    int32_t x_scaled = static_cast<int32_t>((x_fixed >> zoom_limited) >> 4);
+    int32_t y_scaled = static_cast<int32_t>((y_fixed >> zoom_limited) >> 4);
+    return {
+        static_cast<int32_t>(static_cast<uint32_t>(x_scaled) + static_cast<uint32_t>(pan_x)),
+        static_cast<int32_t>(static_cast<uint32_t>(y_scaled) + static_cast<uint32_t>(pan_y))
+    };
+}
+
+// Bits [59:28] of a signed 32x32 product, as sliced by the calculator
+inline uint32_t q4_28_product(int32_t a, int32_t b) {
+    int64_t p = static_cast<int64_t>(a) * static_cast<int64_t>(b);
+    return static_cast<uint32_t>(static_cast<uint64_t>(p) >> 28);
+}
+
+inline uint32_t q4_28_double_product(int32_t a, int32_t b) {
+    int64_t p = static_cast<int64_t>(a) * static_cast<int64_t>(b);
+    return static_cast<uint32_t>((static_cast<uint64_t>(p) << 1) >> 28);
+}
+
+// mandelbrot_calculator: the escape test at iteration n looks at the
+// squares latched while computing z_n, i.e. |z_(n-1)|^2, with 32-bit wrap.
+// magnitude receives that last |z|^2 (the calculator's magnitude output).
+// The orbit starts at z0: 0 for the Mandelbrot set, the pixel for Julia.
+inline uint32_t iterations_from(int32_t z_re, int32_t z_im, int32_t c_re, int32_t c_im, uint32_t max_iter,
+                                uint32_t *magnitude = nullptr) {
+    const uint32_t ESCAPE_THRESHOLD = 0x40000000u;
+    uint32_t re_sq = 0, im_sq = 0;
+    uint32_t iter = 0;
+
+    while (true) {
+        if (magnitude) *magnitude = re_sq + im_sq;
+        if (iter >= max_iter) return iter;
+        if (iter > 0 && static_cast<uint32_t>(re_sq + im_sq) >= ESCAPE_THRESHOLD) return iter;
+
+        re_sq = q4_28_product(z_re, z_re);
+        im_sq = q4_28_product(z_im, z_im);
+        uint32_t two_ab = q4_28_double_product(z_re, z_im);
+
+        z_re = static_cast<int32_t>(re_sq - im_sq + static_cast<uint32_t>(c_re));
+        z_im = static_cast<int32_t>(two_ab + static_cast<uint32_t>(c_im));
+        iter++;
+    }
+}
+
+inline uint32_t iterations(int32_t c_re, int32_t c_im, uint32_t max_iter, uint32_t *magnitude = nullptr) {
+    return iterations_from(0, 0, c_re, c_im, max_iter, magnitude);
+}
+
+// color_mapper + packer: {8'h00, r, g, b}
+inline uint32_t color(uint32_t iter, uint32_t max_iter) {
+    if (iter >= max_iter) return 0;
+
+    uint32_t stretched = iter * 4;
+    uint8_t ramp = stretched & 0xFF;
+    uint8_t r, g, b;
+    switch ((stretched >> 8) & 0x3) {
+        case 0:  r = ramp; g = 0;     b = 0;     break;
+        case 1:  r = 255;  g = ramp;  b = 0;     break;
+        case 2:  r = ~ramp; g = 255;  b = ramp;  break;
+        default: r = 0;    g = ~ramp; b = 255;   break;
+    }
+    return (static_cast<uint32_t>(r) << 16) | (static_cast<uint32_t>(g) << 8) | b;
+}
+
+inline uint32_t pixel(int x, int y, int32_t pan_x, int32_t pan_y, uint8_t zoom, uint32_t max_iter,
+                      int width = X_SIZE, int height = Y_SIZE) {
+    Complex c = screen_map(x, y, pan_x, pan_y, zoom, width, height);
+    return color(iterations(c.re, c.im, max_iter), max_iter);
+}
+
+// Julia mode: the mapped pixel is z0 and c is the JULIA_RE/IM constant
+inline uint32_t pixel_julia(int x, int y, int32_t pan_x, int32_t pan_y, uint8_t zoom,
+                            int32_t julia_re, int32_t julia_im, uint32_t max_iter) {
+    Complex z0 = screen_map(x, y, pan_x, pan_y, zoom);
+    return color(iterations_from(z0.re, z0.im, julia_re, julia_im, max_iter), max_iter);
+}
+
+// progressive_scheduler: a pass with sample spacing step shows each
+// sample over the step x step block below and to its right
+inline uint32_t pixel_progressive(int x, int y, int step, uint32_t max_iter) {
+    return pixel(x & ~(step - 1), y & ~(step - 1), 0, 0, 0, max_iter);
+}
+
+// pan_scheduler with MIRROR_EN at a view on the real axis: rows below the
+// centre row show the row as far above it
+inline uint32_t pixel_mirrored(int x, int y, int32_t pan_x, uint8_t zoom, uint32_t max_iter) {
+    return pixel(x, (y > Y_SIZE / 2) ? Y_SIZE - y : y, pan_x, 0, zoom, max_iter);
+}
+
+// tile_scheduler: Mariani-Silver over tile x tile squares, with count(x, y)
+// the iteration count of an iterated pixel. Returns the iteration count of
+// every pixel in raster order; filled counts the pixels that were never
+// iterated.
+template <typename Count>
+inline std::vector<uint32_t> iterations_tiled(Count count, int tile, uint32_t *filled = nullptr) {
+    std::vector<uint32_t> iter(X_SIZE * Y_SIZE);
+    std::vector<bool> known(X_SIZE * Y_SIZE, false);
+    uint32_t fills = 0;
+
+    auto compute = [&](int x, int y) {
+        if (!known[y * X_SIZE + x]) {
+            iter[y * X_SIZE + x] = count(x, y);
+            known[y * X_SIZE + x] = true;
+        }
+    };
+
+    // The border of (x0, y0, s) is known on entry
+    auto rect = [&](auto &self, int x0, int y0, int s) -> void {
+        uint32_t first = iter[y0 * X_SIZE + x0];
+        bool uniform = true;
+        for (int j = 0; j < s; j++) {
+            for (int i = 0; i < s; i++) {
+                bool border = i == 0 || j == 0 || i == s - 1 || j == s - 1;
+                if (border && iter[(y0 + j) * X_SIZE + x0 + i] != first) uniform = false;
+            }
+        }
+        int h = s / 2;
+        for (int j = 1; j < s - 1; j++) {
+            for (int i = 1; i < s - 1; i++) {
+                if (uniform) {
+                    iter[(y0 + j) * X_SIZE + x0 + i] = first;
+                    known[(y0 + j) * X_SIZE + x0 + i] = true;
+                    fills++;
+                } else if (i == h - 1 || i == h || j == h - 1 || j == h) {
+                    compute(x0 + i, y0 + j);
+                }
+            }
+        }
+        if (!uniform && s > 4) {
+            self(self, x0, y0, h);
+            self(self, x0 + h, y0, h);
+            self(self, x0, y0 + h, h);
+            self(self, x0 + h, y0 + h, h);
+        }
+    };
+
+    for (int ty = 0; ty < Y_SIZE; ty += tile) {
+        for (int tx = 0; tx < X_SIZE; tx += tile) {
+            for (int j = 0; j < tile; j++) {
+                for (int i = 0; i < tile; i++) {
+                    if (i == 0 || j == 0 || i == tile - 1 || j == tile - 1) compute(tx + i, ty + j);
+                }
+            }
+            rect(rect, tx, ty, tile);
+        }
+    }
+    if (filled) *filled = fills;
+    return iter;
+}
+
+// ... at the default view
+inline std::vector<uint32_t> iterations_tiled(uint32_t max_iter, int tile, uint32_t *filled = nullptr) {
+    auto count = [max_iter](int x, int y) {
+        Complex c = screen_map(x, y, 0, 0, 0);
+        return iterations(c.re, c.im, max_iter);
+    };
+    return iterations_tiled(count, tile, filled);
+}
+
+// -- Q8.56 deep-zoom datapath (WIDE_LANES) --
+
+struct WideComplex {
+    int64_t re;
+    int64_t im;
+};
+
+// screen_mapper #(64, 56): pixel step 2^-8 at zoom 0, zoom clamped to 52
+inline WideComplex screen_map_wide(int x, int y, int64_t pan_x, int64_t pan_y, uint8_t zoom) {
+    int zoom_limited = (zoom > 52) ? 52 : zoom;
+    __int128 x_fixed = static_cast<__int128>(x - X_SIZE / 2) << 52;
+    __int128 y_fixed = static_cast<__int128>(y - Y_SIZE / 2) << 52;
+    int64_t x_scaled = static_cast<int64_t>((x_fixed >> zoom_limited) >> 4);
+    int64_t y_scaled = static_cast<int64_t>((y_fixed >> zoom_limited) >> 4);
+    return {
+        static_cast<int64_t>(static_cast<uint64_t>(x_scaled) + static_cast<uint64_t>(pan_x)),
+        static_cast<int64_t>(static_cast<uint64_t>(y_scaled) + static_cast<uint64_t>(pan_y))
+    };
+}
+
+// Bits [119:56] of a signed 64x64 product
+inline uint64_t q8_56_product(int64_t a, int64_t b) {
+    __int128 p = static_cast<__int128>(a) * static_cast<__int128>(b);
+    return static_cast<uint64_t>(static_cast<unsigned __int128>(p) >> 56);
+}
+
+inline uint64_t q8_56_double_product(int64_t a, int64_t b) {
+    __int128 p = static_cast<__int128>(a) * static_cast<__int128>(b);
+    return static_cast<uint64_t>((static_cast<unsigned __int128>(p) << 1) >> 56);
+}
+
+// Same loop as iterations(), in Q8.56 with 64-bit wrap. magnitude is the
+// last |z|^2 in Q4.28, saturating at 32 bits.
+inline uint32_t iterations_wide(int64_t c_re, int64_t c_im, uint32_t max_iter, uint32_t *magnitude = nullptr) {
+    const uint64_t ESCAPE_THRESHOLD = 4ULL << 56;
+    int64_t z_re = 0, z_im = 0;
+    uint64_t re_sq = 0, im_sq = 0;
+    uint32_t iter = 0;
+
+    while (true) {
+        if (magnitude) {
+            uint64_t mag = static_cast<uint64_t>(re_sq + im_sq) >> 28;
+            *magnitude = (mag > 0xFFFFFFFFULL) ? 0xFFFFFFFFu : static_cast<uint32_t>(mag);
+        }
+        if (iter >= max_iter) return iter;
+        if (iter > 0 && static_cast<uint64_t>(re_sq + im_sq) >= ESCAPE_THRESHOLD) return iter;
+
+        re_sq = q8_56_product(z_re, z_re);
+        im_sq = q8_56_product(z_im, z_im);
+        uint64_t two_ab = q8_56_double_product(z_re, z_im);
+
+        z_re = static_cast<int64_t>(re_sq - im_sq + static_cast<uint64_t>(c_re));
+        z_im = static_cast<int64_t>(two_ab + static_cast<uint64_t>(c_im));
+        iter++;
+    }
+}
+
+inline uint32_t pixel_wide(int x, int y, int64_t pan_x, int64_t pan_y, uint8_t zoom, uint32_t max_iter) {
+    WideComplex c = screen_map_wide(x, y, pan_x, pan_y, zoom);
+    return color(iterations_wide(c.re, c.im, max_iter), max_iter);
+}
+
+// coord_generator (CTRL_SCALE_EN): Q8.56 origin plus x steps of dx and
+// y steps of dy, wrapped to 64 bits, for any scheduler
+struct AffineView {
+    int64_t origin_re, origin_im;
+    int64_t dx_re, dx_im;
+    int64_t dy_re, dy_im;
+};
+
+inline WideComplex coord_step(int x, int y, const AffineView &v) {
+    auto wrap = [](int64_t origin, int n, int64_t d, int m, int64_t e) {
+        return static_cast<int64_t>(static_cast<uint64_t>(origin) +
+                                    static_cast<uint64_t>(n) * static_cast<uint64_t>(d) +
+                                    static_cast<uint64_t>(m) * static_cast<uint64_t>(e));
+    };
+    return {wrap(v.origin_re, x, v.dx_re, y, v.dy_re), wrap(v.origin_im, x, v.dx_im, y, v.dy_im)};
+}
+
+// Square pixels, no rotation
+inline AffineView scaled_view(int64_t origin_re, int64_t origin_im, int64_t step) {
+    return {origin_re, origin_im, step, 0, 0, step};
+}
+
+// The Q4.28 lanes take bits [59:28] of the stepped coordinate
+inline uint32_t iterations_stepped(int x, int y, const AffineView &v, uint32_t max_iter) {
+    WideComplex c = coord_step(x, y, v);
+    return iterations(static_cast<int32_t>(c.re >> 28), static_cast<int32_t>(c.im >> 28), max_iter);
+}
+
+inline uint32_t pixel_stepped(int x, int y, const AffineView &v, uint32_t max_iter) {
+    return color(iterations_stepped(x, y, v, max_iter), max_iter);
+}
+
+// -- Perturbation datapath (PERTURB_LANES) --
+// Values are pairs of mantissas sharing an exponent, (re + i*im) * 2^exp,
+// normalized so the larger component has its top bit at bit 29.
+
+constexpr int32_t DELTA_EXP_ZERO = -16384;
+constexpr int DELTA_NORM = 29;
+
+struct DeltaFloat {
+    int32_t re;
+    int32_t im;
+    int32_t exp;
+};
+
+struct DeltaTerm {
+    int64_t re;
+    int64_t im;
+    int32_t exp;
+};
+
+inline int64_t shift_right(int64_t v, int64_t s) {
+    if (s >= 63) return v < 0 ? -1 : 0;
+    return v >> s;
+}
+
+inline int64_t shift_left(int64_t v, int s) {
+    return static_cast<int64_t>(static_cast<uint64_t>(v) << s);
+}
+
+// perturb_normalize: align to the largest exponent, add, renormalize
+inline DeltaFloat delta_normalize(std::initializer_list<DeltaTerm> terms) {
+    int32_t emax = INT32_MIN;
+    for (const DeltaTerm &t : terms) emax = std::max(emax, t.exp);
+
+    int64_t sum_re = 0, sum_im = 0;
+    for (const DeltaTerm &t : terms) {
+        sum_re += shift_right(t.re, static_cast<int64_t>(emax) - t.exp);
+        sum_im += shift_right(t.im, static_cast<int64_t>(emax) - t.exp);
+    }
+
+    uint64_t mag = static_cast<uint64_t>(sum_re < 0 ? -sum_re : sum_re) |
+                   static_cast<uint64_t>(sum_im < 0 ? -sum_im : sum_im);
+    if (mag == 0) return {0, 0, DELTA_EXP_ZERO};
+
+    int lead = 63 - __builtin_clzll(mag);
+    int sh = lead - DELTA_NORM;
+    if (sh > 0) {
+        sum_re >>= sh;
+        sum_im >>= sh;
+    } else {
+        sum_re = shift_left(sum_re, -sh);
+        sum_im = shift_left(sum_im, -sh);
+    }
+    return {static_cast<int32_t>(sum_re), static_cast<int32_t>(sum_im), emax + sh};
+}
+
+// A reference orbit entry from fixed point with frac fractional bits
+inline DeltaFloat delta_from_fixed(int64_t re, int64_t im, int frac) {
+    DeltaFloat d = delta_normalize({{re, im, 0}});
+    if (d.exp != DELTA_EXP_ZERO) d.exp -= frac;
+    return d;
+}
+
+inline uint64_t delta_mag(const DeltaFloat &d) {
+    return static_cast<uint64_t>(static_cast<int64_t>(d.re) * d.re) +
+           static_cast<uint64_t>(static_cast<int64_t>(d.im) * d.im);
+}
+
+struct PerturbStats {
+    uint32_t rebases = 0;
+    uint32_t glitches = 0;
+};
+
+// perturb_calculator: z_n = Z_m + dz, dz' = 2 Z_m dz + dz^2 + dc. Rebases
+// to m = 0 (one extra clock, no iteration) when |z| < |dz| or the orbit
+// runs out.
+inline uint32_t iterations_perturb(const std::vector<DeltaFloat> &orbit, uint32_t ref_len,
+                                   int dc_re, int dc_im, int dc_exp, uint32_t max_iter,
+                                   PerturbStats *stats = nullptr, uint32_t *magnitude = nullptr) {
+    const DeltaFloat dc = delta_normalize({{dc_re, dc_im, dc_exp}});
+    DeltaFloat dz = {0, 0, DELTA_EXP_ZERO};
+    uint32_t n = 0, m = 0;
+    if (magnitude) *magnitude = 0;
+
+    while (true) {
+        const DeltaFloat &Z = orbit[m];
+        DeltaFloat z = delta_normalize({{Z.re, Z.im, Z.exp}, {dz.re, dz.im, dz.exp}});
+
+        uint64_t z_mag = delta_mag(z);
+        int escape_shift = 2 - 2 * z.exp;
+        bool escaped = (escape_shift <= 0) ? (z_mag != 0) :
+                       (escape_shift > 63) ? false : (z_mag >= (1ULL << escape_shift));
+
+        if (n >= max_iter) return n;
+        if (n + 1 >= max_iter || escaped) {
+            // z_mag * 2^(2 * exp + 28), saturating at 32 bits
+            if (magnitude) {
+                int mag_shift = escape_shift - 30;
+                uint64_t mag = (mag_shift > 63) ? 0 :
+                               (mag_shift >= 0) ? (z_mag >> mag_shift) :
+                               (z_mag != 0) ? ~0ULL : 0;
+                *magnitude = (mag > 0xFFFFFFFFULL) ? 0xFFFFFFFFu : static_cast<uint32_t>(mag);
+            }
+            return n + 1;
+        }
+
+        unsigned __int128 zm = z_mag, dm = delta_mag(dz);
+        int gap = z.exp - dz.exp;
+        bool below = (gap >= 2) ? false : (gap <= -2) ? true :
+                     (gap == 1) ? ((zm << 2) < dm) : (gap == -1) ? (zm < (dm << 2)) : (zm < dm);
+
+        if (m != 0 && (below || m + 1 >= ref_len)) {
+            if (stats) {
+                stats->rebases++;
+                if (below) stats->glitches++;
+            }
+            dz = z;
+            m = 0;
+            continue;
+        }
+
+        int64_t lin_re = static_cast<int64_t>(Z.re) * dz.re - static_cast<int64_t>(Z.im) * dz.im;
+        int64_t lin_im = static_cast<int64_t>(Z.re) * dz.im + static_cast<int64_t>(Z.im) * dz.re;
+        int64_t sq_re  = static_cast<int64_t>(dz.re) * dz.re - static_cast<int64_t>(dz.im) * dz.im;
+        int64_t dr_di  = static_cast<int64_t>(dz.re) * dz.im;
+
+        dz = delta_normalize({
+            {lin_re >> 30, lin_im >> 30, Z.exp + dz.exp + 31},
+            {sq_re >> 30, dr_di >> 29, 2 * dz.exp + 30},
+            {dc.re, dc.im, dc.exp}
+        });
+        m++;
+        n++;
+    }
+}
+
+} // namespace mandelbrot_model
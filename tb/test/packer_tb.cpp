@@ -23,6 +23,10 @@ protected:
         top->r = 0;
         top->g = 0;
         top->b = 0;
+        top->ext = 0;
+        top->iterations = 0;
+        top->magnitude = 0;
+        top->raw = 0;
         top->eol = 0;
         top->valid = 0;
         top->sof = 0;
@@ -338,4 +342,87 @@ TEST_F(PackerTestbench, RapidFireTest) {
     EXPECT_EQ(top->out_stream_tvalid, 0) << "Should be back in STATE_IDLE";
     
     printf("Rapid fire test passed\n");
-}
\ No newline at end of file
+}
+
+// Test 9: Extended mode sends iterations, then |z|^2, for each pixel
+TEST_F(PackerTestbench, ExtendedModeTest) {
+    resetDUT();
+
+    printf("=== Extended Mode Test ===\n");
+
+    const uint32_t iters[2] = {17, 42};
+    const uint32_t mags[2] = {0x4A000000, 0x7FFFFFFF};
+    for (int i = 0; i < 2; i++) {
+        bool is_sof = (i == 0);
+        bool is_eol = (i == 1);
+
+        top->ext = 1;
+        top->iterations = iters[i];
+        top->magnitude = mags[i];
+        sendPixel(0x12, 0x34, 0x56, is_sof, is_eol);
+
+        // First beat: iteration count, carries TUSER but never TLAST
+        checkOutput(iters[i], false, is_sof);
+        EXPECT_EQ(top->in_stream_ready, 0) << "Input must wait for the second beat";
+        acceptOutput();
+
+        // Second beat: |z|^2, carries TLAST at the end of a line
+        checkOutput(mags[i], is_eol, false);
+        acceptOutput();
+        EXPECT_EQ(top->out_stream_tvalid, 0) << "Should be back in STATE_IDLE";
+    }
+
+    // Back to RGB for the next pixel
+    top->ext = 0;
+    sendPixel(0x12, 0x34, 0x56, false, false);
+    checkOutput(formatPixel(0x12, 0x34, 0x56), false, false);
+    acceptOutput();
+    EXPECT_EQ(top->out_stream_tvalid, 0);
+
+    printf("Extended mode test passed\n");
+}
+
+// Test 10: Raw mode packs two saturated 16-bit counts per beat
+TEST_F(PackerTestbench, RawModeTest) {
+    resetDUT();
+
+    printf("=== Raw Mode Test ===\n");
+
+    top->raw = 1;
+
+    // First of a pair: accepted without a beat
+    top->iterations = 0x1234;
+    sendPixel(0, 0, 0, true, false);
+    EXPECT_EQ(top->out_stream_tvalid, 0) << "The first pixel of a pair must wait for the second";
+    EXPECT_EQ(top->in_stream_ready, 1);
+
+    // Second of the pair: one beat with the first pixel's TUSER
+    top->iterations = 0x12345;
+    sendPixel(0, 0, 0, false, false);
+    checkOutput(0xFFFF1234, false, true);
+    acceptOutput();
+    EXPECT_EQ(top->out_stream_tvalid, 0);
+
+    // A pair that ends the line carries TLAST
+    top->iterations = 7;
+    sendPixel(0, 0, 0, false, false);
+    top->iterations = 9;
+    sendPixel(0, 0, 0, false, true);
+    checkOutput(0x00090007, true, false);
+    acceptOutput();
+
+    // An odd pixel at the end of a line goes out alone
+    top->iterations = 5;
+    sendPixel(0, 0, 0, false, true);
+    checkOutput(0x00000005, true, false);
+    acceptOutput();
+
+    // Back to RGB for the next pixel
+    top->raw = 0;
+    sendPixel(0x12, 0x34, 0x56, false, false);
+    checkOutput(formatPixel(0x12, 0x34, 0x56), false, false);
+    acceptOutput();
+    EXPECT_EQ(top->out_stream_tvalid, 0);
+
+    printf("Raw mode test passed\n");
+}
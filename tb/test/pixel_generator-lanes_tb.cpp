@@ -0,0 +1,985 @@
+#include "pixel_generator_testbench.h"
+#include "mandelbrot_model.h"
+// The host's GMP reference orbit, as the app loads it
+#include "../../mandelbrot_final_app/ref_orbit.cpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <gtest/gtest.h>
+#include <verilated_cov.h>
+
+// Global tick counter
+unsigned int ticks = 0;
+
+class PixelGeneratorLanesTestbench : public PixelGeneratorTestbench {
+protected:
+    // Capture a full frame generated with the given max_iter at the default
+    // view (pan = 0, zoom = 0), starting from pixel (0, 0).
+    std::vector<PixelData> render(uint32_t max_iter, uint32_t ctrl = 0, uint32_t period_eps = 0) {
+        resetDUT();
+        holdGenerator();
+        axi_lite_write(0x00, max_iter);
+        axi_lite_write(0x10, ctrl);
+        axi_lite_write(0x14, period_eps);
+        releaseGenerator();
+        return read_frame(mandelbrot_model::X_SIZE, mandelbrot_model::Y_SIZE);
+    }
+
+    // Capture a frame on the Q8.56 path with a 64-bit pan
+    std::vector<PixelData> renderWide(uint32_t max_iter, int64_t pan_x, int64_t pan_y, uint8_t zoom) {
+        resetDUT();
+        holdGenerator();
+        axi_lite_write(0x00, max_iter);
+        axi_lite_write(0x0C, zoom);
+        axi_lite_write(0x20, static_cast<uint32_t>(pan_x));
+        axi_lite_write(0x24, static_cast<uint32_t>(static_cast<uint64_t>(pan_x) >> 32));
+        axi_lite_write(0x28, static_cast<uint32_t>(pan_y));
+        axi_lite_write(0x2C, static_cast<uint32_t>(static_cast<uint64_t>(pan_y) >> 32));
+        axi_lite_write(0x10, 0x4);
+        releaseGenerator();
+        return read_frame(mandelbrot_model::X_SIZE, mandelbrot_model::Y_SIZE);
+    }
+
+    // Capture a frame stepped across an affine view with CTRL_SCALE_EN
+    std::vector<PixelData> renderScaled(uint32_t max_iter, const mandelbrot_model::AffineView &view,
+                                        uint32_t ctrl = 0) {
+        resetDUT();
+        holdGenerator();
+        axi_lite_write(0x00, max_iter);
+        auto write_wide = [this](uint32_t offset, int64_t value) {
+            axi_lite_write(offset, static_cast<uint32_t>(value));
+            axi_lite_write(offset + 4, static_cast<uint32_t>(static_cast<uint64_t>(value) >> 32));
+        };
+        write_wide(0x50, view.origin_re);
+        write_wide(0x58, view.origin_im);
+        write_wide(0x60, view.dx_re);
+        write_wide(0x68, view.dx_im);
+        write_wide(0x70, view.dy_re);
+        write_wide(0x78, view.dy_im);
+        axi_lite_write(0x10, ctrl | 0x800);
+        releaseGenerator();
+        return read_frame(mandelbrot_model::X_SIZE, mandelbrot_model::Y_SIZE);
+    }
+
+    // Load a reference orbit through the ORBIT_INDEX/ORBIT_DATA port
+    void loadOrbit(const std::vector<mandelbrot_model::DeltaFloat> &orbit) {
+        axi_lite_write(0x34, 0);
+        for (const auto &z : orbit) {
+            axi_lite_write(0x38, static_cast<uint32_t>(z.re));
+            axi_lite_write(0x38, static_cast<uint32_t>(z.im));
+            axi_lite_write(0x38, static_cast<uint32_t>(z.exp) & 0xFFFF);
+        }
+        axi_lite_write(0x30, orbit.size());
+    }
+
+    // Checks an extended-stream frame against reference(x, y, &magnitude),
+    // which returns the iteration count, with the framing of expectFrame.
+    // Escaped pixels must report |z|^2 >= 4. Returns how many of them
+    // saturate at 0xFFFFFFFF.
+    template <typename Reference>
+    int expectExtendedFrame(const std::vector<PixelData> &beats, uint32_t max_iter, Reference reference) {
+        using namespace mandelbrot_model;
+        EXPECT_EQ(beats.size(), 2 * X_SIZE * Y_SIZE) << "Did not receive the complete frame.";
+        if (beats.size() != 2 * X_SIZE * Y_SIZE) return 0;
+
+        int mismatches = 0;
+        int saturated = 0;
+        for (int y = 0; y < Y_SIZE; y++) {
+            for (int x = 0; x < X_SIZE; x++) {
+                const PixelData &first = beats[2 * (y * X_SIZE + x)];
+                const PixelData &second = beats[2 * (y * X_SIZE + x) + 1];
+                uint32_t magnitude;
+                uint32_t iter = reference(x, y, &magnitude);
+
+                bool wrong = first.data != iter || (iter < max_iter && second.data != magnitude);
+                if (wrong && mismatches++ < 10) {
+                    ADD_FAILURE() << "Pixel (" << x << ", " << y << ") = " << first.data << ", 0x" << std::hex
+                                  << second.data << "; reference = " << std::dec << iter << ", 0x" << std::hex
+                                  << magnitude << std::dec;
+                }
+                if (iter < max_iter) {
+                    EXPECT_GE(second.data, 0x40000000u) << "Escaped below |z|^2 = 4 at (" << x << ", " << y << ")";
+                    saturated += second.data == 0xFFFFFFFFu;
+                }
+                EXPECT_EQ(first.user, x == 0 && y == 0) << "TUSER wrong at (" << x << ", " << y << ")";
+                EXPECT_FALSE(second.user);
+                EXPECT_FALSE(first.last);
+                EXPECT_EQ(second.last, x == X_SIZE - 1) << "TLAST wrong at (" << x << ", " << y << ")";
+            }
+        }
+        EXPECT_EQ(mismatches, 0);
+        return saturated;
+    }
+};
+
+// Lanes finish out of order; the reorder buffer must restore raster order
+TEST_F(PixelGeneratorLanesTestbench, FrameMatchesSingleLane) {
+    const uint32_t max_iter = 30;
+    auto frame = render(max_iter);
+    expectFrame(frame, defaultView(max_iter));
+}
+
+// A deeper max_iter makes interior pixels much slower than their neighbours,
+// which stresses the reorder buffer with long-running lanes.
+TEST_F(PixelGeneratorLanesTestbench, DeepFrameMatchesSingleLane) {
+    const uint32_t max_iter = 64;
+    auto frame = render(max_iter);
+    expectFrame(frame, defaultView(max_iter));
+}
+
+// Back-pressure on the stream must not drop or duplicate pixels
+TEST_F(PixelGeneratorLanesTestbench, StalledStreamKeepsOrder) {
+    using namespace mandelbrot_model;
+    const uint32_t max_iter = 20;
+    resetDUT();
+    holdGenerator();
+    axi_lite_write(0x00, max_iter);
+    releaseGenerator();
+
+    const int count = 3 * X_SIZE;
+    std::vector<PixelData> pixels;
+    long timeout = (long)count * 200;
+    while ((int)pixels.size() < count && timeout-- > 0) {
+        // Ready two cycles out of three
+        top->out_stream_tready = (ticks % 3) != 0;
+        if (top->out_stream_tvalid && top->out_stream_tready) {
+            pixels.push_back({top->out_stream_tdata, (bool)top->out_stream_tlast, (bool)top->out_stream_tuser});
+        }
+        clockCycle();
+    }
+    ASSERT_EQ((int)pixels.size(), count);
+
+    for (int i = 0; i < count; i++) {
+        EXPECT_EQ(pixels[i].data, pixel(i % X_SIZE, i / X_SIZE, 0, 0, 0, max_iter)) << "pixel " << i;
+    }
+}
+
+// The cardioid/bulb shortcut must not change a single pixel, and must report
+// its hits once the next frame has started.
+TEST_F(PixelGeneratorLanesTestbench, CardioidShortcutMatchesFullIteration) {
+    const uint32_t max_iter = 30;
+    auto frame = render(max_iter, 0x1);
+    expectFrame(frame, defaultView(max_iter));
+
+    // Let the next frame start so the statistics are snapshotted
+    for (int i = 0; i < 64; i++) {
+        clockCycle();
+    }
+    uint32_t hits = axi_lite_read(0x80);
+    uint32_t saved = axi_lite_read(0x84);
+    std::cout << "Cardioid shortcut: " << hits << " pixels, " << saved << " iterations saved" << std::endl;
+    EXPECT_GT(hits, 0u);
+    EXPECT_EQ(saved, hits * max_iter);
+}
+
+// Periodicity bailout must not change a single pixel at the default view
+TEST_F(PixelGeneratorLanesTestbench, PeriodicityMatchesFullIteration) {
+    const uint32_t max_iter = 64;
+    auto frame = render(max_iter, 0x2, 16);
+    expectFrame(frame, defaultView(max_iter));
+}
+
+// Julia mode: same lanes, z0 from the screen mapper and c from JULIA_RE/IM.
+// The cardioid shortcut is requested too and must stay out of the way.
+TEST_F(PixelGeneratorLanesTestbench, JuliaFrameMatchesModel) {
+    using namespace mandelbrot_model;
+    const uint32_t max_iter = 64;
+    const int32_t julia_re = static_cast<int32_t>(-0.8 * (1 << 28));
+    const int32_t julia_im = static_cast<int32_t>(0.156 * (1 << 28));
+    resetDUT();
+    holdGenerator();
+    axi_lite_write(0x00, max_iter);
+    axi_lite_write(0x18, julia_re);
+    axi_lite_write(0x1C, julia_im);
+    axi_lite_write(0x10, 0x21);
+    releaseGenerator();
+    auto frame = read_frame(X_SIZE, Y_SIZE);
+
+    size_t colors = expectFrame(frame, [&](int x, int y) {
+        return pixel_julia(x, y, 0, 0, 0, julia_re, julia_im, max_iter);
+    });
+    EXPECT_GT(colors, 1u);
+}
+
+// Extended stream: two beats per pixel, the iteration count and the final
+// |z|^2 behind it, with TUSER on the first beat and TLAST on the last.
+TEST_F(PixelGeneratorLanesTestbench, ExtendedStreamCarriesMagnitude) {
+    using namespace mandelbrot_model;
+    const uint32_t max_iter = 30;
+    resetDUT();
+    holdGenerator();
+    axi_lite_write(0x00, max_iter);
+    axi_lite_write(0x10, 0x10);
+    releaseGenerator();
+    auto beats = read_frame(2 * X_SIZE, Y_SIZE);
+
+    int escaped = 0;
+    expectExtendedFrame(beats, max_iter, [&](int x, int y, uint32_t *magnitude) {
+        Complex c = screen_map(x, y, 0, 0, 0);
+        uint32_t iter = iterations(c.re, c.im, max_iter, magnitude);
+        escaped += iter < max_iter;
+        return iter;
+    });
+    EXPECT_GT(escaped, 0);
+}
+
+// Q8.56 frame around c = 4: every pixel escapes at z_1 = c with |z|^2
+// between 7.5 and 28. Q4.28 only reaches 16, so the magnitude beat must
+// saturate there instead of wrapping back below the escape threshold.
+TEST_F(PixelGeneratorLanesTestbench, WideExtendedStreamSaturatesMagnitude) {
+    using namespace mandelbrot_model;
+    const uint32_t max_iter = 30;
+    const int64_t pan_x = 4LL << 56;
+    resetDUT();
+    holdGenerator();
+    axi_lite_write(0x00, max_iter);
+    axi_lite_write(0x20, static_cast<uint32_t>(pan_x));
+    axi_lite_write(0x24, static_cast<uint32_t>(static_cast<uint64_t>(pan_x) >> 32));
+    axi_lite_write(0x10, 0x14);
+    releaseGenerator();
+    auto beats = read_frame(2 * X_SIZE, Y_SIZE);
+
+    int saturated = expectExtendedFrame(beats, max_iter, [&](int x, int y, uint32_t *magnitude) {
+        WideComplex c = screen_map_wide(x, y, pan_x, 0, 0);
+        return iterations_wide(c.re, c.im, max_iter, magnitude);
+    });
+    EXPECT_GT(saturated, 0);
+}
+
+// The same view by perturbation, from the orbit 0, 4 of c = 4
+TEST_F(PixelGeneratorLanesTestbench, PerturbationExtendedStreamSaturatesMagnitude) {
+    using namespace mandelbrot_model;
+    const uint32_t max_iter = 30;
+    const std::vector<DeltaFloat> orbit = {delta_from_fixed(0, 0, 56), delta_from_fixed(4LL << 56, 0, 56)};
+    resetDUT();
+    holdGenerator();
+    loadOrbit(orbit);
+    axi_lite_write(0x00, max_iter);
+    axi_lite_write(0x10, 0x18);
+    releaseGenerator();
+    auto beats = read_frame(2 * X_SIZE, Y_SIZE);
+
+    int saturated = expectExtendedFrame(beats, max_iter, [&](int x, int y, uint32_t *magnitude) {
+        return iterations_perturb(orbit, orbit.size(), x - X_SIZE / 2, y - Y_SIZE / 2, -8, max_iter,
+                                  nullptr, magnitude);
+    });
+    EXPECT_GT(saturated, 0);
+}
+
+// Zoom 28 is past the 32-bit path's limit of 24. The frame straddles the
+// 60-iteration level set near -0.5 + 0.6047i, so neighbouring pixels differ
+// and every one must match the Q8.56 reference.
+TEST_F(PixelGeneratorLanesTestbench, WideDeepZoomMatchesModel) {
+    using namespace mandelbrot_model;
+    const uint32_t max_iter = 64;
+    const uint8_t zoom = 28;
+    const int64_t pan_x = static_cast<int64_t>(-0.5 * 0x1p56);
+    const int64_t pan_y = static_cast<int64_t>(0.6047370963483446 * 0x1p56);
+
+    auto frame = renderWide(max_iter, pan_x, pan_y, zoom);
+
+    size_t colors = expectFrame(frame, [&](int x, int y) {
+        return pixel_wide(x, y, pan_x, pan_y, zoom, max_iter);
+    });
+    EXPECT_GT(colors, 1u) << "Deep-zoom frame is flat; precision was lost";
+}
+
+// Each entry takes three ORBIT_DATA writes; the index then sits at the
+// start of the next four-word entry.
+TEST_F(PixelGeneratorLanesTestbench, OrbitIndexAdvancesPerEntry) {
+    resetDUT();
+    axi_lite_write(0x34, 0);
+    axi_lite_write(0x38, 0x11111111);
+    EXPECT_EQ(axi_lite_read(0x34), 1u);
+    axi_lite_write(0x38, 0x22222222);
+    axi_lite_write(0x38, 0x0000FFE0);
+    EXPECT_EQ(axi_lite_read(0x34), 4u);
+    axi_lite_write(0x38, 0x33333333);
+    EXPECT_EQ(axi_lite_read(0x34), 5u);
+}
+
+// 2^-72 per pixel around c = i, far past the Q8.56 path. The reference
+// orbit 0, i, -1 + i, -i, -1 + i, ... is exact in Q8.56, and the view
+// needs glitch rebasing; every pixel must match the perturbation model.
+TEST_F(PixelGeneratorLanesTestbench, PerturbationDeepZoomMatchesModel) {
+    using namespace mandelbrot_model;
+    const uint32_t max_iter = 100;
+    const uint8_t zoom = 64;
+    const int64_t one = 1LL << 56;
+
+    std::vector<DeltaFloat> orbit;
+    int64_t z_re = 0, z_im = 0;
+    for (uint32_t k = 0; k <= max_iter; k++) {
+        orbit.push_back(delta_from_fixed(z_re, z_im, 56));
+        __int128 re_sq = static_cast<__int128>(z_re) * z_re;
+        __int128 im_sq = static_cast<__int128>(z_im) * z_im;
+        __int128 re_im = static_cast<__int128>(z_re) * z_im;
+        int64_t next_re = static_cast<int64_t>((re_sq - im_sq) >> 56);
+        int64_t next_im = static_cast<int64_t>((2 * re_im) >> 56) + one;
+        z_re = next_re;
+        z_im = next_im;
+    }
+
+    resetDUT();
+    holdGenerator();
+    loadOrbit(orbit);
+    axi_lite_write(0x00, max_iter);
+    axi_lite_write(0x0C, zoom);
+    axi_lite_write(0x10, 0x8);
+    releaseGenerator();
+    auto frame = read_frame(X_SIZE, Y_SIZE);
+
+    PerturbStats stats;
+    size_t colors = expectFrame(frame, [&](int x, int y) {
+        return color(iterations_perturb(orbit, orbit.size(), x - X_SIZE / 2, y - Y_SIZE / 2,
+                                        -8 - zoom, max_iter, &stats), max_iter);
+    });
+    EXPECT_GT(colors, 1u);
+
+    // Counts are snapshotted when the next frame starts; lanes still busy
+    // with the last pixels of this frame report into the next one.
+    for (int i = 0; i < 64; i++) {
+        clockCycle();
+    }
+    uint32_t rebases = axi_lite_read(0x88);
+    uint32_t glitches = axi_lite_read(0x8C);
+    std::cout << "Perturbation: " << rebases << " rebases, " << glitches << " glitches (model "
+              << stats.rebases << ", " << stats.glitches << ")" << std::endl;
+    EXPECT_GT(glitches, 0u);
+    EXPECT_LE(glitches, rebases);
+    EXPECT_LE(rebases, stats.rebases);
+}
+
+// Escape count of c = (c_re + i c_im) * 2^-frac by plain iteration in GMP
+// fixed point, counted like mandelbrot_calculator: escaping at z_n gives
+// n + 1. With frac far below the pixel size this is the exact answer the
+// perturbation datapath approximates.
+static uint32_t iterations_exact(const mpz_t c_re, const mpz_t c_im, int frac, uint32_t max_iter) {
+    mpz_t z_re, z_im, re_sq, im_sq, re_im, mag, limit;
+    mpz_inits(z_re, z_im, re_sq, im_sq, re_im, mag, limit, nullptr);
+    mpz_set_ui(limit, 4);
+    mpz_mul_2exp(limit, limit, 2 * frac);
+
+    uint32_t n = 0;
+    while (n < max_iter) {
+        mpz_mul(re_sq, z_re, z_re);
+        mpz_mul(im_sq, z_im, z_im);
+        mpz_add(mag, re_sq, im_sq);
+        if (mpz_cmp(mag, limit) >= 0) {
+            n++;
+            break;
+        }
+        mpz_mul(re_im, z_re, z_im);
+        mpz_sub(z_re, re_sq, im_sq);
+        mpz_fdiv_q_2exp(z_re, z_re, frac);
+        mpz_add(z_re, z_re, c_re);
+        mpz_mul_2exp(re_im, re_im, 1);
+        mpz_fdiv_q_2exp(z_im, re_im, frac);
+        mpz_add(z_im, z_im, c_im);
+        n++;
+    }
+    mpz_clears(z_re, z_im, re_sq, im_sq, re_im, mag, limit, nullptr);
+    return n;
+}
+
+// The same view as above, but with the orbit from ref_orbit() and every
+// pixel checked against exact big-integer iteration of its own c rather
+// than against the perturbation model. Pixels whose orbit grazes |z| = 2
+// may escape one iteration apart; nothing else may differ.
+TEST_F(PixelGeneratorLanesTestbench, PerturbationMatchesExactIteration) {
+    using namespace mandelbrot_model;
+    const uint32_t max_iter = 100;
+    const uint8_t zoom = 64;
+    const int frac = 8 + zoom + 64;   // GUARD_BITS below the pixel, as in reference_orbit.py
+
+    mpz_t center_re, center_im, c_re, c_im;
+    mpz_inits(center_re, center_im, c_re, c_im, nullptr);
+    mpz_set_ui(center_im, 1);
+    mpz_mul_2exp(center_im, center_im, frac);
+
+    std::vector<int32_t> re(max_iter + 1), im(max_iter + 1), exps(max_iter + 1);
+    char *hex_re = mpz_get_str(nullptr, 16, center_re);
+    char *hex_im = mpz_get_str(nullptr, 16, center_im);
+    int len = ref_orbit(hex_re, hex_im, frac, max_iter + 1, re.data(), im.data(), exps.data());
+    free(hex_re);
+    free(hex_im);
+    ASSERT_EQ(len, static_cast<int>(max_iter + 1)) << "c = i is periodic and must not escape";
+
+    std::vector<DeltaFloat> orbit;
+    for (int k = 0; k < len; k++) {
+        orbit.push_back({re[k], im[k], exps[k]});
+    }
+
+    resetDUT();
+    holdGenerator();
+    loadOrbit(orbit);
+    axi_lite_write(0x00, max_iter);
+    axi_lite_write(0x0C, zoom);
+    axi_lite_write(0x10, 0x8);
+    releaseGenerator();
+    auto frame = read_frame(X_SIZE, Y_SIZE);
+    ASSERT_EQ(frame.size(), X_SIZE * Y_SIZE) << "Did not receive the complete frame.";
+
+    int mismatches = 0;
+    int off_by_more = 0;
+    for (int y = 0; y < Y_SIZE; y++) {
+        for (int x = 0; x < X_SIZE; x++) {
+            mpz_set_si(c_re, x - X_SIZE / 2);
+            mpz_mul_2exp(c_re, c_re, frac - 8 - zoom);
+            mpz_add(c_re, c_re, center_re);
+            mpz_set_si(c_im, y - Y_SIZE / 2);
+            mpz_mul_2exp(c_im, c_im, frac - 8 - zoom);
+            mpz_add(c_im, c_im, center_im);
+            uint32_t iter = iterations_exact(c_re, c_im, frac, max_iter);
+
+            uint32_t got = frame[y * X_SIZE + x].data;
+            if (got == color(iter, max_iter)) {
+                continue;
+            }
+            mismatches++;
+            bool adjacent = got == color(iter + 1, max_iter) || (iter > 0 && got == color(iter - 1, max_iter));
+            if (!adjacent && off_by_more++ < 10) {
+                ADD_FAILURE() << "Pixel (" << x << ", " << y << ") = 0x" << std::hex << got
+                              << ", exact iteration = 0x" << color(iter, max_iter) << std::dec
+                              << " (" << iter << " iterations)";
+            }
+        }
+    }
+    mpz_clears(center_re, center_im, c_re, c_im, nullptr);
+
+    std::cout << "Perturbation vs exact: " << mismatches << " of " << X_SIZE * Y_SIZE
+              << " pixels one iteration apart" << std::endl;
+    EXPECT_EQ(off_by_more, 0);
+    EXPECT_LE(mismatches, X_SIZE * Y_SIZE / 10000);
+}
+
+// Shadow writes do nothing until COMMIT, and a commit made part way through
+// a frame only takes effect from the next one.
+TEST_F(PixelGeneratorLanesTestbench, CommitAppliesAtNextFrame) {
+    using namespace mandelbrot_model;
+    const uint32_t max_iter_a = 20;
+    const uint32_t max_iter_b = 40;
+    resetDUT();
+    holdGenerator();
+    axi_lite_write(0x00, max_iter_a);
+    releaseGenerator();
+    EXPECT_EQ(axi_lite_read(0x90), 1u);
+
+    auto frame = read_frame(X_SIZE, 8);
+    top->out_stream_tready = 0;
+    axi_lite_write(0x00, max_iter_b);
+    auto more = read_frame(X_SIZE, 8);
+    frame.insert(frame.end(), more.begin(), more.end());
+
+    // The stream is stalled mid-frame, so the commit has to wait
+    top->out_stream_tready = 0;
+    axi_lite_write(0x3C, 1);
+    EXPECT_EQ(axi_lite_read(0x3C), 1u);
+    more = read_frame(X_SIZE, Y_SIZE - 16);
+    frame.insert(frame.end(), more.begin(), more.end());
+    expectFrame(frame, defaultView(max_iter_a));
+
+    auto next = read_frame(X_SIZE, Y_SIZE);
+    expectFrame(next, defaultView(max_iter_b));
+    EXPECT_EQ(axi_lite_read(0x3C), 0u);
+    EXPECT_EQ(axi_lite_read(0x90), 2u);
+    EXPECT_GE(axi_lite_read(0x94), 2u);
+    EXPECT_GT(axi_lite_read(0xB0), 0u);
+}
+
+// The performance counters describe the last complete frame once the next
+// one has started leaving the reorder buffer
+TEST_F(PixelGeneratorLanesTestbench, PerformanceCountersDescribeLastFrame) {
+    using namespace mandelbrot_model;
+    const uint32_t max_iter = 30;
+    auto frame = render(max_iter);
+    ASSERT_EQ(frame.size(), X_SIZE * Y_SIZE) << "Did not receive the complete frame.";
+    for (int i = 0; i < 64; i++) {
+        clockCycle();
+    }
+
+    uint64_t total = 0;
+    uint32_t highest = 0;
+    for (int y = 0; y < Y_SIZE; y++) {
+        for (int x = 0; x < X_SIZE; x++) {
+            Complex c = screen_map(x, y, 0, 0, 0);
+            uint32_t iter = iterations(c.re, c.im, max_iter);
+            total += iter;
+            highest = std::max(highest, iter);
+        }
+    }
+
+    uint32_t cycles = axi_lite_read(0x98);
+    uint64_t iters = axi_lite_read(0x9C) | (static_cast<uint64_t>(axi_lite_read(0xA0)) << 32);
+    uint32_t stalls = axi_lite_read(0xA4);
+    uint32_t idle = axi_lite_read(0xA8);
+    std::cout << "Frame: " << cycles << " cycles, " << iters << " iterations, " << stalls
+              << " stalled, " << idle << " idle" << std::endl;
+    EXPECT_GE(cycles, static_cast<uint32_t>(X_SIZE * Y_SIZE));
+    EXPECT_EQ(iters, total);
+    EXPECT_EQ(stalls, 0u);
+    EXPECT_LT(idle, cycles);
+    EXPECT_EQ(axi_lite_read(0xAC), highest);
+}
+
+// The tile engine fills uniform squares instead of iterating them. It must
+// match the Mariani-Silver model pixel for pixel, framing included, and
+// skip a large share of the frame at the default view.
+TEST_F(PixelGeneratorLanesTestbench, TileEngineMatchesModel) {
+    using namespace mandelbrot_model;
+    const uint32_t max_iter = 30;
+    auto frame = render(max_iter, 0x40);
+
+    uint32_t filled;
+    auto iter = iterations_tiled(max_iter, 16, &filled);
+    expectFrame(frame, [&](int x, int y) { return color(iter[y * X_SIZE + x], max_iter); });
+
+    // The next frame has started by now, so the fill count is snapshotted
+    uint32_t hw_filled = axi_lite_read(0xB4);
+    std::cout << "Tile engine: " << hw_filled << " pixels filled, " << axi_lite_read(0xB8)
+              << " iterations saved" << std::endl;
+    EXPECT_EQ(hw_filled, filled);
+    EXPECT_GT(hw_filled, static_cast<uint32_t>(X_SIZE * Y_SIZE / 4));
+}
+
+// With several tiles in flight the lanes stay busy while borders are read
+// back and filled, so the tile engine must beat the raster scheduler at the
+// default view, where large parts of the frame are uniform
+TEST_F(PixelGeneratorLanesTestbench, TileEngineFasterThanRaster) {
+    using namespace mandelbrot_model;
+    const uint32_t max_iter = 30;
+    auto frameCycles = [&](uint32_t ctrl) {
+        auto frame = render(max_iter, ctrl);
+        EXPECT_EQ(frame.size(), X_SIZE * Y_SIZE) << "Did not receive the complete frame.";
+        // FRAME_CYCLES is snapshotted when the next frame's first pixel
+        // leaves, which in tile mode is a whole band later
+        long timeout_cycles = (long)X_SIZE * Y_SIZE * 50;
+        while (!(top->out_stream_tvalid && top->out_stream_tuser) && timeout_cycles-- > 0) {
+            clockCycle();
+        }
+        EXPECT_GT(timeout_cycles, 0) << "The next frame did not start.";
+        for (int i = 0; i < 64; i++) {
+            clockCycle();
+        }
+        return axi_lite_read(0x98);
+    };
+
+    uint32_t raster = frameCycles(0);
+    uint32_t tile = frameCycles(0x40);
+    std::cout << "Frame cycles: raster " << raster << ", tile " << tile << std::endl;
+    EXPECT_GT(raster, 0u);
+    EXPECT_LT(tile, raster);
+}
+
+// Progressive mode streams the 1/8, 1/4 and 1/2 passes as whole frames of
+// replicated samples before the full-resolution one, and counts them in
+// PASS_DONE
+TEST_F(PixelGeneratorLanesTestbench, ProgressivePassesRefineToFullFrame) {
+    using namespace mandelbrot_model;
+    const uint32_t max_iter = 30;
+    auto frame = render(max_iter, 0x80);
+
+    for (int pass = 1; pass <= 5; pass++) {
+        int step = std::max(8 >> (pass - 1), 1);
+        SCOPED_TRACE("Pass " + std::to_string(pass));
+        expectFrame(frame, [&](int x, int y) { return pixel_progressive(x, y, step, max_iter); });
+
+        // The next pass cannot finish while the stream is stalled
+        top->out_stream_tready = 0;
+        EXPECT_EQ(axi_lite_read(0xBC), static_cast<uint32_t>(std::min(pass, 4)));
+        if (pass < 5) {
+            frame = read_frame(X_SIZE, Y_SIZE);
+        }
+    }
+
+    // A commit starts again from the coarsest pass once the frame in flight
+    // has gone out
+    axi_lite_write(0x3C, 1);
+    auto stream = read_frame(X_SIZE, Y_SIZE);
+    auto more = read_frame(X_SIZE, Y_SIZE);
+    stream.insert(stream.end(), more.begin(), more.end());
+    top->out_stream_tready = 0;
+
+    size_t start = 1;
+    while (start < stream.size() && !stream[start].user) {
+        start++;
+    }
+    ASSERT_LE(start + X_SIZE * Y_SIZE, stream.size()) << "No frame after the commit.";
+    expectFrame(stream.data() + start, [&](int x, int y) { return pixel_progressive(x, y, 8, max_iter); });
+
+    // PASS_DONE counted back down from 4 at the commit and up again for the
+    // 1/8 pass; the 1/4 pass cannot have finished within the capture
+    EXPECT_EQ(axi_lite_read(0xBC), 1u);
+}
+
+// With PAN_REUSE_EN the frames go through a DDR iteration buffer. A repeat
+// of the same view is read back whole, and a pan only computes the pixels
+// it uncovers.
+TEST_F(PixelGeneratorLanesTestbench, PanReuseComputesOnlyUncoveredPixels) {
+    using namespace mandelbrot_model;
+    const uint32_t max_iter = 30;
+    const uint32_t ibuf = 0x10000000;
+    const int dx = 5, dy = -3;
+    // One pixel at zoom 0 is 2^-8, or 1 << 20 in Q4.28
+    const int32_t pan_x = dx << 20, pan_y = dy * (1 << 20);
+
+    auto expectView = [&](const PixelData *frame, int32_t px, int32_t py) {
+        expectFrame(frame, [&](int x, int y) { return pixel(x, y, px, py, 0, max_iter); });
+    };
+
+    resetDUT();
+    holdGenerator();
+    axi_lite_write(0x00, max_iter);
+    axi_lite_write(0x44, ibuf);
+    axi_lite_write(0x10, 0x100);
+    releaseGenerator();
+
+    // The first frame has nothing to reuse, the second reuses all of it
+    auto frame = read_frame(X_SIZE, Y_SIZE);
+    ASSERT_EQ(frame.size(), X_SIZE * Y_SIZE);
+    expectView(frame.data(), 0, 0);
+    frame = read_frame(X_SIZE, Y_SIZE);
+    ASSERT_EQ(frame.size(), X_SIZE * Y_SIZE);
+    expectView(frame.data(), 0, 0);
+    EXPECT_EQ(ddr.count(ibuf + 4 * (X_SIZE * Y_SIZE - 1)), 1u);
+
+    // Let the third frame start, then pan under it
+    top->out_stream_tready = 0;
+    for (int i = 0; i < 2000; i++) {
+        clockCycle();
+    }
+    axi_lite_write(0x04, static_cast<uint32_t>(pan_x));
+    axi_lite_write(0x08, static_cast<uint32_t>(pan_y));
+    axi_lite_write(0x40, (static_cast<uint32_t>(dy) << 16) | (static_cast<uint32_t>(dx) & 0xFFFF));
+    axi_lite_write(0x3C, 1);
+
+    auto stream = read_frame(X_SIZE, Y_SIZE);
+    auto more = read_frame(X_SIZE, Y_SIZE);
+    stream.insert(stream.end(), more.begin(), more.end());
+    more = read_frame(X_SIZE, 8);
+    top->out_stream_tready = 0;
+
+    expectView(stream.data(), 0, 0);
+    expectView(stream.data() + X_SIZE * Y_SIZE, pan_x, pan_y);
+
+    uint32_t copied = axi_lite_read(0xC0);
+    std::cout << "Pan reuse: " << copied << " pixels copied" << std::endl;
+    EXPECT_EQ(copied, static_cast<uint32_t>((X_SIZE - dx) * (Y_SIZE + dy)));
+
+    // A commit without a fresh PAN_SHIFT write must not shift again: pan
+    // back and expect the original view, not a copy moved by (dx, dy)
+    axi_lite_write(0x04, 0);
+    axi_lite_write(0x08, 0);
+    axi_lite_write(0x3C, 1);
+    stream = read_frame(X_SIZE, Y_SIZE);
+    more = read_frame(X_SIZE, Y_SIZE);
+    stream.insert(stream.end(), more.begin(), more.end());
+    top->out_stream_tready = 0;
+
+    // The capture starts inside the frame that was in flight
+    size_t start = 0;
+    while (start < stream.size() && !stream[start].user) {
+        start++;
+    }
+    ASSERT_LE(start + X_SIZE * Y_SIZE, stream.size()) << "No frame after the commit.";
+    expectView(stream.data() + start, 0, 0);
+}
+
+// With MIRROR_EN and the view on the real axis only the rows down to the
+// centre are computed; the rest are read back from the iteration buffer.
+// A view off the axis is computed in full. The copy is not bit-exact, since
+// fixed-point rounding is not symmetric about the axis, so mirrored frames
+// are also checked against a full render and the differences bounded.
+TEST_F(PixelGeneratorLanesTestbench, MirrorComputesUpperHalfOnly) {
+    using namespace mandelbrot_model;
+    const uint32_t max_iter = 30;
+    const uint32_t ibuf = 0x10000000;
+    const int32_t pan_x = -(1 << 26), pan_y = 1 << 20;
+
+    auto expectView = [&](const PixelData *frame, bool mirrored) {
+        if (!mirrored) {
+            expectFrame(frame, [&](int x, int y) { return pixel(x, y, pan_x, pan_y, 0, max_iter); });
+            return;
+        }
+        expectFrame(frame, [&](int x, int y) { return pixel_mirrored(x, y, pan_x, 0, max_iter); });
+        int unmirrored = 0;
+        for (int i = 0; i < X_SIZE * Y_SIZE; i++) {
+            unmirrored += frame[i].data != pixel(i % X_SIZE, i / X_SIZE, pan_x, 0, 0, max_iter);
+        }
+        std::cout << "Mirror: " << unmirrored << " pixels differ from the full render" << std::endl;
+        EXPECT_LE(unmirrored, X_SIZE * Y_SIZE / 10000);
+    };
+
+    resetDUT();
+    holdGenerator();
+    axi_lite_write(0x00, max_iter);
+    axi_lite_write(0x04, static_cast<uint32_t>(pan_x));
+    axi_lite_write(0x44, ibuf);
+    axi_lite_write(0x10, 0x200);
+    releaseGenerator();
+
+    auto frame = read_frame(X_SIZE, Y_SIZE);
+    ASSERT_EQ(frame.size(), X_SIZE * Y_SIZE);
+    expectView(frame.data(), true);
+    frame = read_frame(X_SIZE, Y_SIZE);
+    ASSERT_EQ(frame.size(), X_SIZE * Y_SIZE);
+    expectView(frame.data(), true);
+
+    // Let the third frame start, which snapshots the count of the second,
+    // then move off the axis under it
+    top->out_stream_tready = 0;
+    for (int i = 0; i < 2000; i++) {
+        clockCycle();
+    }
+    uint32_t copied = axi_lite_read(0xC0);
+    std::cout << "Mirror: " << copied << " pixels copied" << std::endl;
+    EXPECT_EQ(copied, static_cast<uint32_t>(X_SIZE * (Y_SIZE / 2 - 1)));
+
+    axi_lite_write(0x08, static_cast<uint32_t>(pan_y));
+    axi_lite_write(0x3C, 1);
+
+    auto stream = read_frame(X_SIZE, Y_SIZE);
+    auto more = read_frame(X_SIZE, Y_SIZE);
+    stream.insert(stream.end(), more.begin(), more.end());
+    more = read_frame(X_SIZE, 8);
+    top->out_stream_tready = 0;
+
+    expectView(stream.data(), true);
+    expectView(stream.data() + X_SIZE * Y_SIZE, false);
+    EXPECT_EQ(axi_lite_read(0xC0), 0u);
+}
+
+// RAW_STREAM sends the iteration counts of two pixels per beat, saturated
+// to 16 bits, so a line is half as many beats
+TEST_F(PixelGeneratorLanesTestbench, RawStreamPacksTwoCountsPerBeat) {
+    using namespace mandelbrot_model;
+    const uint32_t max_iter = 100;
+
+    resetDUT();
+    holdGenerator();
+    axi_lite_write(0x00, max_iter);
+    axi_lite_write(0x10, 0x400);
+    releaseGenerator();
+
+    auto beats = read_frame(X_SIZE / 2, Y_SIZE);
+
+    expectFrame(beats, [&](int i, int y) {
+        uint32_t expected = 0;
+        for (int half = 0; half < 2; half++) {
+            Complex c = screen_map(2 * i + half, y, 0, 0, 0);
+            expected |= std::min<uint32_t>(iterations(c.re, c.im, max_iter), 0xFFFF) << (16 * half);
+        }
+        return expected;
+    }, X_SIZE / 2);
+}
+
+// A step of 2^(48 - zoom) from the top-left corner of the ZOOM view lands
+// on exactly the coordinates screen_mapper shifts out
+TEST_F(PixelGeneratorLanesTestbench, ScaleMatchesPowerOfTwoZoom) {
+    using namespace mandelbrot_model;
+    const uint32_t max_iter = 40;
+    const uint8_t zoom = 3;
+    const int32_t pan_x = static_cast<int32_t>(-0.75 * 0x1p28);
+    const int32_t pan_y = static_cast<int32_t>(0.125 * 0x1p28);
+    const int64_t step = 1LL << (48 - zoom);
+    const int64_t origin_re = (static_cast<int64_t>(pan_x) << 28) - X_SIZE / 2 * step;
+    const int64_t origin_im = (static_cast<int64_t>(pan_y) << 28) - Y_SIZE / 2 * step;
+
+    auto frame = renderScaled(max_iter, scaled_view(origin_re, origin_im, step));
+    expectFrame(frame, [&](int x, int y) { return pixel(x, y, pan_x, pan_y, zoom, max_iter); });
+}
+
+// A step between two powers of two
+TEST_F(PixelGeneratorLanesTestbench, ScaleStepsArbitraryPixelSize) {
+    using namespace mandelbrot_model;
+    const uint32_t max_iter = 40;
+    const int64_t step = 3LL << 45;   // 1.5 * 2^-10
+    const int64_t origin_re = static_cast<int64_t>(-0.75 * 0x1p56) - X_SIZE / 2 * step;
+    const int64_t origin_im = -(Y_SIZE / 2) * step;
+    const AffineView view = scaled_view(origin_re, origin_im, step);
+
+    auto frame = renderScaled(max_iter, view);
+    expectFrame(frame, [&](int x, int y) { return pixel_stepped(x, y, view, max_iter); });
+}
+
+// coord_generator maps whichever pixel is issued, so a scaled view runs on
+// the tile, progressive and mirror schedulers like a ZOOM one
+TEST_F(PixelGeneratorLanesTestbench, ScaleRunsOnEveryScheduler) {
+    using namespace mandelbrot_model;
+    const uint32_t max_iter = 40;
+    const int64_t step = 3LL << 45;
+    const int64_t origin_re = static_cast<int64_t>(-0.6 * 0x1p56) - X_SIZE / 2 * step;
+    const AffineView view = scaled_view(origin_re, -(Y_SIZE / 2) * step, step);
+    auto count = [&](int x, int y) { return iterations_stepped(x, y, view, max_iter); };
+
+    {
+        SCOPED_TRACE("Tile");
+        auto frame = renderScaled(max_iter, view, 0x40);
+        auto iter = iterations_tiled(count, 16);
+        expectFrame(frame, [&](int x, int y) { return color(iter[y * X_SIZE + x], max_iter); });
+    }
+    {
+        SCOPED_TRACE("Progressive 1/8 pass");
+        auto frame = renderScaled(max_iter, view, 0x80);
+        expectFrame(frame, [&](int x, int y) { return pixel_stepped(x & ~7, y & ~7, view, max_iter); });
+    }
+    {
+        // Row Y_SIZE / 2 of the view is on the real axis, so the rows
+        // below it are copied. The iteration buffer stays at IBUF_ADDR = 0.
+        SCOPED_TRACE("Mirror");
+        auto frame = renderScaled(max_iter, view, 0x200);
+        expectFrame(frame, [&](int x, int y) {
+            return pixel_stepped(x, (y > Y_SIZE / 2) ? Y_SIZE - y : y, view, max_iter);
+        });
+        read_frame(X_SIZE, Y_SIZE);
+        top->out_stream_tready = 0;
+        for (int i = 0; i < 2000; i++) {
+            clockCycle();
+        }
+        EXPECT_EQ(axi_lite_read(0xC0), static_cast<uint32_t>(X_SIZE * (Y_SIZE / 2 - 1)));
+    }
+}
+
+// A view rotated by 30 degrees: every pixel matches the exact Q8.56 sum,
+// and that sum stays within a few LSBs of the rotation done in double
+TEST_F(PixelGeneratorLanesTestbench, RotatedViewMatchesModel) {
+    using namespace mandelbrot_model;
+    const uint32_t max_iter = 40;
+    const double angle = M_PI / 6, scale = 0x1p-9, center_re = -0.6, center_im = 0.1;
+    const double dx_re = scale * std::cos(angle), dx_im = scale * std::sin(angle);
+    const double dy_re = -dx_im, dy_im = dx_re;
+    const double origin_re = center_re - X_SIZE / 2 * dx_re - Y_SIZE / 2 * dy_re;
+    const double origin_im = center_im - X_SIZE / 2 * dx_im - Y_SIZE / 2 * dy_im;
+    auto q8_56 = [](double v) { return static_cast<int64_t>(std::llround(v * 0x1p56)); };
+    const AffineView view = {q8_56(origin_re), q8_56(origin_im), q8_56(dx_re), q8_56(dx_im),
+                             q8_56(dy_re), q8_56(dy_im)};
+
+    auto frame = renderScaled(max_iter, view);
+
+    size_t colors = expectFrame(frame, [&](int x, int y) {
+        WideComplex c = coord_step(x, y, view);
+        EXPECT_NEAR(c.re * 0x1p-56, origin_re + x * dx_re + y * dy_re, 0x1p-44);
+        EXPECT_NEAR(c.im * 0x1p-56, origin_im + x * dx_im + y * dy_im, 0x1p-44);
+        return pixel_stepped(x, y, view, max_iter);
+    });
+    EXPECT_GT(colors, 1u);
+}
+
+// Palette entries go to the bank off screen, and PALETTE_SWAP puts them on
+// screen from the next frame without a COMMIT or a recomputed pixel
+TEST_F(PixelGeneratorLanesTestbench, PaletteSwapAppliesAtNextFrame) {
+    using namespace mandelbrot_model;
+    const uint32_t max_iter = 40;
+    auto palette_a = [](uint32_t i) { return (i * 0x030507u) & 0xFFFFFF; };
+    auto palette_b = [](uint32_t i) { return 0xFFFFFF - i * 0x010203u; };
+    auto expectPalette = [&](const std::vector<PixelData> &frame, int first_line,
+                             uint32_t (*entry)(uint32_t), uint32_t offset) {
+        int mismatches = 0;
+        for (size_t i = 0; i < frame.size(); i++) {
+            int x = i % X_SIZE, y = first_line + i / X_SIZE;
+            Complex c = screen_map(x, y, 0, 0, 0);
+            uint32_t iter = iterations(c.re, c.im, max_iter);
+            uint32_t expected = (iter >= max_iter) ? 0 : entry((iter + offset) % 1024);
+            if (frame[i].data != expected && mismatches++ < 10) {
+                ADD_FAILURE() << "Pixel (" << x << ", " << y << ") = 0x" << std::hex << frame[i].data
+                              << ", palette entry = 0x" << expected << std::dec;
+            }
+        }
+        EXPECT_EQ(mismatches, 0);
+    };
+
+    // Under reset the swap applies at once
+    resetDUT();
+    holdGenerator();
+    axi_lite_write(0x00, max_iter);
+    for (uint32_t i = 0; i < 64; i++) {
+        axi_lite_write(0x1000 + 4 * i, palette_a(i));
+    }
+    axi_lite_write(0x800, 0x80000100);
+    axi_lite_write(0x804, 1);
+    releaseGenerator();
+    EXPECT_EQ(axi_lite_read(0x800), 0x80000100u);
+
+    auto frame = read_frame(X_SIZE, 8);
+    expectPalette(frame, 0, palette_a, 0);
+
+    // Load the other bank and swap part way through a stalled frame
+    top->out_stream_tready = 0;
+    for (uint32_t i = 0; i < 64; i++) {
+        axi_lite_write(0x1000 + 4 * i, palette_b(i));
+    }
+    axi_lite_write(0x800, 0x80050100);
+    axi_lite_write(0x804, 1);
+    EXPECT_EQ(axi_lite_read(0x804), 1u);
+
+    auto rest = read_frame(X_SIZE, Y_SIZE - 8);
+    expectPalette(rest, 8, palette_a, 0);
+
+    auto next = read_frame(X_SIZE, Y_SIZE);
+    expectPalette(next, 0, palette_b, 5);
+    EXPECT_EQ(next[0].user, true);
+    EXPECT_EQ(axi_lite_read(0x804), 0u);
+    EXPECT_EQ(axi_lite_read(0x90), 1u) << "The swap should not need a COMMIT";
+
+    // A swap without bit 0 keeps the bank and only moves the offset
+    axi_lite_write(0x800, 0x80070100);
+    axi_lite_write(0x804, 0);
+    read_frame(X_SIZE, Y_SIZE);
+    expectPalette(read_frame(X_SIZE, Y_SIZE), 0, palette_b, 7);
+}
+
+// The histogram of the last complete frame counts every escaped pixel in
+// bin iterations >> HIST_SHIFT, and pixels at max_iter in HIST_INTERIOR
+TEST_F(PixelGeneratorLanesTestbench, HistogramMatchesModel) {
+    using namespace mandelbrot_model;
+    const uint32_t max_iter = 40;
+    auto expectHistogram = [&](uint32_t frame_number, int shift) {
+        std::vector<uint32_t> expected(1024, 0);
+        uint32_t interior = 0, max_escaped = 0;
+        for (int y = 0; y < Y_SIZE; y++) {
+            for (int x = 0; x < X_SIZE; x++) {
+                Complex c = screen_map(x, y, 0, 0, 0);
+                uint32_t iter = iterations(c.re, c.im, max_iter);
+                if (iter >= max_iter) {
+                    interior++;
+                } else {
+                    expected[std::min<uint32_t>(iter >> shift, 1023)]++;
+                    max_escaped = std::max(max_escaped, iter);
+                }
+            }
+        }
+        EXPECT_EQ(axi_lite_read(0xC4), frame_number);
+        EXPECT_EQ(axi_lite_read(0xC8), interior);
+        EXPECT_EQ(axi_lite_read(0xCC), max_escaped);
+        EXPECT_EQ(axi_lite_read(0xAC), max_iter) << "MAX_PIXEL_ITERS counts interior pixels";
+        for (uint32_t bin = 0; bin < 1024; bin++) {
+            EXPECT_EQ(axi_lite_read(0x2000 + 4 * bin), expected[bin]) << "Bin " << bin;
+        }
+        EXPECT_EQ(axi_lite_read(0xC4), frame_number) << "The histogram changed while it was read";
+    };
+
+    resetDUT();
+    holdGenerator();
+    axi_lite_write(0x00, max_iter);
+    releaseGenerator();
+    EXPECT_EQ(axi_lite_read(0x808), 0u);
+
+    // Nothing is complete until the second frame starts
+    read_frame(X_SIZE, Y_SIZE);
+    read_frame(X_SIZE, 2);
+    top->out_stream_tready = 0;
+    allDomainsCycle(10);
+    expectHistogram(1, 0);
+
+    // A new shift applies from the next frame; the stalled stream holds
+    // the bank being read
+    axi_lite_write(0x808, 2);
+    EXPECT_EQ(axi_lite_read(0x808), 2u);
+    read_frame(X_SIZE, Y_SIZE - 2);
+    read_frame(X_SIZE, Y_SIZE);
+    read_frame(X_SIZE, 2);
+    top->out_stream_tready = 0;
+    allDomainsCycle(10);
+    expectHistogram(3, 2);
+}
@@ -0,0 +1,98 @@
+#include "pixel_generator_testbench.h"
+#include "mandelbrot_model.h"
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <verilated_cov.h>
+
+// Global tick counter
+unsigned int ticks = 0;
+
+// AXI-Lite, compute and stream clocks at independent ratios. The output
+// FIFO is the only path from compute_aclk to out_stream_aclk, so every
+// frame must still arrive whole and in order whichever side is faster.
+class PixelGeneratorMultiClockTestbench : public PixelGeneratorTestbench {
+protected:
+    // Capture pixels while the consumer is ready two stream clocks out of three
+    std::vector<PixelData> readFrameStalled(int count) {
+        std::vector<PixelData> pixels;
+        long timeout = (long)count * 200;
+        while ((int)pixels.size() < count && timeout-- > 0) {
+            top->out_stream_tready = (ticks % 3) != 0;
+            if (top->out_stream_tvalid && top->out_stream_tready) {
+                pixels.push_back({top->out_stream_tdata, (bool)top->out_stream_tlast, (bool)top->out_stream_tuser});
+            }
+            clockCycle();
+        }
+        EXPECT_EQ((int)pixels.size(), count) << "Timeout! DUT stopped sending pixels.";
+        return pixels;
+    }
+};
+
+// 100 MHz AXI-Lite, 250 MHz compute, 148.5 MHz stream. A COMMIT crosses
+// from the AXI clock to the compute clock and shows up in the next frame.
+TEST_F(PixelGeneratorMultiClockTestbench, FastComputeFramesMatchModel) {
+    using namespace mandelbrot_model;
+    const uint32_t max_iter_a = 20;
+    const uint32_t max_iter_b = 30;
+    setClockPeriods(10000, 4000, 6734);
+    resetDUT();
+    holdGenerator();
+    axi_lite_write(0x00, max_iter_a);
+    releaseGenerator();
+    EXPECT_EQ(axi_lite_read(0x00), max_iter_a);
+
+    auto frame = read_frame(X_SIZE, 8);
+    top->out_stream_tready = 0;
+    axi_lite_write(0x00, max_iter_b);
+    axi_lite_write(0x3C, 1);
+    auto more = read_frame(X_SIZE, Y_SIZE - 8);
+    frame.insert(frame.end(), more.begin(), more.end());
+    expectFrame(frame, defaultView(max_iter_a));
+
+    auto next = read_frame(X_SIZE, Y_SIZE);
+    expectFrame(next, defaultView(max_iter_b));
+    EXPECT_EQ(axi_lite_read(0x3C), 0u);
+    EXPECT_EQ(axi_lite_read(0x90), 2u);
+}
+
+// A compute clock slower than the stream leaves the FIFO running dry. The
+// frame takes longer but arrives whole, and STREAM_STALLS only counts the
+// VDMA holding TREADY low, which it never did.
+TEST_F(PixelGeneratorMultiClockTestbench, SlowComputeNeverStalls) {
+    using namespace mandelbrot_model;
+    const uint32_t max_iter = 20;
+    setClockPeriods(7000, 10000, 3000);
+    resetDUT();
+    holdGenerator();
+    axi_lite_write(0x00, max_iter);
+    releaseGenerator();
+
+    auto frame = read_frame(X_SIZE, Y_SIZE);
+    expectFrame(frame, defaultView(max_iter));
+
+    // Let the next frame start so the counters are snapshotted
+    read_frame(X_SIZE, 2);
+    EXPECT_GE(axi_lite_read(0x98), static_cast<uint32_t>(X_SIZE * Y_SIZE));
+    EXPECT_EQ(axi_lite_read(0xA4), 0u);
+}
+
+// A slow, stalling stream fills the FIFO and the calculators wait behind
+// it without dropping or repeating a pixel
+TEST_F(PixelGeneratorMultiClockTestbench, StalledStreamBacksUpCompute) {
+    using namespace mandelbrot_model;
+    const uint32_t max_iter = 20;
+    setClockPeriods(10000, 2500, 13468);
+    resetDUT();
+    holdGenerator();
+    axi_lite_write(0x00, max_iter);
+    axi_lite_write(0x10, 0x1);
+    releaseGenerator();
+
+    auto frame = readFrameStalled(X_SIZE * Y_SIZE);
+    expectFrame(frame, defaultView(max_iter));
+
+    readFrameStalled(2 * X_SIZE);
+    uint32_t stalls = axi_lite_read(0xA4);
+    std::cout << "Stream clocks stalled on TREADY: " << stalls << std::endl;
+    EXPECT_GT(stalls, 0u);
+}
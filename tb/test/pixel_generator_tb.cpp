@@ -1,159 +1,12 @@
-#include "base_testbench.h" // Assuming .hh extension from common practice
+#include "pixel_generator_testbench.h"
+#include "mandelbrot_model.h"
 #include <cstdint>
-#include <vector>
 #include <gtest/gtest.h>
 #include <verilated_cov.h>
 
 // Global tick counter
 unsigned int ticks = 0;
 
-// Helper struct to hold captured AXI-Stream pixel data
-struct PixelData {
-    uint32_t data; // tdata (contains RGB)
-    bool last;     // tlast (end of line)
-    bool user;     // tuser (start of frame)
-};
-
-class PixelGeneratorTestbench : public BaseTestbench {
-protected:
-    // Toggles both clocks for simplicity. In a real complex system,
-    // these might be asynchronous, but for this testbench, a shared
-    // clock is sufficient and standard practice.
-    void clockCycle() {
-        top->s_axi_lite_aclk = 0;
-        top->out_stream_aclk = 0;
-        top->eval();
-        #ifndef __APPLE__
-        tfp->dump(2 * ticks);
-        #endif
-
-        top->s_axi_lite_aclk = 1;
-        top->out_stream_aclk = 1;
-        top->eval();
-        #ifndef __APPLE__
-        tfp->dump(2 * ticks + 1);
-        #endif
-        ticks++;
-    }
-
-    // Set all inputs to a known, idle state
-    void initializeInputs() override {
-        // Active-low resets are asserted (0) initially
-        top->axi_resetn = 0;
-        top->periph_resetn = 0;
-
-        // AXI-Stream consumer is not ready initially
-        top->out_stream_tready = 0;
-
-        // AXI-Lite master interfaces are idle
-        top->s_axi_lite_arvalid = 0;
-        top->s_axi_lite_awvalid = 0;
-        top->s_axi_lite_wvalid = 0;
-        top->s_axi_lite_bready = 0;
-        top->s_axi_lite_rready = 0;
-    }
-
-    // Apply and release resets to bring DUT to an operational state
-    void resetDUT() {
-        initializeInputs();
-        top->axi_resetn = 0;
-        top->periph_resetn = 0;
-        clockCycle();
-        clockCycle();
-        top->axi_resetn = 1;
-        top->periph_resetn = 1;
-        clockCycle();
-        // The DUT is now out of reset and should start its internal FSM
-    }
-
-    // Helper function to perform a complete AXI-Lite write transaction
-    void axi_lite_write(uint32_t addr, uint32_t data) {
-        top->s_axi_lite_awaddr = addr;
-        top->s_axi_lite_awvalid = 1;
-        top->s_axi_lite_wdata = data;
-        top->s_axi_lite_wvalid = 1;
-
-        // Wait until the DUT is ready for both address and data
-        while (!(top->s_axi_lite_awready && top->s_axi_lite_wready)) {
-            clockCycle();
-        }
-
-        clockCycle();
-        top->s_axi_lite_awvalid = 0;
-        top->s_axi_lite_wvalid = 0;
-
-        // Wait for the write response
-        top->s_axi_lite_bready = 1;
-        while (!top->s_axi_lite_bvalid) {
-            clockCycle();
-        }
-        
-        // Expect a successful response (AXI_OK)
-        EXPECT_EQ(top->s_axi_lite_bresp, 0);
-        clockCycle();
-        top->s_axi_lite_bready = 0;
-    }
-
-    // Helper function to perform a complete AXI-Lite read transaction
-    uint32_t axi_lite_read(uint32_t addr) {
-        top->s_axi_lite_araddr = addr;
-        top->s_axi_lite_arvalid = 1;
-
-        while (!top->s_axi_lite_arready) {
-            clockCycle();
-        }
-
-        clockCycle();
-        top->s_axi_lite_arvalid = 0;
-
-        // Wait for the DUT to provide valid read data
-        top->s_axi_lite_rready = 1;
-        while (!top->s_axi_lite_rvalid) {
-            clockCycle();
-        }
-
-        uint32_t read_data = top->s_axi_lite_rdata;
-        EXPECT_EQ(top->s_axi_lite_rresp, 0); // Expect AXI_OK
-        clockCycle();
-        top->s_axi_lite_rready = 0;
-        
-        return read_data;
-    }
-
-    // Helper function to capture a stream of pixels.
-    // Includes a timeout to detect if the DUT stops producing pixels.
-    std::vector<PixelData> read_frame(int width, int height) {
-        std::vector<PixelData> pixels;
-        pixels.reserve(width * height);
-        
-        // Generous timeout: 50 cycles per pixel should be more than enough
-        // given that max_iter is usually ~100.
-        long timeout_cycles = (long)width * height * 50;
-
-        // Signal that the consumer is always ready to accept data
-        top->out_stream_tready = 1;
-
-        while (pixels.size() < width * height && timeout_cycles > 0) {
-            // AXI Stream handshake: transaction occurs when tvalid and tready are both high
-            if (top->out_stream_tvalid && top->out_stream_tready) {
-                PixelData p;
-                p.data = top->out_stream_tdata;
-                p.user = top->out_stream_tuser;
-                p.last = top->out_stream_tlast;
-                pixels.push_back(p);
-            }
-            clockCycle();
-            timeout_cycles--;
-        }
-
-        // If the timeout was hit, it's a critical failure.
-        EXPECT_GT(timeout_cycles, 0) << "Timeout! DUT stopped sending pixels. Received "
-                                     << pixels.size() << " of " << width * height << " pixels.";
-        
-        return pixels;
-    }
-};
-
 // Test 1: Verify AXI-Lite register read/write functionality
 TEST_F(PixelGeneratorTestbench, RegisterReadWrite) {
     resetDUT();
@@ -175,7 +28,9 @@ TEST_F(PixelGeneratorTestbench, RegisterReadWrite) {
 TEST_F(PixelGeneratorTestbench, StartOfFrameSignal) {
     resetDUT();
     // Use default parameters
+    holdGenerator();
     axi_lite_write(0x00, 50); // Use a low max_iter to speed up simulation
+    releaseGenerator();
 
     // We only need to check the very first pixel
     top->out_stream_tready = 1;
@@ -197,7 +52,9 @@ TEST_F(PixelGeneratorTestbench, StartOfFrameSignal) {
 // Test 3: Verify that the TLAST (EOL) signal is asserted correctly at the end of a line.
 TEST_F(PixelGeneratorTestbench, EndOfLineSignal) {
     resetDUT();
+    holdGenerator();
     axi_lite_write(0x00, 50); // Low max_iter for speed
+    releaseGenerator();
     
     const int WIDTH = 640;
     // Capture just over one line of pixels
@@ -225,7 +82,9 @@ TEST_F(PixelGeneratorTestbench, FullFrameGeneration) {
     const int HEIGHT = 480;
 
     // Use default parameters (pan=0, zoom=1.0) and a low max_iter
+    holdGenerator();
     axi_lite_write(0x00, 30);
+    releaseGenerator();
     
     auto frame = read_frame(WIDTH, HEIGHT);
 
@@ -240,4 +99,52 @@ TEST_F(PixelGeneratorTestbench, FullFrameGeneration) {
     // Data format is {8'h00, r, g, b}
     int center_pixel_index = (HEIGHT / 2) * WIDTH + (WIDTH / 2);
     EXPECT_EQ(frame[center_pixel_index].data, 0x00000000) << "Center pixel was not black.";
-}
\ No newline at end of file
+
+    // The frame must have been rendered with max_iter = 30, not the reset value
+    int mismatches = 0;
+    for (int i = 0; i < WIDTH * HEIGHT; i++) {
+        mismatches += frame[i].data != mandelbrot_model::pixel(i % WIDTH, i / WIDTH, 0, 0, 0, 30);
+    }
+    EXPECT_EQ(mismatches, 0);
+}
+
+// Test 5: WIDTH/HEIGHT resize the frame at run time. Every supported mode
+// must frame its lines and frames correctly and centre the view.
+TEST_F(PixelGeneratorTestbench, FramingAtEveryResolution) {
+    const int modes[][2] = {{640, 480}, {1280, 720}, {1920, 1080}};
+    const uint32_t max_iter = 30;
+
+    for (const auto &mode : modes) {
+        const int width = mode[0];
+        const int height = mode[1];
+        SCOPED_TRACE(std::to_string(width) + "x" + std::to_string(height));
+
+        resetDUT();
+        holdGenerator();
+        axi_lite_write(0x00, max_iter);
+        axi_lite_write(0x48, width);
+        axi_lite_write(0x4C, height);
+        releaseGenerator();
+
+        EXPECT_EQ(axi_lite_read(0x48), static_cast<uint32_t>(width));
+        EXPECT_EQ(axi_lite_read(0x4C), static_cast<uint32_t>(height));
+
+        auto frame = read_frame(width, height);
+        ASSERT_EQ(frame.size(), static_cast<size_t>(width * height)) << "Did not receive the complete frame.";
+
+        for (int y = 0; y < height; y++) {
+            for (int x = 0; x < width; x++) {
+                const PixelData &p = frame[y * width + x];
+                ASSERT_EQ(p.user, x == 0 && y == 0) << "TUSER wrong at (" << x << ", " << y << ")";
+                ASSERT_EQ(p.last, x == width - 1) << "TLAST wrong at (" << x << ", " << y << ")";
+                ASSERT_EQ(p.data, mandelbrot_model::pixel(x, y, 0, 0, 0, max_iter, width, height))
+                    << "Pixel mismatch at (" << x << ", " << y << ")";
+            }
+        }
+
+        // The frame wraps after exactly width x height pixels
+        auto next = read_frame(1, 1);
+        ASSERT_EQ(next.size(), 1u);
+        EXPECT_TRUE(next[0].user) << "The next frame did not start after " << width * height << " pixels.";
+    }
+}
@@ -0,0 +1,337 @@
+#pragma once
+
+#include "base_testbench.h"
+#include "mandelbrot_model.h"
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <set>
+#include <unordered_map>
+#include <vector>
+
+// Helper struct to hold captured AXI-Stream pixel data
+struct PixelData {
+    uint32_t data; // tdata (contains RGB)
+    bool last;     // tlast (end of line)
+    bool user;     // tuser (start of frame)
+};
+
+class PixelGeneratorTestbench : public BaseTestbench {
+protected:
+    // DDR behind m_axi_ibuf: a zero-latency AXI4 slave, one word per address
+    struct Burst {
+        uint32_t addr;
+        int beats;
+    };
+    std::unordered_map<uint32_t, uint32_t> ddr;
+    std::deque<Burst> ddr_reads, ddr_writes;
+    int ddr_responses = 0;
+    bool ddr_ar, ddr_r, ddr_aw, ddr_w, ddr_b;
+
+    // Before the rising edge: note the handshakes it completes
+    void ddrSample() {
+        ddr_ar = top->m_axi_ibuf_arvalid && top->m_axi_ibuf_arready;
+        ddr_r  = top->m_axi_ibuf_rvalid && top->m_axi_ibuf_rready;
+        ddr_aw = top->m_axi_ibuf_awvalid && top->m_axi_ibuf_awready;
+        ddr_w  = top->m_axi_ibuf_wvalid && top->m_axi_ibuf_wready;
+        ddr_b  = top->m_axi_ibuf_bvalid && top->m_axi_ibuf_bready;
+        if (ddr_ar) {
+            ddr_reads.push_back({top->m_axi_ibuf_araddr, top->m_axi_ibuf_arlen + 1});
+        }
+        if (ddr_w) {
+            Burst &burst = ddr_writes.front();
+            ddr[burst.addr] = top->m_axi_ibuf_wdata;
+            EXPECT_EQ(static_cast<bool>(top->m_axi_ibuf_wlast), burst.beats == 1);
+        }
+        if (ddr_aw) {
+            ddr_writes.push_back({top->m_axi_ibuf_awaddr, top->m_axi_ibuf_awlen + 1});
+        }
+    }
+
+    // After the rising edge: retire the beats and drive the next ones
+    void ddrUpdate() {
+        if (ddr_r) {
+            Burst &burst = ddr_reads.front();
+            burst.addr += 4;
+            if (--burst.beats == 0) {
+                ddr_reads.pop_front();
+            }
+        }
+        if (ddr_w) {
+            Burst &burst = ddr_writes.front();
+            burst.addr += 4;
+            if (--burst.beats == 0) {
+                ddr_writes.pop_front();
+                ddr_responses++;
+            }
+        }
+        if (ddr_b) {
+            ddr_responses--;
+        }
+
+        top->m_axi_ibuf_awready = 1;
+        top->m_axi_ibuf_arready = 1;
+        top->m_axi_ibuf_wready = !ddr_writes.empty();
+        top->m_axi_ibuf_bvalid = ddr_responses > 0;
+        top->m_axi_ibuf_bresp = 0;
+        top->m_axi_ibuf_rvalid = !ddr_reads.empty();
+        top->m_axi_ibuf_rresp = 0;
+        if (!ddr_reads.empty()) {
+            top->m_axi_ibuf_rdata = ddr[ddr_reads.front().addr];
+            top->m_axi_ibuf_rlast = ddr_reads.front().beats == 1;
+        }
+    }
+
+    // The three clock domains, with their periods in picoseconds. They are
+    // equal by default, so every edge lines up; setClockPeriods() lets a
+    // test run them at independent ratios.
+    enum { CLK_AXI, CLK_COMPUTE, CLK_STREAM, CLK_COUNT };
+    uint64_t clk_period[CLK_COUNT] = {10000, 10000, 10000};
+    uint64_t clk_next[CLK_COUNT] = {5000, 5000, 5000};
+    uint64_t clk_rises[CLK_COUNT] = {0, 0, 0};
+    uint64_t sim_time = 0;
+
+    void setClockPeriods(uint64_t axi_ps, uint64_t compute_ps, uint64_t stream_ps) {
+        clk_period[CLK_AXI] = axi_ps;
+        clk_period[CLK_COMPUTE] = compute_ps;
+        clk_period[CLK_STREAM] = stream_ps;
+        for (int c = 0; c < CLK_COUNT; c++) {
+            clk_next[c] = sim_time + clk_period[c] / 2;
+        }
+    }
+
+    // Advances to the next clock edge, toggling every clock that has one
+    // then. The DDR model sits on the compute clock. Returns the clocks
+    // that rose, one bit each.
+    unsigned clockEdge() {
+        sim_time = std::min({clk_next[CLK_AXI], clk_next[CLK_COMPUTE], clk_next[CLK_STREAM]});
+        uint8_t *clk[CLK_COUNT] = {&top->s_axi_lite_aclk, &top->compute_aclk, &top->out_stream_aclk};
+        unsigned rose = 0;
+        for (int c = 0; c < CLK_COUNT; c++) {
+            if (clk_next[c] == sim_time && !*clk[c]) {
+                rose |= 1u << c;
+            }
+        }
+        if (rose & (1u << CLK_COMPUTE)) {
+            ddrSample();
+        }
+        for (int c = 0; c < CLK_COUNT; c++) {
+            if (clk_next[c] == sim_time) {
+                *clk[c] = !*clk[c];
+                clk_next[c] += clk_period[c] / 2;
+                clk_rises[c] += (rose >> c) & 1;
+            }
+        }
+        top->eval();
+        #ifndef __APPLE__
+        tfp->dump(sim_time);
+        #endif
+        if (rose & (1u << CLK_COMPUTE)) {
+            ddrUpdate();
+        }
+        if (rose & (1u << CLK_STREAM)) {
+            ticks++;
+        }
+        return rose;
+    }
+
+    // One out_stream_aclk cycle; ticks counts these
+    void clockCycle() {
+        while (!(clockEdge() & (1u << CLK_STREAM))) {
+        }
+    }
+
+    // One s_axi_lite_aclk cycle, for the AXI-Lite handshakes
+    void axiCycle() {
+        while (!(clockEdge() & (1u << CLK_AXI))) {
+        }
+    }
+
+    // Runs until every domain has seen the given number of rising edges,
+    // so a reset reaches all of them
+    void allDomainsCycle(int cycles) {
+        uint64_t target[CLK_COUNT];
+        for (int c = 0; c < CLK_COUNT; c++) {
+            target[c] = clk_rises[c] + cycles;
+        }
+        while (clk_rises[CLK_AXI] < target[CLK_AXI] || clk_rises[CLK_COMPUTE] < target[CLK_COMPUTE] ||
+               clk_rises[CLK_STREAM] < target[CLK_STREAM]) {
+            clockEdge();
+        }
+    }
+
+    // Set all inputs to a known, idle state
+    void initializeInputs() override {
+        // Active-low resets are asserted (0) initially
+        top->axi_resetn = 0;
+        top->periph_resetn = 0;
+
+        // AXI-Stream consumer is not ready initially
+        top->out_stream_tready = 0;
+
+        // AXI-Lite master interfaces are idle
+        top->s_axi_lite_arvalid = 0;
+        top->s_axi_lite_awvalid = 0;
+        top->s_axi_lite_wvalid = 0;
+        top->s_axi_lite_bready = 0;
+        top->s_axi_lite_rready = 0;
+
+        // DDR is empty and idle
+        ddr.clear();
+        ddr_reads.clear();
+        ddr_writes.clear();
+        ddr_responses = 0;
+        ddr_ar = ddr_r = ddr_aw = ddr_w = ddr_b = false;
+        ddrUpdate();
+    }
+
+    // Apply and release resets to bring DUT to an operational state
+    void resetDUT() {
+        initializeInputs();
+        top->axi_resetn = 0;
+        top->periph_resetn = 0;
+        allDomainsCycle(2);
+        top->axi_resetn = 1;
+        top->periph_resetn = 1;
+        clockCycle();
+        // The DUT is now out of reset and should start its internal FSM
+    }
+
+    // Hold only the pixel pipeline in reset so the register file can be
+    // programmed before the first pixel of a frame is dispatched.
+    void holdGenerator() {
+        top->periph_resetn = 0;
+        allDomainsCycle(2);
+    }
+
+    void releaseGenerator() {
+        top->periph_resetn = 1;
+        clockCycle();
+    }
+
+    // Helper function to perform a complete AXI-Lite write transaction
+    void axi_lite_write(uint32_t addr, uint32_t data) {
+        top->s_axi_lite_awaddr = addr;
+        top->s_axi_lite_awvalid = 1;
+        top->s_axi_lite_wdata = data;
+        top->s_axi_lite_wvalid = 1;
+
+        // Wait until the DUT is ready for both address and data
+        while (!(top->s_axi_lite_awready && top->s_axi_lite_wready)) {
+            axiCycle();
+        }
+
+        axiCycle();
+        top->s_axi_lite_awvalid = 0;
+        top->s_axi_lite_wvalid = 0;
+
+        // Wait for the write response
+        top->s_axi_lite_bready = 1;
+        while (!top->s_axi_lite_bvalid) {
+            axiCycle();
+        }
+        
+        // Expect a successful response (AXI_OK)
+        EXPECT_EQ(top->s_axi_lite_bresp, 0);
+        axiCycle();
+        top->s_axi_lite_bready = 0;
+    }
+
+    // Helper function to perform a complete AXI-Lite read transaction
+    uint32_t axi_lite_read(uint32_t addr) {
+        top->s_axi_lite_araddr = addr;
+        top->s_axi_lite_arvalid = 1;
+
+        while (!top->s_axi_lite_arready) {
+            axiCycle();
+        }
+
+        axiCycle();
+        top->s_axi_lite_arvalid = 0;
+
+        // Wait for the DUT to provide valid read data
+        top->s_axi_lite_rready = 1;
+        while (!top->s_axi_lite_rvalid) {
+            axiCycle();
+        }
+
+        uint32_t read_data = top->s_axi_lite_rdata;
+        EXPECT_EQ(top->s_axi_lite_rresp, 0); // Expect AXI_OK
+        axiCycle();
+        top->s_axi_lite_rready = 0;
+        
+        return read_data;
+    }
+
+    // Helper function to capture a stream of pixels.
+    // Includes a timeout to detect if the DUT stops producing pixels.
+    std::vector<PixelData> read_frame(int width, int height) {
+        std::vector<PixelData> pixels;
+        pixels.reserve(width * height);
+        
+        // Generous timeout: 50 cycles per pixel should be more than enough
+        // given that max_iter is usually ~100.
+        long timeout_cycles = (long)width * height * 50;
+
+        // Signal that the consumer is always ready to accept data
+        top->out_stream_tready = 1;
+
+        while (pixels.size() < width * height && timeout_cycles > 0) {
+            // AXI Stream handshake: transaction occurs when tvalid and tready are both high
+            if (top->out_stream_tvalid && top->out_stream_tready) {
+                PixelData p;
+                p.data = top->out_stream_tdata;
+                p.user = top->out_stream_tuser;
+                p.last = top->out_stream_tlast;
+                pixels.push_back(p);
+            }
+            clockCycle();
+            timeout_cycles--;
+        }
+
+        // If the timeout was hit, it's a critical failure.
+        EXPECT_GT(timeout_cycles, 0) << "Timeout! DUT stopped sending pixels. Received "
+                                     << pixels.size() << " of " << width * height << " pixels.";
+        
+        return pixels;
+    }
+
+    // Checks a frame of `width` beats per line in raster order against
+    // reference(x, y), the expected TDATA of beat x of line y, with TUSER on
+    // the first beat of the frame and TLAST on the last of every line.
+    // Returns how many distinct beats the frame holds, to catch flat frames.
+    template <typename Reference>
+    size_t expectFrame(const PixelData *frame, Reference reference, int width = mandelbrot_model::X_SIZE) {
+        int mismatches = 0;
+        std::set<uint32_t> values;
+        for (int y = 0; y < mandelbrot_model::Y_SIZE; y++) {
+            for (int x = 0; x < width; x++) {
+                const PixelData &p = frame[y * width + x];
+                uint32_t expected = reference(x, y);
+                if (p.data != expected && mismatches++ < 10) {
+                    ADD_FAILURE() << "Pixel (" << x << ", " << y << ") = 0x" << std::hex << p.data
+                                  << ", reference = 0x" << expected << std::dec;
+                }
+                EXPECT_EQ(p.user, x == 0 && y == 0) << "TUSER wrong at (" << x << ", " << y << ")";
+                EXPECT_EQ(p.last, x == width - 1) << "TLAST wrong at (" << x << ", " << y << ")";
+                values.insert(p.data);
+            }
+        }
+        EXPECT_EQ(mismatches, 0);
+        return values.size();
+    }
+
+    template <typename Reference>
+    size_t expectFrame(const std::vector<PixelData> &frame, Reference reference,
+                       int width = mandelbrot_model::X_SIZE) {
+        EXPECT_EQ(frame.size(), static_cast<size_t>(width * mandelbrot_model::Y_SIZE))
+            << "Did not receive the complete frame.";
+        if (frame.size() != static_cast<size_t>(width * mandelbrot_model::Y_SIZE)) return 0;
+        return expectFrame(frame.data(), reference, width);
+    }
+
+    // Reference for the default view, as the single-lane design renders it
+    static auto defaultView(uint32_t max_iter) {
+        return [max_iter](int x, int y) { return mandelbrot_model::pixel(x, y, 0, 0, 0, max_iter); };
+    }
+};
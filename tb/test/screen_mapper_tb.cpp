@@ -29,6 +29,8 @@ protected:
     void initializeInputs() override {
         top->x = 0;
         top->y = 0;
+        top->width = 640;
+        top->height = 480;
         top->pan_x = 0;
         top->pan_y = 0;
         top->zoom = 0;